@@ -214,14 +214,14 @@ SUPPORTED_INSTS = {
     "vmulhsu.vx" : {"pipe" : "vmul", "uop_gen" : "ELEMENTWISE", "latency" : 3},
 
 # Vector Integer Arithmetic Instructions: Vector Integer Divide Instructions
-    "vdiv.vv"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vdiv.vx"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vdivu.vv" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vdivu.vx" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vremu.vv" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vremu.vx" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vrem.vv"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
-    "vrem.vx"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23},
+    "vdiv.vv"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vdiv.vx"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vdivu.vv" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vdivu.vx" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vremu.vv" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vremu.vx" : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vrem.vv"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
+    "vrem.vx"  : {"pipe" : "vdiv", "uop_gen" : "ELEMENTWISE", "latency" : 23, "occupancy" : 23},
 
 # Vector Integer Arithmetic Instructions: Vector Widening Integer Multiply Instructions
     "vwmul.vv"   : {"pipe" : "vmul", "uop_gen" : "WIDENING", "latency" : 3},
@@ -323,9 +323,9 @@ SUPPORTED_INSTS = {
 # Vector Floating-Point Instructions: Vector Single-Width Floating-Point Multiply/Divide Instructions
     "vfmul.vv" : {"pipe" : "vfmul", "uop_gen" : "ELEMENTWISE", "latency" : 6},
     "vfmul.vf" : {"pipe" : "vfmul", "uop_gen" : "ELEMENTWISE", "latency" : 6},
-    "vfdiv.vv" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25},
-    "vfdiv.vf" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25},
-    "vfrdiv.vf" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25},
+    "vfdiv.vv" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25, "occupancy" : 25},
+    "vfdiv.vf" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25, "occupancy" : 25},
+    "vfrdiv.vf" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25, "occupancy" : 25},
 
 # Vector Floating-Point Instructions: Vector Widening Floating-Point Multiply
     "vfwmul.vv" : {"pipe" : "vfmul", "uop_gen" : "WIDENING", "latency" : 3},
@@ -360,7 +360,7 @@ SUPPORTED_INSTS = {
     "vfwnmsac.vf" : {"pipe" : "vfmul", "uop_gen" : "WIDENING", "latency" : 6},
 
 # Vector Floating-Point Instructions: Vector Floating-Point Square-Root Instruction
-    "vfsqrt.v" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25},
+    "vfsqrt.v" : {"pipe" : "vfdiv", "uop_gen" : "ELEMENTWISE", "latency" : 25, "occupancy" : 25},
 
 # TODO: support variable length latency
 # Vector Floating-Point Instructions: Vector Floating-Point Reciprocal Square-Root Estimate Instruction
@@ -487,12 +487,12 @@ SUPPORTED_INSTS = {
     "vid.v" : {"pipe" : "vmask", "uop_gen" : "ELEMENTWISE", "latency" : 1},
 
 # Vector Permutation Instructions: Integer Scalar Move Instructions
-    "vmv.x.s" : {"pipe" : "v2s", "uop_gen" : "NONE", "latency" : 1},
-    "vmv.s.x" : {"pipe" : "vmv", "uop_gen" : "NONE", "latency" : 1},
+    "vmv.x.s" : {"pipe" : "v2s", "uop_gen" : "NONE", "latency" : 1, "occupancy_scaling" : "none"},
+    "vmv.s.x" : {"pipe" : "vmv", "uop_gen" : "NONE", "latency" : 1, "occupancy_scaling" : "none"},
 
 # Vector Permutation Instructions: Floating-Point Scalar Move Instructions
-    "vfmv.f.s" : {"pipe" : "v2s", "uop_gen" : "NONE", "latency" : 1},
-    "vfmv.s.f" : {"pipe" : "vmv", "uop_gen" : "NONE", "latency" : 1},
+    "vfmv.f.s" : {"pipe" : "v2s", "uop_gen" : "NONE", "latency" : 1, "occupancy_scaling" : "none"},
+    "vfmv.s.f" : {"pipe" : "vmv", "uop_gen" : "NONE", "latency" : 1, "occupancy_scaling" : "none"},
 
 # Vector Permutation Instructions: Vector Slide Instructions
     "vslideup.vx"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE",    "latency" : 6},
@@ -505,13 +505,13 @@ SUPPORTED_INSTS = {
     "vfslide1down.vf": {"pipe" : "vfloat",   "uop_gen" : "SLIDE1DOWN", "latency" : 1},
 
 # Vector Permutation Instructions: Vector Register Gather Instructions
-    "vrgather.vv"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6},
-    "vrgatherei16.vv": {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6},
-    "vrgather.vx"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6},
-    "vrgather.vi"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6},
+    "vrgather.vv"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6, "occupancy_scaling" : "lmul"},
+    "vrgatherei16.vv": {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6, "occupancy_scaling" : "lmul"},
+    "vrgather.vx"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6, "occupancy_scaling" : "lmul"},
+    "vrgather.vi"    : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6, "occupancy_scaling" : "lmul"},
 
 # Vector Permutation Instructions: Vector Compress Instruction
-    "vcompress.vm" : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6},
+    "vcompress.vm" : {"pipe" : "vpermute", "uop_gen" : "PERMUTE", "latency" : 6, "occupancy_scaling" : "lmul"},
 
 # Vector Permutation Instructions: Whole Vector Register Move
     "vmv1r.v" : {"pipe" : "vmv", "uop_gen" : "ELEMENTWISE", "latency" : 1},
@@ -551,6 +551,10 @@ for opcode in mavis_rv64v_json:
             opcode_entry["uop_gen"] = SUPPORTED_INSTS[mnemonic]["uop_gen"]
         opcode_entry["pipe"] = SUPPORTED_INSTS[mnemonic]["pipe"]
         opcode_entry["latency"] = SUPPORTED_INSTS[mnemonic]["latency"]
+        # Optional issue occupancy (default 1 cycle per element group)
+        for key in ["occupancy", "occupancy_scaling"]:
+            if key in SUPPORTED_INSTS[mnemonic]:
+                opcode_entry[key] = SUPPORTED_INSTS[mnemonic][key]
 
     uarch_json.append(opcode_entry)
 
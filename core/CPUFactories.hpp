@@ -9,10 +9,14 @@
 #include "fetch/Fetch.hpp"
 #include "decode/Decode.hpp"
 #include "vector/VectorUopGenerator.hpp"
+#include "decode/UopCache.hpp"
+#include "decode/LoopBuffer.hpp"
+#include "decode/VsetPredictor.hpp"
 #include "rename/Rename.hpp"
 #include "dispatch/Dispatch.hpp"
 #include "execute/Execute.hpp"
 #include "lsu/LSU.hpp"
+#include "lsu/VLSU.hpp"
 #include "MMU.hpp"
 #include "SimpleTLB.hpp"
 #include "BIU.hpp"
@@ -57,6 +61,18 @@ namespace olympia{
         sparta::ResourceFactory<olympia::VectorUopGenerator,
                                 olympia::VectorUopGenerator::VectorUopGeneratorParameterSet> vec_uop_gen_rf;
 
+        //! \brief Resource Factory to build a UopCache
+        sparta::ResourceFactory<olympia::UopCache,
+                                olympia::UopCache::UopCacheParameterSet> uop_cache_rf;
+
+        //! \brief Resource Factory to build a LoopBuffer
+        sparta::ResourceFactory<olympia::LoopBuffer,
+                                olympia::LoopBuffer::LoopBufferParameterSet> loop_buffer_rf;
+
+        //! \brief Resource Factory to build a VsetPredictor
+        sparta::ResourceFactory<olympia::VsetPredictor,
+                                olympia::VsetPredictor::VsetPredictorParameterSet> vset_predictor_rf;
+
         //! \brief Resource Factory to build a Rename Unit
         RenameFactory rename_rf;
 
@@ -82,6 +98,10 @@ namespace olympia{
         sparta::ResourceFactory<olympia::LSU,
                                 olympia::LSU::LSUParameterSet> lsu_rf;
 
+        //! \brief Resource Factory to build a VLSU Unit
+        sparta::ResourceFactory<olympia::VLSU,
+                                olympia::VLSU::VLSUParameterSet> vlsu_rf;
+
         //! \brief Resouce Factory to build a L2Cache Unit
         sparta::ResourceFactory<olympia_mss::L2Cache,
                                 olympia_mss::L2Cache::L2CacheParameterSet> l2cache_rf;
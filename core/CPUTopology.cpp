@@ -59,6 +59,30 @@ olympia::CoreTopologySimple::CoreTopologySimple(){
             sparta::TreeNode::GROUP_IDX_NONE,
             &factories->vec_uop_gen_rf
         },
+        {
+            "uop_cache",
+            "cpu.core*.decode",
+            "Decoded Uop Cache",
+            sparta::TreeNode::GROUP_NAME_NONE,
+            sparta::TreeNode::GROUP_IDX_NONE,
+            &factories->uop_cache_rf
+        },
+        {
+            "loop_buffer",
+            "cpu.core*.decode",
+            "Loop Stream Buffer",
+            sparta::TreeNode::GROUP_NAME_NONE,
+            sparta::TreeNode::GROUP_IDX_NONE,
+            &factories->loop_buffer_rf
+        },
+        {
+            "vset_predictor",
+            "cpu.core*.decode",
+            "Vector Configuration Predictor",
+            sparta::TreeNode::GROUP_NAME_NONE,
+            sparta::TreeNode::GROUP_IDX_NONE,
+            &factories->vset_predictor_rf
+        },
         {
             "rename",
             "cpu.core*",
@@ -116,6 +140,14 @@ olympia::CoreTopologySimple::CoreTopologySimple(){
             sparta::TreeNode::GROUP_IDX_NONE,
             &factories->lsu_rf
         },
+        {
+            "vlsu",
+            "cpu.core*",
+            "Vector Load-Store Unit",
+            sparta::TreeNode::GROUP_NAME_NONE,
+            sparta::TreeNode::GROUP_IDX_NONE,
+            &factories->vlsu_rf
+        },
         {
             "l2cache",
             "cpu.core*",
@@ -236,6 +268,26 @@ olympia::CoreTopologySimple::CoreTopologySimple(){
             "cpu.core*.dcache.ports.out_lsu_free_req",
             "cpu.core*.lsu.ports.in_cache_free_req"
         },
+        {
+            "cpu.core*.dispatch.ports.out_vlsu_write",
+            "cpu.core*.vlsu.ports.in_vlsu_insts"
+        },
+        {
+            "cpu.core*.dispatch.ports.in_vlsu_credits",
+            "cpu.core*.vlsu.ports.out_vlsu_credits"
+        },
+        {
+            "cpu.core*.vlsu.ports.out_cache_lookup_req",
+            "cpu.core*.dcache.ports.in_vlsu_lookup_req"
+        },
+        {
+            "cpu.core*.dcache.ports.out_vlsu_lookup_ack",
+            "cpu.core*.vlsu.ports.in_cache_lookup_ack"
+        },
+        {
+            "cpu.core*.dcache.ports.out_vlsu_free_req",
+            "cpu.core*.vlsu.ports.in_cache_free_req"
+        },
         {
             "cpu.core*.dcache.ports.out_l2cache_req",
             "cpu.core*.l2cache.ports.in_dcache_l2cache_req"
@@ -332,6 +384,10 @@ olympia::CoreTopologySimple::CoreTopologySimple(){
             "cpu.core*.flushmanager.ports.out_flush_upper",
             "cpu.core*.lsu.ports.in_reorder_flush"
         },
+        {
+            "cpu.core*.flushmanager.ports.out_flush_upper",
+            "cpu.core*.vlsu.ports.in_reorder_flush"
+        },
         {
             "cpu.core*.flushmanager.ports.out_flush_upper",
             "cpu.core*.fetch.ports.in_fetch_flush_redirect"
@@ -410,6 +466,12 @@ void olympia::CoreTopologySimple::bindTree(sparta::RootTreeNode* root_node)
             const std::string disp_inst_out = dispatch_ports + ".out_" + unit_name + "_write";
             bind_ports(exe_inst_in, disp_inst_out);
 
+            // Speculative wakeup of the consumers of loads
+            const std::string lsu_ports = core_node + ".lsu.ports";
+            const std::string iq_ports = core_node + ".execute." + unit_name + ".ports";
+            bind_ports(lsu_ports + ".out_load_spec_wakeup", iq_ports + ".in_load_spec_wakeup");
+            bind_ports(lsu_ports + ".out_load_spec_cancel", iq_ports + ".in_load_spec_cancel");
+
             // in_execute_pipe
             const std::string exe_pipe_in =
                 core_node + ".execute." + unit_name + ".ports.in_execute_pipe";
@@ -101,6 +101,12 @@ namespace olympia
         is_vector_(opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::VECTOR)),
         is_vector_whole_reg_(
             is_vector_ && opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::WHOLE)),
+        is_vector_strided_(
+            is_vector_ && opcode_info->isInstType(mavis::OpcodeInfo::InstructionTypes::STRIDE)),
+        is_vector_indexed_(is_vector_
+                           && opcode_info->isInstTypeAnyOf(
+                               mavis::OpcodeInfo::InstructionTypes::ORDERED_INDEXED,
+                               mavis::OpcodeInfo::InstructionTypes::UNORDERED_INDEXED)),
         status_state_(Status::BEFORE_FETCH)
     {
         sparta_assert(inst_arch_info_ != nullptr,
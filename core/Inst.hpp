@@ -22,9 +22,11 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <ostream>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 #include <sstream>
 
 namespace olympia
@@ -157,6 +159,10 @@ namespace olympia
 
         bool isBlockingVSET() const { return is_blocking_vset_; }
 
+        void setPredictedVSET(bool is_predicted_vset) { is_predicted_vset_ = is_predicted_vset; }
+
+        bool isPredictedVSET() const { return is_predicted_vset_; }
+
         // Set the instruction's Program ID.  This ID is specific to
         // an instruction's retire pointer.  The same instruction in a
         // trace will have the same program ID (as compared to
@@ -167,10 +173,9 @@ namespace olympia
 
         // A fused operation will modify the program_id_increment_ based on
         // the number of instructions fused. A-B-C-D -> fA  incr becomes 4
-        // This is planned, but not currently used.
+        // The ROB retires the fused op as incr instructions.
         void setProgramIDIncrement(uint64_t incr) { program_id_increment_ = incr; }
 
-        // This is planned, but not currently used.
         uint64_t getProgramIDIncrement() const { return program_id_increment_; }
 
         // Set the instruction's PC
@@ -183,6 +188,14 @@ namespace olympia
 
         sparta::memory::addr_t getTargetVAddr() const { return target_vaddr_; }
 
+        // Per-element addresses of a vector load/store, when the trace
+        // provides them.  Shared by the uops of the instruction.
+        using VAddrVectorPtr = std::shared_ptr<const std::vector<sparta::memory::addr_t>>;
+
+        void setVAddrVector(const VAddrVectorPtr & vaddrs) { vaddrs_ = vaddrs; }
+
+        const VAddrVectorPtr & getVAddrVector() const { return vaddrs_; }
+
         void setVectorConfig(const VectorConfigPtr input_vector_config)
         {
             vector_config_ = input_vector_config;
@@ -216,6 +229,16 @@ namespace olympia
 
         bool isLastInFetchBlock() const { return last_in_fetch_block_; }
 
+        // Instruction was delivered by the uop cache, bypassing the ICache and decoders
+        void setUopCacheHit(bool hit) { uop_cache_hit_ = hit; }
+
+        bool isUopCacheHit() const { return uop_cache_hit_; }
+
+        // Instruction was replayed by the loop buffer, bypassing the ICache and decoders
+        void setLoopBufferReplay(bool replay) { loop_buffer_replay_ = replay; }
+
+        bool isLoopBufferReplay() const { return loop_buffer_replay_; }
+
         // ROB target information
         void setTargetROB(bool tgt = true) { rob_targeted_ = tgt; }
 
@@ -231,6 +254,18 @@ namespace olympia
 
         uint32_t getOpCode() const { return static_cast<uint32_t>(opcode_info_->getOpcode()); }
 
+        // RVC instructions are the encodings whose 2 LSBs are not 0b11.
+        // Instructions built from a mnemonic (JSON traces) have no
+        // encoding and are treated as 32-bit instructions.
+        bool isCompressed() const
+        {
+            const uint32_t opcode = getOpCode();
+            return (opcode != 0) && ((opcode & 0x3) != 0x3);
+        }
+
+        // Size of the instruction encoding in bytes
+        uint32_t getInstSize() const { return isCompressed() ? 2 : 4; }
+
         // Get the data size in bytes
         uint32_t getMemAccessSize() const { return static_cast<uint32_t>(opcode_info_->getDataSize() / 8); }  // opcode_info's data size is in bits
 
@@ -363,6 +398,18 @@ namespace olympia
 
         InstArchInfo::UopGenType getUopGenType() const { return inst_arch_info_->getUopGenType(); }
 
+        uint32_t getOccupancy() const { return inst_arch_info_->getOccupancy(); }
+
+        InstArchInfo::OccupancyScaling getOccupancyScaling() const
+        {
+            return inst_arch_info_->getOccupancyScaling();
+        }
+
+        InstArchInfo::DivOperands getDivOperands() const
+        {
+            return inst_arch_info_->getDivOperands();
+        }
+
         uint64_t getRAdr() const { return target_vaddr_ | 0x8000000; } // faked
 
         bool isSpeculative() const { return is_speculative_; }
@@ -389,6 +436,11 @@ namespace olympia
 
         bool isVectorWholeRegister() const { return is_vector_whole_reg_; }
 
+        // Vector memory access addressing, unit stride when neither
+        bool isVectorStrided() const { return is_vector_strided_; }
+
+        bool isVectorIndexed() const { return is_vector_indexed_; }
+
         void setCoF(const bool & cof) { is_cof_ = cof; }
 
         bool isCoF() const { return is_cof_; }
@@ -401,6 +453,29 @@ namespace olympia
         // This instruction is fed by a load
         void setLoadProducer(bool load_producer) { has_load_producer_ = load_producer; }
 
+        // Number of source PRFs the instruction waits on in the issue queue
+        void setNumPendingSources(uint32_t num_pending_srcs) { num_pending_srcs_ = num_pending_srcs; }
+
+        uint32_t getNumPendingSources() const { return num_pending_srcs_; }
+
+        // Source operand values from the trace (divides and square roots),
+        // for operand dependent latencies
+        void setSourceValues(std::vector<uint64_t> && values) { src_values_ = std::move(values); }
+
+        const std::vector<uint64_t> & getSourceValues() const { return src_values_; }
+
+        // Issued on a speculative load wakeup, the load hit is not confirmed yet
+        void setSpeculativelyIssued(bool spec_issued) { spec_issued_ = spec_issued; }
+
+        bool isSpeculativelyIssued() const { return spec_issued_; }
+
+        // A source PRF is ready, returns the number of sources still pending
+        uint32_t wakeupSource()
+        {
+            sparta_assert(num_pending_srcs_ > 0, "Woke up an instruction with no pending sources");
+            return --num_pending_srcs_;
+        }
+
         // Rename information
         core_types::RegisterBitMask & getSrcRegisterBitMask(const core_types::RegFile rf)
         {
@@ -485,6 +560,7 @@ namespace olympia
         sparta::memory::addr_t inst_pc_ = 0; // Instruction's PC
         sparta::memory::addr_t target_vaddr_ =
             0; // Instruction's Target PC (for branches, loads/stores)
+        VAddrVectorPtr vaddrs_; // Element addresses (vector loads/stores)
         bool is_oldest_ = false;
         uint64_t unique_id_ = 0;  // Supplied by Fetch
         uint64_t program_id_ = 0; // Supplied by a trace Reader or execution backend
@@ -508,10 +584,15 @@ namespace olympia
         bool rob_targeted_ = false;
 
         bool has_load_producer_ = false;
+        uint32_t num_pending_srcs_ = 0;
+        bool spec_issued_ = false;
+        std::vector<uint64_t> src_values_;
 
         // Vector
         const bool is_vector_;
         const bool is_vector_whole_reg_;
+        const bool is_vector_strided_;
+        const bool is_vector_indexed_;
 
         VectorConfigPtr vector_config_{new VectorConfig};
         bool has_tail_ = false; // Does this vector uop have a tail?
@@ -520,12 +601,18 @@ namespace olympia
         // can't be resolved until after execution, so we need to block on it due to UOp fracturing
         bool is_blocking_vset_ = false;
 
+        // predicted vset is a blocking vset whose configuration was predicted, decode did not
+        // block on it
+        bool is_predicted_vset_ = false;
+
         sparta::SpartaWeakPointer<olympia::Inst> parent_uop_;
 
         // Did this instruction mispredict?
         bool is_mispredicted_ = false;
         bool is_taken_branch_ = false;
         bool last_in_fetch_block_ = false; // This is the last instruction in the fetch block
+        bool uop_cache_hit_ = false;       // Delivered by the uop cache
+        bool loop_buffer_replay_ = false;  // Replayed by the loop buffer
         sparta::Scheduleable* ev_retire_ = nullptr;
         Status status_state_;
         Status extended_status_state_{Inst::Status::UNMOD};
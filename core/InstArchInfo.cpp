@@ -82,6 +82,21 @@ namespace olympia
         {"PERMUTE", InstArchInfo::UopGenType::PERMUTE},
         {"NONE", InstArchInfo::UopGenType::NONE}};
 
+    const InstArchInfo::OccupancyScalingMap InstArchInfo::occupancy_scaling_map = {
+        {"element_groups", InstArchInfo::OccupancyScaling::ELEMENT_GROUPS},
+        {"lmul", InstArchInfo::OccupancyScaling::LMUL},
+        {"none", InstArchInfo::OccupancyScaling::NONE}};
+
+    const InstArchInfo::DivOperandsMap InstArchInfo::div_operands_map = {
+        {"int32", InstArchInfo::DivOperands::INT32},
+        {"uint32", InstArchInfo::DivOperands::UINT32},
+        {"int64", InstArchInfo::DivOperands::INT64},
+        {"uint64", InstArchInfo::DivOperands::UINT64},
+        {"fp16", InstArchInfo::DivOperands::FP16},
+        {"fp32", InstArchInfo::DivOperands::FP32},
+        {"fp64", InstArchInfo::DivOperands::FP64},
+        {"fp128", InstArchInfo::DivOperands::FP128}};
+
     void InstArchInfo::update(const boost::json::object & jobj)
     {
         if (const auto it = jobj.find("pipe"); it != jobj.end())
@@ -109,6 +124,35 @@ namespace olympia
             uop_gen_ = itr->second;
         }
 
+        // Cycles the instruction (each vector element group) occupies the
+        // unit (1 if fully pipelined), and how the number of element groups scales
+        if (const auto it = jobj.find("occupancy"); it != jobj.end())
+        {
+            occupancy_ = boost::json::value_to<uint32_t>(it->value());
+            sparta_assert(occupancy_ > 0, "Occupancy must be at least 1 for inst: "
+                                              << jobj.at("mnemonic").as_string());
+        }
+
+        if (const auto it = jobj.find("occupancy_scaling"); it != jobj.end())
+        {
+            auto scaling_name = it->value().as_string();
+            const auto itr = occupancy_scaling_map.find(scaling_name);
+            sparta_assert(itr != occupancy_scaling_map.end(),
+                          "Unknown occupancy scaling: " << scaling_name << " for inst: "
+                                                        << jobj.at("mnemonic").as_string());
+            occupancy_scaling_ = itr->second;
+        }
+
+        if (const auto it = jobj.find("div_operands"); it != jobj.end())
+        {
+            auto operands_name = it->value().as_string();
+            const auto itr = div_operands_map.find(operands_name);
+            sparta_assert(itr != div_operands_map.end(),
+                          "Unknown divide operands: " << operands_name << " for inst: "
+                                                      << jobj.at("mnemonic").as_string());
+            div_operands_ = itr->second;
+        }
+
         is_load_store_ = (tgt_pipe_ == TargetPipe::LSU);
         is_vset_ = {tgt_pipe_ == TargetPipe::VSET};
     }
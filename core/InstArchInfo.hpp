@@ -103,6 +103,36 @@ namespace olympia
         using UopGenMap = std::map<std::string, UopGenType, mavis::JSONStringMapCompare>;
         static const UopGenMap uop_gen_type_map;
 
+        // How the occupancy of a vector uop scales with its configuration
+        enum class OccupancyScaling
+        {
+            ELEMENT_GROUPS, // once per DLEN wide group of elements (e.g. vadd, vfdiv)
+            LMUL,           // once per element group per source register (e.g. vrgather)
+            NONE            // once per uop (e.g. scalar moves)
+        };
+
+        using OccupancyScalingMap =
+            std::map<std::string, OccupancyScaling, mavis::JSONStringMapCompare>;
+        static const OccupancyScalingMap occupancy_scaling_map;
+
+        // Operand format of a divide or square root, used by the operand
+        // dependent (early out) latency model
+        enum class DivOperands
+        {
+            INT32,
+            UINT32,
+            INT64,
+            UINT64,
+            FP16,
+            FP32,
+            FP64,
+            FP128,
+            NONE
+        };
+
+        using DivOperandsMap = std::map<std::string, DivOperands, mavis::JSONStringMapCompare>;
+        static const DivOperandsMap div_operands_map;
+
         // Called by Mavis during its initialization
         explicit InstArchInfo(const boost::json::object & jobj) { update(jobj); }
 
@@ -119,6 +149,16 @@ namespace olympia
         //! Return the vector uop generator type
         UopGenType getUopGenType() const { return uop_gen_; }
 
+        //! Return the number of cycles the instruction (a vector element
+        //! group) occupies the execution unit: its initiation interval
+        uint32_t getOccupancy() const { return occupancy_; }
+
+        //! Return how the occupancy of a vector uop scales
+        OccupancyScaling getOccupancyScaling() const { return occupancy_scaling_; }
+
+        //! Return the operand format of a divide or square root
+        DivOperands getDivOperands() const { return div_operands_; }
+
         //! Is this instruction a load/store type?
         bool isLoadStore() const { return is_load_store_; }
 
@@ -129,6 +169,9 @@ namespace olympia
         TargetPipe tgt_pipe_ = TargetPipe::UNKNOWN;
         uint32_t execute_time_ = 0;
         UopGenType uop_gen_ = UopGenType::UNKNOWN;
+        uint32_t occupancy_ = 1;
+        OccupancyScaling occupancy_scaling_ = OccupancyScaling::ELEMENT_GROUPS;
+        DivOperands div_operands_ = DivOperands::NONE;
         bool is_load_store_ = false;
         bool is_vset_ = false;
     };
@@ -73,10 +73,11 @@ namespace olympia
              << " uid:" << inst_ptr->getUniqueID() << " index:" << curr_inst_index_
              << (skip ? " (skipping to next)" : " (inclusive)"));
 
+        // A fused instruction also skips the instructions it absorbed
         if (skip)
         {
-            ++curr_inst_index_;
-            ++program_id_;
+            curr_inst_index_ += inst_ptr->getProgramIDIncrement();
+            program_id_ += inst_ptr->getProgramIDIncrement();
         }
     }
 
@@ -155,6 +156,18 @@ namespace olympia
                 inst->setTargetVAddr(vaddr);
             }
 
+            if (const auto it = jinst.find("vaddrs"); it != jinst.end())
+            {
+                // Element addresses of a strided/indexed vector load/store
+                std::vector<sparta::memory::addr_t> vaddrs;
+                for (const auto & vaddr : it->value().as_array())
+                {
+                    vaddrs.emplace_back(std::strtoull(vaddr.as_string().c_str(), nullptr, 0));
+                }
+                inst->setVAddrVector(
+                    std::make_shared<const std::vector<sparta::memory::addr_t>>(std::move(vaddrs)));
+            }
+
             VectorConfigPtr vector_config = inst->getVectorConfig();
             if (const auto it = jinst.find("vtype"); it != jinst.end())
             {
@@ -180,11 +193,43 @@ namespace olympia
                 vector_config->setVL(vl);
             }
 
+            if (const auto it = jinst.find("pc"); it != jinst.end())
+            {
+                inst->setPC(std::strtoull(it->value().as_string().c_str(), nullptr, 0));
+            }
+
             if (const auto it = jinst.find("taken"); it != jinst.end())
             {
                 const bool taken = boost::json::value_to<uint64_t>(it->value());
                 inst->setTakenBranch(taken);
             }
+
+            // Branches resolved as mispredicted, they flush when retiring
+            if (const auto it = jinst.find("mispredicted"); it != jinst.end())
+            {
+                if (boost::json::value_to<uint64_t>(it->value()) != 0)
+                {
+                    inst->setMispredicted();
+                }
+            }
+
+            // Source operand values, used by the operand dependent divide
+            // latency.  Either a number or a (hex) string
+            std::vector<uint64_t> src_values;
+            for (const char* key : {"rs1_value", "fs1_value", "rs2_value", "fs2_value"})
+            {
+                if (const auto it = jinst.find(key); it != jinst.end())
+                {
+                    src_values.emplace_back(
+                        it->value().is_string()
+                            ? std::strtoull(it->value().as_string().c_str(), nullptr, 0)
+                            : boost::json::value_to<uint64_t>(it->value()));
+                }
+            }
+            if (!src_values.empty())
+            {
+                inst->setSourceValues(std::move(src_values));
+            }
         }
 
         inst->setRewindIterator<uint64_t>(curr_inst_index_);
@@ -251,10 +296,14 @@ namespace olympia
              << " uid:" << inst_ptr->getUniqueID()
              << (skip ? " (skipping to next)" : " (inclusive)"));
 
+        // A fused instruction also skips the instructions it absorbed
         if (skip)
         {
-            ++next_it_;
-            ++program_id_;
+            for (uint64_t i = 0; i < inst_ptr->getProgramIDIncrement(); ++i)
+            {
+                ++next_it_;
+            }
+            program_id_ += inst_ptr->getProgramIDIncrement();
         }
     }
 
@@ -282,10 +331,24 @@ namespace olympia
                               next_it_->getMemoryAccesses().end(),
                               [&addrs](const auto & ma) { addrs.emplace_back(ma.getAddress()); });
                 inst->setTargetVAddr(addrs.front());
-                // For misaligns, more than 1 address is provided
-                // inst->setVAddrVector(std::move(addrs));
+                // Vector loads/stores provide an address per element (misaligns
+                // provide more than 1 address too)
+                if (addrs.size() > 1)
+                {
+                    inst->setVAddrVector(std::make_shared<const VectorAddrType>(std::move(addrs)));
+                }
             }
             inst->setCoF(next_it_->isCoF());
+            // The divide latency can depend on the operand values
+            if (inst->getPipe() == InstArchInfo::TargetPipe::DIV)
+            {
+                std::vector<uint64_t> src_values;
+                for (const auto & src : next_it_->getSourceOperands())
+                {
+                    src_values.emplace_back(src.getScalarValue());
+                }
+                inst->setSourceValues(std::move(src_values));
+            }
             if (next_it_->isBranch())
             {
                 inst->setTakenBranch(next_it_->isTakenBranch());
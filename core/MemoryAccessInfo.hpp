@@ -102,6 +102,22 @@ namespace olympia
         {
         }
 
+        // Access to a single address (e.g. a cache line) on behalf of an
+        // instruction, used by the VLSU for each line of a vector access
+        MemoryAccessInfo(const InstPtr & inst_ptr, const uint64_t phy_addr) :
+            ldst_inst_ptr_(inst_ptr),
+            phy_addr_ready_(true),
+            mmu_access_state_(MMUState::HIT),
+            cache_access_state_(CacheState::NO_ACCESS),
+            cache_data_ready_(false),
+            is_refill_(false),
+            src_(ArchUnit::NO_ACCESS),
+            dest_(ArchUnit::NO_ACCESS),
+            vaddr_(phy_addr),
+            paddr_(phy_addr)
+        {
+        }
+
         virtual ~MemoryAccessInfo() {}
 
         // This Inst pointer will act as our portal to the Inst class
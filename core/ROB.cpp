@@ -139,16 +139,21 @@ namespace olympia
             {
                 // UPDATE:
                 ex_inst.setStatus(Inst::Status::RETIRED);
-                if (ex_inst.isStoreInst())
+                // Vector stores are completed by the VLSU, only scalar stores
+                // wait for retirement in the LSU store buffer
+                if (ex_inst.isStoreInst() && !ex_inst.isVector())
                 {
                     out_rob_retire_ack_.send(ex_inst_ptr);
                 }
 
-                // All instructions count as 1 uop
+                // All instructions count as 1 uop, a fused op retires all
+                // the instructions of its group
                 ++num_uops_retired_;
+                uint64_t num_insts_retired = 0;
                 if (ex_inst_ptr->getUOpID() == 0)
                 {
-                    ++num_retired_;
+                    num_insts_retired = ex_inst.getProgramIDIncrement();
+                    num_retired_ += num_insts_retired;
                     ++retired_this_cycle;
 
                     // Use the program ID to verify that the program order has been maintained.
@@ -174,7 +179,9 @@ namespace olympia
 
                 retired_insts->emplace_back(ex_inst_ptr);
 
-                if (SPARTA_EXPECT_FALSE((num_retired_ % retire_heartbeat_) == 0))
+                if (SPARTA_EXPECT_FALSE((num_insts_retired != 0)
+                                        && ((num_retired_ % retire_heartbeat_)
+                                            < num_insts_retired)))
                 {
                     std::cout << "olympia: Retired " << num_retired_.get() << " instructions in "
                               << getClock()->currentCycle()
@@ -183,7 +190,8 @@ namespace olympia
                     period_ipc_si_.start();
                 }
                 // Will be true if the user provides a -i option
-                if (SPARTA_EXPECT_FALSE((num_retired_ == num_insts_to_retire_)))
+                if (SPARTA_EXPECT_FALSE((num_insts_to_retire_ != 0)
+                                        && (num_retired_ >= num_insts_to_retire_)))
                 {
                     rob_stopped_simulation_ = true;
                     rob_stopped_notif_source_->postNotification(true);
@@ -198,6 +206,7 @@ namespace olympia
                                                             ex_inst_ptr);
                     out_retire_flush_.send(criteria);
                     expect_flush_ = true;
+                    ++num_flushes_;
                     break;
                 }
 
@@ -1,13 +1,18 @@
 // <Decode.cpp> -*- C++ -*-
 
 #include "decode/Decode.hpp"
+#include "decode/UopCache.hpp"
+#include "decode/LoopBuffer.hpp"
+#include "decode/VsetPredictor.hpp"
 #include "vector/VectorUopGenerator.hpp"
 #include "fsl_api/FusionTypes.h"
 
 #include "sparta/events/StartupEvent.hpp"
 #include "sparta/statistics/Counter.hpp"
 #include "sparta/utils/LogUtils.hpp"
+#include "sparta/utils/MathUtils.hpp"
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 
 using namespace std;
@@ -39,24 +44,68 @@ namespace olympia
                                   "Optimistic prediction of the cycles saved by fusion",
                                   sparta::Counter::COUNT_NORMAL),
 
+        fusion_match_groups_(&unit_stat_set_, "fusion_match_groups",
+                             "Number of decode groups examined by the fusion matcher",
+                             sparta::Counter::COUNT_NORMAL),
+
+        fusion_matches_(&unit_stat_set_, "fusion_matches",
+                        "Number of fusion group matches found",
+                        sparta::Counter::COUNT_NORMAL),
+
+        fusion_matches_per_group_(&unit_stat_set_, "fusion_matches_per_group",
+                                  "Average fusion group matches per decode group",
+                                  &unit_stat_set_, "fusion_matches/fusion_match_groups"),
+
+        decode_insts_in_(&unit_stat_set_, "decode_insts_in",
+                         "Number of instructions decoded (before fusion)",
+                         sparta::Counter::COUNT_NORMAL),
+
+        decode_uops_out_(&unit_stat_set_, "decode_uops_out",
+                         "Number of uops sent to rename (after fusion)",
+                         sparta::Counter::COUNT_NORMAL),
+
+        decode_active_cycles_(&unit_stat_set_, "decode_active_cycles",
+                              "Number of cycles decode sent uops to rename",
+                              sparta::Counter::COUNT_NORMAL),
+
+        decode_effective_width_(&unit_stat_set_, "decode_effective_width",
+                                "Instructions decoded per active cycle, fused instructions included",
+                                &unit_stat_set_, "decode_insts_in/decode_active_cycles"),
+
+        decode_uop_width_(&unit_stat_set_, "decode_uop_width",
+                          "Uops sent to rename per active cycle",
+                          &unit_stat_set_, "decode_uops_out/decode_active_cycles"),
+
+        fusion_match_time_ns_(&unit_stat_set_, "fusion_match_time_ns",
+                              "Host time spent matching fusion groups (ns)",
+                              sparta::Counter::COUNT_NORMAL),
+
         num_to_decode_(p->num_to_decode),
         fusion_enable_(p->fusion_enable),
         fusion_debug_(p->fusion_debug),
         fusion_enable_register_(p->fusion_enable_register),
         fusion_max_latency_(p->fusion_max_latency),
-        fusion_match_max_tries_(p->fusion_match_max_tries),
         fusion_max_group_size_(p->fusion_max_group_size),
         fusion_summary_report_(p->fusion_summary_report),
         fusion_group_definitions_(p->fusion_group_definitions),
         vector_enabled_(true),
+        vlen_(p->vlen),
         vector_config_(new VectorConfig(p->init_vl, p->init_sew, p->init_lmul, p->init_vta)),
         vset_blocking_count_(&unit_stat_set_, "vset_blocking_count",
                              "Number of times that the Decode unit blocks execution",
                              sparta::Counter::COUNT_NORMAL),
         vset_blocking_stall_latency_(&unit_stat_set_, "vset_blocking_stall_latency",
                                      "Accumulated between roundtrip vset decode and processing",
-                                     sparta::Counter::COUNT_NORMAL)
+                                     sparta::Counter::COUNT_NORMAL),
+        vector_expansion_stall_cycles_(
+            &unit_stat_set_, "vector_expansion_stall_cycles",
+            "Decode cycles cut short by the vector uop expansion bandwidth",
+            sparta::Counter::COUNT_NORMAL)
     {
+        sparta_assert(sparta::utils::is_power_of_2(vlen_) && (vlen_ >= 64),
+                      "decode vlen must be a power of 2, at least 64: " << vlen_);
+        vector_config_->setVLEN(vlen_);
+
         initializeFusion_();
 
         fetch_queue_.enableCollection(node);
@@ -87,6 +136,39 @@ namespace olympia
         sparta::TreeNode* root_node = getContainer()->getRoot();
         vec_uop_gen_ = root_node->getChild("cpu.core0.decode.vec_uop_gen")
                            ->getResourceAs<olympia::VectorUopGenerator*>();
+
+        // The uop cache is optional
+        if (auto uop_cache_node = getContainer()->getChild("uop_cache", false);
+            uop_cache_node != nullptr)
+        {
+            auto uop_cache = uop_cache_node->getResourceAs<olympia::UopCache*>();
+            if (uop_cache->isEnabled())
+            {
+                uop_cache_ = uop_cache;
+            }
+        }
+
+        // The loop buffer is optional
+        if (auto loop_buffer_node = getContainer()->getChild("loop_buffer", false);
+            loop_buffer_node != nullptr)
+        {
+            auto loop_buffer = loop_buffer_node->getResourceAs<olympia::LoopBuffer*>();
+            if (loop_buffer->isEnabled())
+            {
+                loop_buffer_ = loop_buffer;
+            }
+        }
+
+        // The vset predictor is optional
+        if (auto vset_predictor_node = getContainer()->getChild("vset_predictor", false);
+            vset_predictor_node != nullptr)
+        {
+            auto vset_predictor = vset_predictor_node->getResourceAs<olympia::VsetPredictor*>();
+            if (vset_predictor->isEnabled())
+            {
+                vset_predictor_ = vset_predictor;
+            }
+        }
     }
 
     // -------------------------------------------------------------------
@@ -96,7 +178,7 @@ namespace olympia
         if (fusion_enable_)
         {
             fuser_ = std::make_unique<FusionType>(fusion_group_definitions_);
-            hcache_ = fusion::HCache(FusionGroupType::jenkins_1aat);
+            fusion_matcher_.build(fuser_->getFusionGroupContainer());
             fusion_num_groups_defined_ = fuser_->getFusionGroupContainer().size();
         }
         else
@@ -127,6 +209,12 @@ namespace olympia
         {
             fetch_queue_.push(i);
             ILOG("Received: " << i);
+
+            // Look for loops that can be replayed from the loop buffer
+            if (loop_buffer_ != nullptr && !i->isLoopBufferReplay())
+            {
+                loop_buffer_->observe(i);
+            }
         }
         if (uop_queue_credits_ > 0)
         {
@@ -155,6 +243,18 @@ namespace olympia
     // for set instructions that depend on register
     void Decode::processVset_(const InstPtr & inst)
     {
+        if (vset_predictor_ != nullptr)
+        {
+            vset_predictor_->update(inst);
+        }
+
+        // Decode did not wait on a predicted vset, its configuration is
+        // already in use (a misprediction is handled when it retires)
+        if (inst->isPredictedVSET())
+        {
+            return;
+        }
+
         updateVectorConfig_(inst);
 
         // if rs1 != 0, VL = x[rs1], so we assume there's an STF field for VL
@@ -175,18 +275,69 @@ namespace olympia
         fetch_queue_credits_outp_.send(fetch_queue_.size());
         fetch_queue_.clear();
 
+        // A partially decoded fetch block cannot be filled
+        uop_cache_fill_block_.clear();
+
         // Reset the vector uop generator
         vec_uop_gen_->handleFlush(criteria);
+
+        // Instructions after a vset restart with its configuration, e.g.
+        // after a vset misprediction
+        if (criteria.getInstPtr()->isVset() && !criteria.isInclusiveFlush())
+        {
+            vector_config_ = criteria.getInstPtr()->getVectorConfig();
+        }
+
+        if (vset_predictor_ != nullptr)
+        {
+            vset_predictor_->handleFlush(criteria);
+        }
     }
 
     // Decode instructions
     void Decode::decodeInsts_()
     {
-        const uint32_t num_to_decode = std::min(uop_queue_credits_, num_to_decode_);
+        // No decode while switching between the uop cache and the legacy
+        // decoders, the switch scheduled the decode resuming after it
+        if (getClock()->currentCycle() < uop_cache_switch_end_cycle_)
+        {
+            return;
+        }
+
+        // Instructions replayed by the loop buffer are already decoded and
+        // bypass the decoders
+        const bool from_loop_buffer = (loop_buffer_ != nullptr) && (getNumVecUopsRemaining() == 0)
+                                      && (fetch_queue_.size() > 0)
+                                      && fetch_queue_.read(0)->isLoopBufferReplay();
+
+        // Instructions delivered by the uop cache were decoded (and fused)
+        // when their block was filled, they bypass the decoders
+        const bool from_uop_cache = (uop_cache_ != nullptr) && (getNumVecUopsRemaining() == 0)
+                                    && (fetch_queue_.size() > 0)
+                                    && fetch_queue_.read(0)->isUopCacheHit();
+        if (uop_cache_ != nullptr && (fetch_queue_.size() > 0) && !from_loop_buffer
+            && (from_uop_cache != uop_cache_delivering_))
+        {
+            uop_cache_delivering_ = from_uop_cache;
+            uop_cache_->recordSwitch();
+            if (uop_cache_->getSwitchPenalty() > 0)
+            {
+                ILOG("Switching to " << (from_uop_cache ? "uop cache" : "legacy decode"));
+                uop_cache_switch_end_cycle_ =
+                    getClock()->currentCycle() + uop_cache_->getSwitchPenalty();
+                ev_decode_insts_event_.schedule(uop_cache_->getSwitchPenalty());
+                return;
+            }
+        }
+
+        const uint32_t decode_width = from_loop_buffer ? loop_buffer_->getDeliveryWidth()
+                                      : from_uop_cache ? uop_cache_->getDeliveryWidth()
+                                                       : num_to_decode_;
+        const uint32_t num_to_decode = std::min(uop_queue_credits_, decode_width);
 
         // buffer to maximize the chances of a group match limited
         // by max allowed latency, bounded by max group size
-        if (fusion_enable_)
+        if (fusion_enable_ && !from_uop_cache)
         {
             if (num_to_decode < fusion_max_group_size_ && latency_count_ < fusion_max_latency_)
             {
@@ -197,8 +348,11 @@ namespace olympia
 
         latency_count_ = 0;
 
-        // For fusion
-        InstUidListType uids;
+        // Instructions taken from the fetch queue, credited back to Fetch
+        uint32_t num_fetch_queue_pops = 0;
+
+        // Decode stopped short because of the vector uop expansion bandwidth
+        bool vector_expansion_stall = false;
 
         // Send instructions on their way to rename
         InstGroupPtr insts = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
@@ -208,6 +362,11 @@ namespace olympia
         {
             if (vec_uop_gen_->getNumUopsRemaining() > 0)
             {
+                if (!vec_uop_gen_->canGenerateUop())
+                {
+                    vector_expansion_stall = true;
+                    break;
+                }
                 const InstPtr uop = vec_uop_gen_->generateUop();
                 insts->emplace_back(uop);
                 uop->setStatus(Inst::Status::DECODED);
@@ -218,10 +377,45 @@ namespace olympia
                               "Cannot read from the fetch queue because it is empty!");
                 auto & inst = fetch_queue_.read(0);
 
+                // Don't mix uop cache, loop buffer and legacy decoded instructions in a group
+                if ((inst->isUopCacheHit() != from_uop_cache)
+                    || (inst->isLoopBufferReplay() != from_loop_buffer))
+                {
+                    break;
+                }
+
+                if (from_uop_cache || from_loop_buffer)
+                {
+                    ILOG((from_uop_cache ? "Uop cache: " : "Loop buffer: ") << inst);
+                    insts->emplace_back(inst);
+                    inst->setStatus(Inst::Status::DECODED);
+                    fetch_queue_.pop();
+                    ++num_fetch_queue_pops;
+                    continue;
+                }
+
+                // Even if LMUL == 1, we need the vector uop generator to create a uop for us
+                // because some generators will add additional sources and destinations to the
+                // instruction (e.g. widening, multiply-add, slides).
+                const bool needs_uop_gen = inst->isVector() && !inst->isVset()
+                    && (inst->getUopGenType() != InstArchInfo::UopGenType::NONE);
+                if (needs_uop_gen && !vec_uop_gen_->canAcceptInst())
+                {
+                    vector_expansion_stall = true;
+                    break;
+                }
+
+                // The vset produces the configuration of this implementation's VLEN
+                if (inst->isVset())
+                {
+                    inst->getVectorConfig()->setVLEN(vlen_);
+                }
+
                 // for vector instructions, we block on vset and do not allow any other
-                // processing of instructions until the vset is resolved optimizations could be
-                // to allow scalar operations to move forward until a subsequent vector
-                // instruction is detected or do vset prediction
+                // processing of instructions until the vset is resolved, unless the vset
+                // predictor provides its configuration. An optimization could be to allow
+                // scalar operations to move forward until a subsequent vector instruction
+                // is detected
 
                 // vsetvl always block
                 // vsetvli only blocks if rs1 is not x0
@@ -234,14 +428,26 @@ namespace olympia
                 }
                 else if (uid == MAVIS_UID_VSETVLI || uid == MAVIS_UID_VSETVL)
                 {
-                    ++vset_blocking_count_;
-
-                    vset_block_start_ = getClock()->currentCycle();
-                    // block for vsetvl or vsetvli when rs1 of vsetvli is NOT 0
-                    waiting_on_vset_ = true;
-                    // need to indicate we want a signal sent back at execute
-                    inst->setBlockingVSET(true);
-                    ILOG("Decode stalled, Waiting on vset that has register dependency: " << inst)
+                    const VectorConfigPtr predicted_config =
+                        (vset_predictor_ != nullptr) ? vset_predictor_->predict(inst) : nullptr;
+                    if (predicted_config != nullptr)
+                    {
+                        // Keep decoding with the predicted configuration
+                        vector_config_ = predicted_config;
+                        ILOG("Decode continues past predicted vset: " << inst);
+                    }
+                    else
+                    {
+                        ++vset_blocking_count_;
+
+                        vset_block_start_ = getClock()->currentCycle();
+                        // block for vsetvl or vsetvli when rs1 of vsetvli is NOT 0
+                        waiting_on_vset_ = true;
+                        // need to indicate we want a signal sent back at execute
+                        inst->setBlockingVSET(true);
+                        ILOG("Decode stalled, Waiting on vset that has register dependency: "
+                             << inst)
+                    }
                 }
                 else
                 {
@@ -254,11 +460,12 @@ namespace olympia
 
                 ILOG("Decoded: " << inst);
 
-                // Even if LMUL == 1, we need the vector uop generator to create a uop for us
-                // because some generators will add additional sources and destinations to the
-                // instruction (e.g. widening, multiply-add, slides).
-                if (inst->isVector() && !inst->isVset()
-                    && (inst->getUopGenType() != InstArchInfo::UopGenType::NONE))
+                if (uop_cache_ != nullptr)
+                {
+                    uop_cache_fill_block_.emplace_back(inst);
+                }
+
+                if (needs_uop_gen)
                 {
                     ILOG("Vector uop gen: " << inst);
                     vec_uop_gen_->setInst(inst);
@@ -273,13 +480,9 @@ namespace olympia
                     inst->setStatus(Inst::Status::DECODED);
                 }
 
-                if (fusion_enable_)
-                {
-                    uids.push_back(inst->getMavisUid());
-                }
-
                 // Remove from Fetch Queue
                 fetch_queue_.pop();
+                ++num_fetch_queue_pops;
             }
             else
             {
@@ -288,24 +491,29 @@ namespace olympia
             }
         }
 
-        if (fusion_enable_)
+        // Fusion, the loop buffer holds unfused instructions.  Instructions
+        // delivered by the uop cache have their fusion state restored.
+        if (fusion_enable_ && !from_uop_cache)
         {
-            MatchInfoListType matches;
-            uint32_t max_itrs = 0;
-            FusionGroupContainerType & container = fuser_->getFusionGroupContainer();
-            do
+            // One UID per instruction (or vector uop) of the group
+            InstUidListType uids;
+            uids.reserve(insts->size());
+            for (const auto & inst : *insts)
             {
-                matchFusionGroups_(matches, insts, uids, container);
-                processMatches_(matches, insts, uids);
-                // Future feature whereIsEgon(insts,numGhosts);
-                ++max_itrs;
-            } while (matches.size() > 0 && max_itrs < fusion_match_max_tries_);
-
-            if (max_itrs >= fusion_match_max_tries_)
-            {
-                throw sparta::SpartaException("Fusion group match watch dog exceeded.");
+                uids.push_back(inst->getMavisUid());
             }
 
+            const auto match_start = std::chrono::steady_clock::now();
+            MatchInfoListType matches;
+            fusion_matcher_.match(uids, matches);
+            fusion_match_time_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now() - match_start)
+                                         .count();
+            ++fusion_match_groups_;
+            fusion_matches_ += matches.size();
+
+            processMatches_(matches, insts, uids);
+
             // Debug statement
             if (fusion_debug_)
             {
@@ -313,19 +521,44 @@ namespace olympia
             }
         }
 
+        // Fused ops occupy a single slot from here on
+        if (fusion_enable_)
+        {
+            uint32_t num_ghosts = 0;
+            whereIsEgon_(insts, num_ghosts);
+        }
+
+        if (vector_expansion_stall)
+        {
+            ILOG("Decode stalled on vector uop expansion bandwidth");
+            ++vector_expansion_stall_cycles_;
+        }
+
+        decode_insts_in_ += num_fetch_queue_pops;
+        decode_uops_out_ += insts->size();
+        if (!insts->empty())
+        {
+            ++decode_active_cycles_;
+        }
+
+        if (uop_cache_ != nullptr && !insts->empty() && !from_loop_buffer)
+        {
+            if (!from_uop_cache)
+            {
+                fillUopCache_();
+            }
+            uop_cache_->recordDelivery(insts->size(), from_uop_cache);
+        }
+
         // Send decoded instructions to rename
         uop_queue_outp_.send(insts);
 
-        // TODO: whereisegon() would remove the ghosts,
-        // Commented out for now, in practice insts
-        // would be smaller due to the fused ops
-        // uint32_t unfusedInstsSize = insts->size();
-
-        // Decrement internal Uop Queue credits
+        // Decrement internal Uop Queue credits, the fusion ghosts do not
+        // use any
         uop_queue_credits_ -= insts->size();
 
         // Send credits back to Fetch to get more instructions
-        fetch_queue_credits_outp_.send(insts->size());
+        fetch_queue_credits_outp_.send(num_fetch_queue_pops);
 
         // If we still have credits to send instructions as well as
         // instructions in the queue, schedule another decode session
@@ -334,4 +567,20 @@ namespace olympia
             ev_decode_insts_event_.schedule(1);
         }
     }
+
+    // Fill the uop cache with the legacy decoded fetch blocks whose last
+    // instruction has been decoded (and fused)
+    void Decode::fillUopCache_()
+    {
+        auto block_begin = uop_cache_fill_block_.begin();
+        for (auto it = uop_cache_fill_block_.begin(); it != uop_cache_fill_block_.end(); ++it)
+        {
+            if ((*it)->isLastInFetchBlock())
+            {
+                uop_cache_->fill(std::vector<InstPtr>(block_begin, std::next(it)));
+                block_begin = std::next(it);
+            }
+        }
+        uop_cache_fill_block_.erase(uop_cache_fill_block_.begin(), block_begin);
+    }
 } // namespace olympia
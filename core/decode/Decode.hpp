@@ -5,13 +5,13 @@
 #include "CoreTypes.hpp"
 #include "FlushManager.hpp"
 #include "InstGroup.hpp"
+#include "decode/FusionMatcher.hpp"
 #include "decode/MavisUnit.hpp"
 
 #include "fsl_api/FieldExtractor.h"
 #include "fsl_api/Fusion.h"
 #include "fsl_api/FusionGroup.h"
 #include "fsl_api/FusionTypes.h"
-#include "fsl_api/HCache.h"
 #include "fsl_api/MachineInfo.h"
 
 #include "sparta/ports/DataPort.hpp"
@@ -19,6 +19,7 @@
 #include "sparta/simulation/Unit.hpp"
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/StatisticDef.hpp"
 
 #include <limits>
 #include <map>
@@ -29,6 +30,9 @@
 namespace olympia
 {
     class VectorUopGenerator;
+    class UopCache;
+    class LoopBuffer;
+    class VsetPredictor;
     /**
      * @file   Decode.h
      * @brief Decode instructions from Fetch and send them on
@@ -103,9 +107,6 @@ namespace olympia
             //! be true
             PARAMETER(uint32_t, fusion_max_latency, 4, "max fusion latency")
 
-            //! \brief fusion group match max iterations
-            PARAMETER(uint32_t, fusion_match_max_tries, 1023, "fusion group match attempts limit")
-
             //! \brief records the largest fusion group size
             //!
             //! Used with fusion_max_latency to gather instructions for
@@ -132,6 +133,11 @@ namespace olympia
 
             //! Vector tail agnostic, default is undisturbed
             PARAMETER(bool, init_vta, 0, "vector tail agnostic")
+
+            //! Vector register length in bits
+            PARAMETER(uint32_t, vlen, VectorConfig::VLEN,
+                      "Vector register length (VLEN) in bits.  The VL of the vsets of the "
+                      "trace is capped by the VLMAX of this VLEN")
         };
 
         /**
@@ -175,28 +181,6 @@ namespace olympia
         //! \brief initialize the fusion group configuration
         void constructFusionGroups_();
 
-        //! \brief compare the dynamic uid vector to the predefined groups
-        //!
-        //! returns a sorted list of matches
-        //! Matches the fusionGroup sets against the input. There is a continuation
-        //! check invoked if the fusionGroup is larger than the input list.
-        //! FusionGroups must exactly match a segment of the input.
-        //!
-        //! During construction each fusion group has a pre-calculated Hash
-        //! created from the UIDs in the group.
-        //!
-        //! The group hash is matched against hashes formed from the input UIDs.
-        //!
-        //! In order to match the input to the group, hashes must be created of
-        //! the input.
-        //!
-        //! A 'cache' of the inputUids is created on entry. The cache is indexed
-        //! by group size. The cache data is a vector of pairs, pair.first is the
-        //! input position within inputUids, pair.second is the hash of the
-        //! inputUids in that segment.
-        void matchFusionGroups_(MatchInfoListType & matches, InstGroupPtr & insts,
-                                InstUidListType & inputUIDS, FusionGroupContainerType &);
-
         //! \brief process the fusion matches
         void processMatches_(MatchInfoListType &, InstGroupPtr & insts,
                              const InstUidListType & inputUIDS);
@@ -205,9 +189,13 @@ namespace olympia
         //!
         //! The matching pass identifies the master fusion op (FUSED)
         //! and the ops that will be eliminated (FUSION_GHOST).
-        //! This pass removes the ghosts. Future feature: not currently used.
+        //! This pass removes the ghosts, the fused op occupies a single
+        //! slot downstream and retires for the whole group.
         void whereIsEgon_(InstGroupPtr &, uint32_t &);
 
+        //! \brief can the size instructions starting at itr be fused?
+        bool isFusible_(InstGroup::iterator itr, size_t size, InstGroup::iterator end) const;
+
         //! \brief ...
         void infoInsts_(std::ostream & os, const InstGroupPtr & insts);
 
@@ -268,6 +256,36 @@ namespace olympia
         //! of the defined fusion groups.
         sparta::Counter fusion_pred_cycles_saved_;
 
+        //! \brief number of decode groups examined by the fusion matcher
+        sparta::Counter fusion_match_groups_;
+
+        //! \brief number of fusion group matches found
+        sparta::Counter fusion_matches_;
+
+        //! \brief average number of matches per decode group
+        sparta::StatisticDef fusion_matches_per_group_;
+
+        //! \brief instructions decoded, before fusion
+        sparta::Counter decode_insts_in_;
+
+        //! \brief uops sent to rename, after fusion ghosts are removed
+        sparta::Counter decode_uops_out_;
+
+        //! \brief cycles decode sent uops to rename
+        sparta::Counter decode_active_cycles_;
+
+        //! \brief instructions per active decode cycle (the effective width)
+        sparta::StatisticDef decode_effective_width_;
+
+        //! \brief uops per active decode cycle (the width actually used)
+        sparta::StatisticDef decode_uop_width_;
+
+        //! \brief host time spent in the fusion matcher, in nanoseconds
+        //!
+        //! Measures the cost of the matcher in the model, not a
+        //! property of the modeled hardware
+        sparta::Counter fusion_match_time_ns_;
+
         //! \brief temporary for number of instructions to decode this time
         const uint32_t num_to_decode_;
 
@@ -301,9 +319,6 @@ namespace olympia
         //! experimenting with instruction gathering
         const uint32_t fusion_max_latency_{0};
 
-        //! \brief max attempts to match UIDs of instrs in the XIQ
-        const uint32_t fusion_match_max_tries_{0};
-
         //! \brief the longest chain of UIDs across all groups
         //!
         //! \see FusionGroup
@@ -317,8 +332,10 @@ namespace olympia
         //! \see Fusion.hpp
         std::unique_ptr<FusionType> fuser_{nullptr};
 
-        //! \brief fusion group matching hash
-        fusion::HCache hcache_;
+        //! \brief precompiled fusion group matcher
+        //!
+        //! Built once from the fusion group definitions
+        FusionMatcher fusion_matcher_;
 
         //! \brief fusion function object callback proxies
         struct cbProxy_;
@@ -332,6 +349,7 @@ namespace olympia
         //////////////////////////////////////////////////////////////////////
         // Vector
         const bool vector_enabled_;
+        const uint32_t vlen_;
         VectorConfigPtr vector_config_;
 
         bool waiting_on_vset_;
@@ -344,6 +362,9 @@ namespace olympia
         sparta::Counter vset_blocking_count_;
         sparta::Counter vset_blocking_stall_latency_;
 
+        //! \brief decode cycles limited by the vector uop expansion bandwidth
+        sparta::Counter vector_expansion_stall_cycles_;
+
         uint64_t vset_block_start_;
 
         //////////////////////////////////////////////////////////////////////
@@ -356,6 +377,37 @@ namespace olympia
         void handleFlush_(const FlushManager::FlushingCriteria & criteria);
 
         uint32_t uop_queue_credits_ = 0;
+
+        //////////////////////////////////////////////////////////////////////
+        // Uop cache
+
+        //! \brief the decoded uop cache, nullptr when not enabled
+        UopCache * uop_cache_ = nullptr;
+
+        //! \brief true if the last decode group was delivered by the uop cache
+        bool uop_cache_delivering_ = false;
+
+        //! \brief first cycle decoding again after a uop cache/legacy decoder switch
+        uint64_t uop_cache_switch_end_cycle_ = 0;
+
+        //! \brief legacy decoded instructions waiting for their fetch block to complete
+        std::vector<InstPtr> uop_cache_fill_block_;
+
+        //! \brief fill the uop cache with the completed (decoded and fused) fetch blocks
+        void fillUopCache_();
+
+        //////////////////////////////////////////////////////////////////////
+        // Loop buffer
+
+        //! \brief the loop stream buffer, nullptr when not enabled
+        LoopBuffer * loop_buffer_ = nullptr;
+
+        //////////////////////////////////////////////////////////////////////
+        // Vector configuration prediction
+
+        //! \brief the vset predictor, nullptr when not enabled
+        VsetPredictor * vset_predictor_ = nullptr;
+
         friend class DecodeTester;
     };
     class DecodeTester;
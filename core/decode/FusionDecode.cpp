@@ -19,24 +19,20 @@ using namespace fusion;
 namespace olympia
 {
     // -------------------------------------------------------------------
-    // Remove the ghost fusion ops
-    // Kept, but currently not called
+    // Remove the ghost fusion ops, the fused op stands for them from here on
     // -------------------------------------------------------------------
     void Decode::whereIsEgon_(InstGroupPtr & insts, uint32_t & numGhosts)
     {
         if (insts == nullptr)
         {
-            // DLOG("whereIsEgon() called with insts null");
             return;
         }
 
-        // DLOG("BEFORE # --------------------------------------");
-        // infoInsts(cout,insts);
-
         for (auto it = insts->begin(); it != insts->end();)
         {
             if ((*it)->getExtendedStatus() == olympia::Inst::Status::FUSION_GHOST)
             {
+                ILOG("Removing fusion ghost: " << *it);
                 ++numGhosts;
                 it = insts->erase(it);
             }
@@ -45,9 +41,6 @@ namespace olympia
                 ++it;
             }
         }
-        // DLOG("AFTER  # --------------------------------------");
-        // infoInsts(cout,insts);
-        // DLOG("DONE   # --------------------------------------");
     }
 
     // -------------------------------------------------------------------
@@ -76,14 +69,14 @@ namespace olympia
 
             InstGroup::iterator itr = insts->begin();
             std::advance(itr, thisMatch.startIdx);
-            if ((*itr)->getExtendedStatus() == Inst::Status::UNMOD)
+            if (isFusible_(itr, thisMatch.size(), insts->end()))
             {
                 (*itr)->setExtendedStatus(Inst::Status::FUSED);
                 ++fusion_num_fuse_instructions_;
-                // Kept for upcoming additional work on reducing ROB
-                // entry requirements. This manages the sequential expectations
-                // of the ROB for program ID.
-                //(*itr)->setProgramIDIncrement(thisMatch.size());
+                // The ghosts are removed, the fused op retires for all of
+                // them. This manages the sequential expectations of the
+                // ROB for program ID.
+                (*itr)->setProgramIDIncrement(thisMatch.size());
 
                 for (size_t i = 1; i < thisMatch.size(); ++i)
                 {
@@ -101,112 +94,75 @@ namespace olympia
         matches.clear();
     }
 
-    // ----------------------------------------------------------------------
-    // TODO: this performs well for the FusionGroup set sizes tested, ~256.
-    // More testing is intended for 2048 (10x any practical size).
-    // Further improvement is deferred until a decsion on uop/trace cache
-    // implementations. Regardless, if warranted for model performance,
-    // an abstracted uop$ can be built using what is below adding the more
-    // conventional address indexing but retaining the UIDs as abstractions
-    // to fully decoded instrs.
-    // ----------------------------------------------------------------------
-    void Decode::matchFusionGroups_(MatchInfoListType & matches, InstGroupPtr & insts,
-                                    InstUidListType & inputUids,
-                                    FusionGroupContainerType & fusionGroups)
+    // ------------------------------------------------------------------------
+    // A match can be fused if its instructions are consecutive in program
+    // order and have not been fused already.  Vector uops, vset and system
+    // instructions are never fused.
+    //
+    // The ghosts are removed, only the operands and the memory access of
+    // the fused op (the head of the group) are renamed and executed.  A
+    // ghost must not access memory, must only write registers written by
+    // the head and only read registers read or written by the head.
+    // Branches and other changes of flow are never ghosts.
+    // ------------------------------------------------------------------------
+    bool Decode::isFusible_(InstGroup::iterator itr, size_t size, InstGroup::iterator end) const
     {
-        matches.clear(); // Clear any existing matches
-
-        // The cache is a map of cachelines, indexed by size,
-        //          <size, list of <index,hash>
-        //
-        //   3   1:hash  2:hash 3:hash  ... modulo size, inputUids.size() % 3
-        hcache_.clear();
-
-        for (auto & fgPair : fusionGroups)
+        const InstPtr head = *itr;
+        auto is_head_operand = [](const auto & head_operands, const auto & operand)
+        {
+            return operand.is_x0
+                   || std::any_of(head_operands.begin(), head_operands.end(),
+                                  [&operand](const auto & head_operand)
+                                  {
+                                      return (head_operand.reg_file == operand.reg_file)
+                                             && (head_operand.field_value == operand.field_value);
+                                  });
+        };
+
+        uint64_t program_id = head->getProgramID();
+        for (size_t i = 0; i < size; ++i, ++itr, ++program_id)
         {
-            auto & fGrp = fgPair.second;
-            size_t grpSize = fGrp.uids().size();
+            if (itr == end)
+            {
+                return false;
+            }
+            const auto & inst = *itr;
+            if ((inst->getExtendedStatus() != Inst::Status::UNMOD)
+                || (inst->getProgramID() != program_id) || (inst->getUOpID() != 0)
+                || inst->isVector() || inst->isVset()
+                || (inst->getPipe() == InstArchInfo::TargetPipe::SYS))
+            {
+                return false;
+            }
 
-            // grpSize should be less than the input for matching fusion pairs
-            if(grpSize > inputUids.size())
+            if (i == 0)
             {
                 continue;
             }
 
-            hcache_.buildHashCacheEntry(inputUids, grpSize);
-        }
-
-        for (auto & fgPair : fusionGroups)
-        {
-
-            HashType grpHash = fgPair.first;
-            auto & fGrp = fgPair.second;
-            size_t grpSize = fGrp.uids().size();
-
-            // No match possible if the fg is bigger than the input
-            if (grpSize > inputUids.size())
+            // A branch ghost would lose its outcome and never resolve on
+            // the BR pipe
+            if (inst->isLoadStoreInst() || inst->isBranch() || inst->isCoF())
             {
-                /*++filtered;*/ continue;
+                return false;
             }
-
-            // If the grpSize is not in the hash cache we need to calculate it
-            if (hcache_.find(grpSize) == hcache_.end())
+            for (const auto & dest : inst->getDestOpInfoListWithRegfile())
             {
-                hcache_.buildHashCacheEntry(inputUids, grpSize);
+                if (!is_head_operand(head->getDestOpInfoListWithRegfile(), dest))
+                {
+                    return false;
+                }
             }
-
-            // If this fires something unexplained happened, the entry hit
-            // in the first place or it was constructed on a miss,
-            // either way this should never fire.
-            sparta_assert(hcache_.find(grpSize) != hcache_.end())
-
-                // pairs is from the cache entries with the same size as fGrp.
-                // a pair is <index,hash>, index is the position in the input
-                HashPairListType pairs = hcache_[grpSize];
-
-            // For each of the pairs that have the same size as fGrp.
-            for (auto & ep : pairs)
+            for (const auto & src : inst->getSrcOpInfoListWithRegfile())
             {
-                // if the pair.hash matches the group's hash
-                if (ep.second == grpHash)
+                if (!is_head_operand(head->getSrcOpInfoListWithRegfile(), src)
+                    && !is_head_operand(head->getDestOpInfoListWithRegfile(), src))
                 {
-
-                    // DLOG("HASH HIT, index "<<dec<<ep.first<<" hash 0x"<<setw(8)
-                    //                        <<hex<<setfill('0')<<grpHash);
-                    size_t startIdx = ep.first;
-                    bool match = true;
-                    size_t j = 0;
-
-                    for (size_t i = startIdx; i < grpSize; ++i)
-                    {
-                        if (inputUids[i] != fGrp.uids()[j])
-                        {
-                            match = false;
-                            break;
-                        }
-                        ++j;
-                    }
-
-                    if (match)
-                    {
-                        matches.emplace_back(fGrp.name(), startIdx, 0, fGrp.uids());
-                        // DLOG("SEQ MATCH "<<fGrp.name()<<" "<<dec<<grpSize);
-                    }
+                    return false;
                 }
             }
         }
-
-        // FIXME: make this an assignable function object
-        // Sort by size descending, sort by startIdx ascending
-        std::sort(matches.begin(), matches.end(),
-                  [](const FusionGroupMatchInfo & lhs, const FusionGroupMatchInfo & rhs)
-                  {
-                      if (lhs.size() == rhs.size())
-                      {
-                          return lhs.startIdx < rhs.startIdx;
-                      }
-                      return lhs.size() > rhs.size();
-                  });
+        return true;
     }
 
     // ------------------------------------------------------------------------
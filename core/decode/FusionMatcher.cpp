@@ -0,0 +1,64 @@
+// <FusionMatcher.cpp> -*- C++ -*-
+
+#include "decode/FusionMatcher.hpp"
+
+#include <algorithm>
+
+namespace olympia
+{
+    void FusionMatcher::buildIndex_()
+    {
+        // Longest groups first, by name for a deterministic order
+        std::sort(patterns_.begin(), patterns_.end(),
+                  [](const Pattern & lhs, const Pattern & rhs)
+                  {
+                      if (lhs.uids.size() == rhs.uids.size())
+                      {
+                          return lhs.name < rhs.name;
+                      }
+                      return lhs.uids.size() > rhs.uids.size();
+                  });
+
+        for (uint32_t idx = 0; idx < patterns_.size(); ++idx)
+        {
+            const auto & uids = patterns_[idx].uids;
+            bigram_index_[makeKey_(uids[0], uids[1])].push_back(idx);
+        }
+    }
+
+    void FusionMatcher::match(const InstUidListType & uids, MatchInfoListType & matches) const
+    {
+        matches.clear();
+
+        size_t idx = 0;
+        while ((idx + 1) < uids.size())
+        {
+            const Pattern* matched = nullptr;
+            if (const auto candidates = bigram_index_.find(makeKey_(uids[idx], uids[idx + 1]));
+                candidates != bigram_index_.end())
+            {
+                for (const auto pattern_idx : candidates->second)
+                {
+                    const auto & pattern = patterns_[pattern_idx];
+                    if (((idx + pattern.uids.size()) <= uids.size())
+                        && std::equal(pattern.uids.begin() + 2, pattern.uids.end(),
+                                      uids.begin() + idx + 2))
+                    {
+                        matched = &pattern;
+                        break;
+                    }
+                }
+            }
+
+            if (matched != nullptr)
+            {
+                matches.emplace_back(matched->name, idx, 0, matched->uids);
+                idx += matched->uids.size();
+            }
+            else
+            {
+                ++idx;
+            }
+        }
+    }
+} // namespace olympia
@@ -0,0 +1,88 @@
+// <FusionMatcher.hpp> -*- C++ -*-
+//! \file FusionMatcher.hpp
+#pragma once
+
+#include "fsl_api/Fusion.h"
+#include "fsl_api/FusionGroup.h"
+#include "fsl_api/FusionTypes.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace olympia
+{
+
+    /**
+     * @file FusionMatcher.hpp
+     * @brief Precompiled, single pass fusion group matcher
+     *
+     * The fusion group definitions are compiled once into a hashed
+     * n-gram index: each group is indexed by its first two Mavis UIDs
+     * (a bigram), candidates sharing a bigram are kept longest first.
+     *
+     * Matching walks the input UIDs once.  At each position the bigram
+     * selects the few candidate groups, the first (longest) one whose
+     * remaining UIDs match is taken and the walk resumes after it.  The
+     * result is the leftmost-longest set of non-overlapping matches, so
+     * the matches never need to be re-examined.
+     *
+     * Note this differs from the iterative matcher it replaces, which
+     * tried every fusion group over the whole decode group: a match
+     * starting earlier now always wins, even over a longer group
+     * starting later.  E.g. with the groups {a,b} and {b,c,d}, the
+     * input a,b,c,d fuses a,b and leaves c,d unfused.
+     *
+     * Groups of a single UID do not fuse anything and are ignored.
+     */
+    class FusionMatcher
+    {
+      public:
+        using InstUidListType = fusion::InstUidListType;
+        using MatchInfoListType = std::vector<fusion::FusionGroupMatchInfo>;
+
+        //! \brief Compile the fusion group definitions
+        //!
+        //! GroupContainerT is a map of fusion groups (Fusion::getFusionGroupContainer)
+        template <typename GroupContainerT> void build(const GroupContainerT & groups)
+        {
+            patterns_.clear();
+            bigram_index_.clear();
+            for (const auto & group_pair : groups)
+            {
+                const auto & group = group_pair.second;
+                if (group.uids().size() > 1)
+                {
+                    patterns_.push_back({group.name(), group.uids()});
+                }
+            }
+            buildIndex_();
+        }
+
+        //! \brief Find the non-overlapping matches in uids, in program order
+        void match(const InstUidListType & uids, MatchInfoListType & matches) const;
+
+        //! \brief Number of fusion groups compiled into the matcher
+        size_t getNumGroups() const { return patterns_.size(); }
+
+      private:
+        struct Pattern
+        {
+            std::string name;
+            InstUidListType uids;
+        };
+
+        static uint64_t makeKey_(uint64_t first_uid, uint64_t second_uid)
+        {
+            return (first_uid << 32) | (second_uid & 0xFFFFFFFF);
+        }
+
+        void buildIndex_();
+
+        std::vector<Pattern> patterns_;
+
+        // bigram -> indices into patterns_, longest pattern first
+        std::unordered_map<uint64_t, std::vector<uint32_t>> bigram_index_;
+    };
+} // namespace olympia
@@ -0,0 +1,188 @@
+// <FusionMiner.cpp> -*- C++ -*-
+
+#include "decode/FusionMiner.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace olympia
+{
+    FusionMiner::FusionMiner(uint32_t max_length, bool require_dependency) :
+        max_length_(max_length),
+        require_dependency_(require_dependency)
+    {
+        sparta_assert((max_length_ >= 2) && (max_length_ <= MAX_NGRAM_LENGTH),
+                      "fusion miner n-gram length must be between 2 and " << MAX_NGRAM_LENGTH);
+    }
+
+    void FusionMiner::observe(const InstPtr & inst)
+    {
+        ++num_insts_;
+
+        // A taken branch ends the fetch sequence, an n-gram cannot extend past it
+        if (!window_.empty() && window_.back().taken_branch)
+        {
+            window_.clear();
+        }
+        if (window_.size() == max_length_)
+        {
+            window_.pop_front();
+        }
+
+        WindowEntry & entry = window_.emplace_back();
+        entry.uid = inst->getMavisUid();
+        entry.taken_branch = inst->isTakenBranch();
+        for (const auto & src : inst->getSrcOpInfoListWithRegfile())
+        {
+            if (!src.is_x0 && (src.reg_file != core_types::RegFile::RF_INVALID))
+            {
+                entry.srcs[src.reg_file].set(src.field_value);
+            }
+        }
+        for (const auto & dest : inst->getDestOpInfoListWithRegfile())
+        {
+            if (!dest.is_x0 && (dest.reg_file != core_types::RegFile::RF_INVALID))
+            {
+                entry.dests[dest.reg_file].set(dest.field_value);
+            }
+        }
+
+        // Count every n-gram ending with this instruction
+        const uint32_t last_idx = window_.size() - 1;
+        for (uint32_t length = 2; length <= window_.size(); ++length)
+        {
+            const uint32_t first_idx = last_idx - length + 1;
+            if (require_dependency_)
+            {
+                bool dependent = true;
+                for (uint32_t idx = first_idx + 1; dependent && (idx <= last_idx); ++idx)
+                {
+                    dependent = dependsOn_(idx, first_idx);
+                }
+                if (!dependent)
+                {
+                    continue;
+                }
+            }
+
+            NGram ngram;
+            ngram.length = length;
+            for (uint32_t idx = 0; idx < length; ++idx)
+            {
+                ngram.uids[idx] = window_[first_idx + idx].uid;
+            }
+            ++ngram_counts_[ngram];
+        }
+    }
+
+    bool FusionMiner::dependsOn_(uint32_t entry_idx, uint32_t first_idx) const
+    {
+        for (uint32_t idx = first_idx; idx < entry_idx; ++idx)
+        {
+            for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+            {
+                if ((window_[idx].dests[rf] & window_[entry_idx].srcs[rf]).any())
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::vector<FusionMiner::Candidate> FusionMiner::getTopCandidates_(uint32_t top_k) const
+    {
+        std::vector<Candidate> candidates;
+        candidates.reserve(ngram_counts_.size());
+        for (const auto & [ngram, count] : ngram_counts_)
+        {
+            candidates.push_back({ngram, count});
+        }
+
+        // Most uops saved first, then shorter and lower UIDs for a stable order
+        const auto num_candidates = std::min<size_t>(top_k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + num_candidates,
+                          candidates.end(),
+                          [](const Candidate & lhs, const Candidate & rhs)
+                          {
+                              if (lhs.getUopsSaved() != rhs.getUopsSaved())
+                              {
+                                  return lhs.getUopsSaved() > rhs.getUopsSaved();
+                              }
+                              if (lhs.ngram.length != rhs.ngram.length)
+                              {
+                                  return lhs.ngram.length < rhs.ngram.length;
+                              }
+                              return lhs.ngram.uids < rhs.ngram.uids;
+                          });
+        candidates.resize(num_candidates);
+        return candidates;
+    }
+
+    void FusionMiner::writeFusionGroups(std::ostream & os, uint32_t top_k) const
+    {
+        const auto candidates = getTopCandidates_(top_k);
+
+        os << "{" << std::endl;
+        os << "  \"fusiongroups\" : [" << std::endl;
+        for (size_t idx = 0; idx < candidates.size(); ++idx)
+        {
+            const auto & ngram = candidates[idx].ngram;
+            os << "    { \"name\" : \"mf" << std::setw(3) << std::setfill('0') << std::dec << idx
+               << std::setfill(' ') << "\", \"uids\" : [";
+            for (uint32_t uid_idx = 0; uid_idx < ngram.length; ++uid_idx)
+            {
+                os << ((uid_idx == 0) ? "" : ",") << "\"0x" << std::hex << ngram.uids[uid_idx]
+                   << std::dec << "\"";
+            }
+            os << "], \"tx\" : \"dfltXform_\" }" << ((idx + 1 < candidates.size()) ? "," : "")
+               << std::endl;
+        }
+        os << "  ]" << std::endl;
+        os << "}" << std::endl;
+    }
+
+    void FusionMiner::report(std::ostream & os, uint32_t top_k) const
+    {
+        const auto candidates = getTopCandidates_(top_k);
+
+        uint64_t uops_saved = 0;
+        for (const auto & candidate : candidates)
+        {
+            uops_saved += candidate.getUopsSaved();
+        }
+
+        os << "Fusion miner" << std::endl;
+        os << "  instructions:        " << num_insts_ << std::endl;
+        os << "  distinct candidates: " << ngram_counts_.size() << std::endl;
+        os << std::endl << "  " << std::left << std::setw(8) << "group" << std::setw(40) << "uids"
+           << std::right << std::setw(14) << "count" << std::setw(14) << "uops saved"
+           << std::endl;
+        for (size_t idx = 0; idx < candidates.size(); ++idx)
+        {
+            const auto & candidate = candidates[idx];
+            std::ostringstream name;
+            name << "mf" << std::setw(3) << std::setfill('0') << idx;
+            std::ostringstream uids;
+            for (uint32_t uid_idx = 0; uid_idx < candidate.ngram.length; ++uid_idx)
+            {
+                uids << ((uid_idx == 0) ? "" : " ") << "0x" << std::hex
+                     << candidate.ngram.uids[uid_idx];
+            }
+            os << "  " << std::left << std::setw(8) << name.str() << std::setw(40) << uids.str()
+               << std::right << std::setw(14) << candidate.count << std::setw(14)
+               << candidate.getUopsSaved() << std::endl;
+        }
+
+        // Candidates can overlap in the instruction stream, so this is an
+        // upper bound of what the fusion groups remove
+        os << std::endl << "  projected uop reduction (upper bound): " << uops_saved;
+        if (num_insts_ > 0)
+        {
+            os << " (" << std::fixed << std::setprecision(2) << (100.0 * uops_saved) / num_insts_
+               << std::defaultfloat << "% of instructions)";
+        }
+        os << std::endl;
+    }
+} // namespace olympia
@@ -0,0 +1,115 @@
+// <FusionMiner.hpp> -*- C++ -*-
+//! \file FusionMiner.hpp
+#pragma once
+
+#include "Inst.hpp"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace olympia
+{
+
+    /**
+     * @file FusionMiner.hpp
+     * @brief Finds fusion opportunities in a decoded instruction stream
+     *
+     * The miner is fed the (correct path) instructions in program order
+     * and counts the n-grams of adjacent instructions, of 2 up to
+     * max_length instructions, identified by their Mavis UIDs.  Only
+     * dependent n-grams are counted: every instruction after the first
+     * must read a register written by an earlier instruction of the
+     * n-gram.  n-grams do not extend past a taken branch.
+     *
+     * The candidates are ranked by the number of uops fusion would remove,
+     * (dynamic count * (n-1)), and written using the fusion group
+     * definition JSON format read by Decode (fusion_group_definitions).
+     */
+    class FusionMiner
+    {
+      public:
+        static constexpr uint32_t MAX_NGRAM_LENGTH = 4;
+
+        FusionMiner(uint32_t max_length, bool require_dependency);
+
+        //! \brief Count the n-grams ending with inst
+        void observe(const InstPtr & inst);
+
+        //! \brief Break the instruction stream (no n-gram spans a reset)
+        void reset() { window_.clear(); }
+
+        //! \brief Number of instructions observed
+        uint64_t getNumInsts() const { return num_insts_; }
+
+        //! \brief Number of distinct n-grams counted
+        size_t getNumCandidates() const { return ngram_counts_.size(); }
+
+        //! \brief Write the top_k candidates as fusion group definitions
+        void writeFusionGroups(std::ostream & os, uint32_t top_k) const;
+
+        //! \brief Report the top_k candidates and the projected uop reduction
+        void report(std::ostream & os, uint32_t top_k) const;
+
+      private:
+        struct NGram
+        {
+            std::array<mavis::InstructionUniqueID, MAX_NGRAM_LENGTH> uids{};
+            uint32_t length = 0;
+
+            bool operator==(const NGram & other) const
+            {
+                return (length == other.length) && (uids == other.uids);
+            }
+        };
+
+        struct NGramHash
+        {
+            size_t operator()(const NGram & ngram) const
+            {
+                uint64_t hash = ngram.length;
+                for (uint32_t idx = 0; idx < ngram.length; ++idx)
+                {
+                    hash = (hash ^ ngram.uids[idx]) * 0x100000001b3ull;
+                }
+                return hash;
+            }
+        };
+
+        struct Candidate
+        {
+            NGram ngram;
+            uint64_t count = 0;
+
+            uint64_t getUopsSaved() const { return count * (ngram.length - 1); }
+        };
+
+        // Registers written and read by an instruction in the window
+        struct WindowEntry
+        {
+            mavis::InstructionUniqueID uid = 0;
+            std::array<core_types::RegisterBitMask, core_types::RegFile::N_REGFILES> srcs;
+            std::array<core_types::RegisterBitMask, core_types::RegFile::N_REGFILES> dests;
+            bool taken_branch = false;
+        };
+
+        // Does the window entry read a register written by one of the
+        // previous first_idx..entry_idx-1 entries?
+        bool dependsOn_(uint32_t entry_idx, uint32_t first_idx) const;
+
+        // The top_k candidates, most uops saved first
+        std::vector<Candidate> getTopCandidates_(uint32_t top_k) const;
+
+        const uint32_t max_length_;
+        const bool require_dependency_;
+
+        // The last max_length instructions, oldest first
+        std::deque<WindowEntry> window_;
+
+        std::unordered_map<NGram, uint64_t, NGramHash> ngram_counts_;
+        uint64_t num_insts_ = 0;
+    };
+} // namespace olympia
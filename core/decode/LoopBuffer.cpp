@@ -0,0 +1,126 @@
+// <LoopBuffer.cpp> -*- C++ -*-
+
+#include "decode/LoopBuffer.hpp"
+
+#include "sparta/utils/LogUtils.hpp"
+
+namespace olympia
+{
+    constexpr char LoopBuffer::name[];
+
+    LoopBuffer::LoopBuffer(sparta::TreeNode* node, const LoopBufferParameterSet* p) :
+        sparta::Unit(node),
+        enabled_(p->enable),
+        num_entries_(p->num_entries),
+        detect_iterations_(p->detect_iterations),
+        delivery_width_(p->delivery_width)
+    {
+        sparta_assert(delivery_width_ > 0, "loop_buffer delivery_width must be greater than 0");
+    }
+
+    void LoopBuffer::observe(const InstPtr & inst)
+    {
+        if (locked_)
+        {
+            return;
+        }
+
+        // Vector loops are not captured
+        if (inst->isVector())
+        {
+            resetDetection_();
+            return;
+        }
+
+        ++body_size_;
+
+        // Only backward taken branches (not calls/returns) close a loop body,
+        // forward taken branches stay inside of it
+        if (!inst->isTakenBranch() || inst->isCall() || inst->isReturn()
+            || (inst->getTargetVAddr() > inst->getPC()))
+        {
+            return;
+        }
+
+        if ((inst->getPC() == branch_pc_) && (inst->getTargetVAddr() == target_pc_)
+            && (body_size_ == loop_body_size_))
+        {
+            ++iterations_;
+        }
+        else
+        {
+            branch_pc_ = inst->getPC();
+            target_pc_ = inst->getTargetVAddr();
+            loop_body_size_ = body_size_;
+            iterations_ = 1;
+        }
+        body_size_ = 0;
+
+        if ((iterations_ >= detect_iterations_) && (loop_body_size_ <= num_entries_))
+        {
+            lock_();
+        }
+    }
+
+    bool LoopBuffer::replay(const InstPtr & inst)
+    {
+        if (!locked_)
+        {
+            return false;
+        }
+
+        if ((inst->getPC() < target_pc_) || (inst->getPC() > branch_pc_))
+        {
+            ILOG("Loop exit: " << inst);
+            unlock_();
+            return false;
+        }
+
+        ++lsd_insts_replayed_;
+        return true;
+    }
+
+    void LoopBuffer::flush()
+    {
+        if (locked_)
+        {
+            ++lsd_flushes_;
+            unlock_();
+        }
+        resetDetection_();
+    }
+
+    void LoopBuffer::lock_()
+    {
+        locked_ = true;
+        lsd_gated_cycles_.startCounting();
+        ++lsd_loops_detected_;
+        ILOG("Locked loop 0x" << std::hex << target_pc_ << "-0x" << branch_pc_ << std::dec
+                              << " size: " << loop_body_size_);
+    }
+
+    void LoopBuffer::unlock_()
+    {
+        locked_ = false;
+        lsd_gated_cycles_.stopCounting();
+        resetDetection_();
+    }
+
+    void LoopBuffer::onStartingTeardown_()
+    {
+        // The run ended while replaying a loop
+        if (locked_)
+        {
+            lsd_gated_cycles_.stopCounting();
+        }
+    }
+
+    void LoopBuffer::resetDetection_()
+    {
+        branch_pc_ = 0;
+        target_pc_ = 0;
+        loop_body_size_ = 0;
+        iterations_ = 0;
+        body_size_ = 0;
+    }
+} // namespace olympia
@@ -0,0 +1,124 @@
+// <LoopBuffer.hpp> -*- C++ -*-
+//! \file LoopBuffer.hpp
+#pragma once
+
+#include "sparta/simulation/Unit.hpp"
+#include "sparta/simulation/TreeNode.hpp"
+#include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/CycleCounter.hpp"
+
+#include "Inst.hpp"
+
+#include <cstdint>
+
+namespace olympia
+{
+
+    /**
+     * @file LoopBuffer.hpp
+     * @brief Loop stream buffer for small backward-branch loops
+     *
+     * Decode feeds every instruction entering its fetch queue to the
+     * loop detector.  A loop is a backward taken branch whose body
+     * (instructions from the branch target up to the branch) fits in
+     * the buffer.  When the same loop body is seen detect_iterations
+     * times in a row the buffer locks onto it.
+     *
+     * While locked, the loop is replayed from the buffer: Fetch does not
+     * access the ICache and does not break groups on the loop back-edge,
+     * and Decode delivers the decoded instructions with the loop buffer
+     * delivery width.  Fetch replays at most delivery_width instructions
+     * per cycle.  The frontend is power-gated for the duration; the
+     * gated cycles are counted.  The first instruction outside of the
+     * loop body (or a flush) unlocks the buffer.
+     *
+     * Loops with vector instructions are not captured since their uop
+     * expansion depends on the dynamic vector configuration.
+     */
+    class LoopBuffer : public sparta::Unit
+    {
+      public:
+        //! \brief Parameters for LoopBuffer model
+        class LoopBufferParameterSet : public sparta::ParameterSet
+        {
+          public:
+            LoopBufferParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
+
+            PARAMETER(bool, enable, false, "Enable the loop stream buffer")
+            PARAMETER(uint32_t, num_entries, 32, "Largest loop body (in instructions) captured")
+            PARAMETER(uint32_t, detect_iterations, 4,
+                      "Consecutive identical iterations required to lock onto a loop")
+            PARAMETER(uint32_t, delivery_width, 4, "Instructions replayed per cycle")
+        };
+
+        /**
+         * @brief Constructor for LoopBuffer
+         *
+         * @param node The node that represents (has a pointer to) the LoopBuffer
+         * @param p The LoopBuffer's parameter set
+         */
+        LoopBuffer(sparta::TreeNode* node, const LoopBufferParameterSet* p);
+
+        //! \brief Name of this resource. Required by sparta::UnitFactory
+        static constexpr char name[] = "loop_buffer";
+
+        bool isEnabled() const { return enabled_; }
+
+        bool isLocked() const { return locked_; }
+
+        uint32_t getDeliveryWidth() const { return delivery_width_; }
+
+        //! \brief Loop detection, called for each instruction entering Decode
+        void observe(const InstPtr & inst);
+
+        //! \brief Can the instruction be replayed from the locked loop?
+        //!
+        //! An instruction outside of the loop body unlocks the buffer
+        bool replay(const InstPtr & inst);
+
+        //! \brief Unlock and restart loop detection
+        void flush();
+
+      private:
+        void lock_();
+        void unlock_();
+        void resetDetection_();
+
+        void onStartingTeardown_() override;
+
+        const bool enabled_;
+        const uint32_t num_entries_;
+        const uint32_t detect_iterations_;
+        const uint32_t delivery_width_;
+
+        // Candidate (or locked) loop
+        sparta::memory::addr_t branch_pc_ = 0;
+        sparta::memory::addr_t target_pc_ = 0;
+        uint32_t loop_body_size_ = 0;
+        uint32_t iterations_ = 0;
+
+        // Instructions seen since the last backward taken branch
+        uint32_t body_size_ = 0;
+
+        bool locked_ = false;
+
+        sparta::Counter lsd_loops_detected_{&unit_stat_set_, "lsd_loops_detected",
+                                            "Number of times the loop buffer locked onto a loop",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter lsd_insts_replayed_{&unit_stat_set_, "lsd_insts_replayed",
+                                            "Instructions replayed from the loop buffer",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::CycleCounter lsd_gated_cycles_{
+            &unit_stat_set_, "lsd_gated_cycles",
+            "Cycles the frontend was power-gated by the loop buffer",
+            sparta::Counter::COUNT_NORMAL, getClock()};
+        sparta::Counter lsd_flushes_{&unit_stat_set_, "lsd_flushes",
+                                     "Number of locked loops ended by a flush",
+                                     sparta::Counter::COUNT_NORMAL};
+
+        friend class LoopBufferTester;
+    };
+
+    class LoopBufferTester;
+} // namespace olympia
@@ -53,7 +53,18 @@ namespace olympia
         MAVIS_UID_VZEXTVF4,
         MAVIS_UID_VSEXTVF4,
         MAVIS_UID_VZEXTVF8,
-        MAVIS_UID_VSEXTVF8
+        MAVIS_UID_VSEXTVF8,
+        MAVIS_UID_XOR,
+        MAVIS_UID_SUB,
+        MAVIS_UID_SUBW,
+        MAVIS_UID_ADDI,
+        MAVIS_UID_ADDIW,
+        MAVIS_UID_ORI,
+        MAVIS_UID_XORI,
+        MAVIS_UID_LUI,
+        MAVIS_UID_C_LI,
+        MAVIS_UID_C_LUI,
+        MAVIS_UID_BNE
     };
 
     // This is a sparta tree node wrapper around the Mavis facade object
@@ -118,7 +129,18 @@ namespace olympia
             {"vzext.vf4", MAVIS_UID_VZEXTVF4},
             {"vsext.vf4", MAVIS_UID_VSEXTVF4},
             {"vzext.vf8", MAVIS_UID_VZEXTVF8},
-            {"vsext.vf8", MAVIS_UID_VSEXTVF8}
+            {"vsext.vf8", MAVIS_UID_VSEXTVF8},
+            {"xor",       MAVIS_UID_XOR},
+            {"sub",       MAVIS_UID_SUB},
+            {"subw",      MAVIS_UID_SUBW},
+            {"addi",      MAVIS_UID_ADDI},
+            {"addiw",     MAVIS_UID_ADDIW},
+            {"ori",       MAVIS_UID_ORI},
+            {"xori",      MAVIS_UID_XORI},
+            {"lui",       MAVIS_UID_LUI},
+            {"c.li",      MAVIS_UID_C_LI},
+            {"c.lui",     MAVIS_UID_C_LUI},
+            {"bne",       MAVIS_UID_BNE}
 	};
 
         const std::string          pseudo_file_path_; ///< Path to olympia pseudo ISA/uArch JSON files
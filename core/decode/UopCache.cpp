@@ -0,0 +1,168 @@
+// <UopCache.cpp> -*- C++ -*-
+
+#include "decode/UopCache.hpp"
+
+#include "sparta/utils/LogUtils.hpp"
+#include "sparta/utils/MathUtils.hpp"
+
+#include <algorithm>
+
+namespace olympia
+{
+    constexpr char UopCache::name[];
+
+    UopCache::UopCache(sparta::TreeNode* node, const UopCacheParameterSet* p) :
+        sparta::Unit(node),
+        enabled_(p->enable),
+        num_ways_(p->num_ways),
+        uops_per_entry_(p->uops_per_entry),
+        delivery_width_(p->delivery_width),
+        switch_penalty_(p->switch_penalty)
+    {
+        sparta_assert(num_ways_ > 0 && (p->num_entries % num_ways_) == 0,
+                      "uop_cache num_entries (" << p->num_entries
+                                                << ") must be a multiple of num_ways ("
+                                                << num_ways_ << ")");
+        const uint32_t num_sets = p->num_entries / num_ways_;
+        sparta_assert(sparta::utils::is_power_of_2(num_sets),
+                      "uop_cache num_entries/num_ways must be a power of 2");
+        sparta_assert(delivery_width_ > 0, "uop_cache delivery_width must be greater than 0");
+
+        sets_.resize(num_sets, UopCacheSet(num_ways_));
+    }
+
+    bool UopCache::lookup(sparta::memory::addr_t block_pc, const InstGroupPtr & fetch_group)
+    {
+        auto & set = getSet_(block_pc);
+        auto line = std::find_if(set.begin(), set.end(), [block_pc](const UopCacheLine & l)
+                                 { return l.valid && (l.tag == block_pc); });
+
+        // A fetch block ending before the cached one took another path
+        if ((line == set.end()) || (fetch_group->size() < line->num_insts))
+        {
+            ++uop_cache_misses_;
+            return false;
+        }
+
+        ++uop_cache_hits_;
+        line->lru_stamp = ++lru_clock_;
+
+        // The younger instructions are not in the line
+        fetch_group->erase(std::next(fetch_group->begin(), line->num_insts), fetch_group->end());
+
+        for (auto & inst : *fetch_group)
+        {
+            inst->setUopCacheHit(true);
+            for (const auto & fused : line->fused_status)
+            {
+                if (fused.pc == inst->getPC())
+                {
+                    inst->setExtendedStatus(fused.status);
+                    inst->setProgramIDIncrement(fused.program_id_increment);
+                    break;
+                }
+            }
+        }
+        ILOG("uop cache hit: 0x" << std::hex << block_pc);
+        return true;
+    }
+
+    void UopCache::fill(const std::vector<InstPtr> & block)
+    {
+        sparta_assert(!block.empty(), "Attempt to fill an empty block into the uop cache");
+
+        // Fusion ghosts do not take a uop slot.  A fusion group must be
+        // entirely inside of the block: the block can neither start with a
+        // ghost nor end inside of a fused group.
+        uint32_t num_uops = 0;
+        uint64_t fused_insts_left = 0;
+        bool split_fusion_group = false;
+        for (const auto & inst : block)
+        {
+            const auto status = inst->getExtendedStatus();
+            if (status == Inst::Status::FUSION_GHOST)
+            {
+                if (fused_insts_left == 0)
+                {
+                    split_fusion_group = true;
+                    break;
+                }
+                --fused_insts_left;
+                continue;
+            }
+            if (status == Inst::Status::FUSED)
+            {
+                fused_insts_left = inst->getProgramIDIncrement() - 1;
+            }
+            ++num_uops;
+        }
+        split_fusion_group = split_fusion_group || (fused_insts_left != 0);
+
+        const bool cacheable =
+            !split_fusion_group && (num_uops <= uops_per_entry_)
+            && std::none_of(block.begin(), block.end(),
+                            [](const InstPtr & inst) { return inst->isVector(); });
+        if (!cacheable)
+        {
+            ++uop_cache_uncacheable_;
+            return;
+        }
+
+        const sparta::memory::addr_t block_pc = block.front()->getPC();
+        auto & set = getSet_(block_pc);
+
+        // Refill of a block already present (e.g. after a flush) replaces it,
+        // otherwise pick an invalid way or the least recently used one
+        auto line = std::find_if(set.begin(), set.end(), [block_pc](const UopCacheLine & l)
+                                 { return l.valid && (l.tag == block_pc); });
+        if (line == set.end())
+        {
+            line = std::min_element(set.begin(), set.end(),
+                                    [](const UopCacheLine & lhs, const UopCacheLine & rhs)
+                                    {
+                                        if (lhs.valid != rhs.valid)
+                                        {
+                                            return !lhs.valid;
+                                        }
+                                        return lhs.lru_stamp < rhs.lru_stamp;
+                                    });
+            if (line->valid)
+            {
+                ++uop_cache_evictions_;
+            }
+        }
+
+        line->valid = true;
+        line->tag = block_pc;
+        line->lru_stamp = ++lru_clock_;
+        line->num_uops = num_uops;
+        line->num_insts = block.size();
+        line->fused_status.clear();
+        for (const auto & inst : block)
+        {
+            if (inst->getExtendedStatus() != Inst::Status::UNMOD)
+            {
+                line->fused_status.push_back({inst->getPC(), inst->getExtendedStatus(),
+                                              inst->getProgramIDIncrement()});
+            }
+        }
+
+        ++uop_cache_fills_;
+        ILOG("uop cache fill: 0x" << std::hex << block_pc << std::dec << " uops: "
+                                  << line->num_uops);
+    }
+
+    void UopCache::recordDelivery(uint32_t num_uops, bool from_uop_cache)
+    {
+        if (from_uop_cache)
+        {
+            uop_cache_uops_delivered_ += num_uops;
+            ++uop_cache_delivery_cycles_;
+        }
+        else
+        {
+            legacy_uops_delivered_ += num_uops;
+            ++legacy_delivery_cycles_;
+        }
+    }
+} // namespace olympia
@@ -0,0 +1,209 @@
+// <UopCache.hpp> -*- C++ -*-
+//! \file UopCache.hpp
+#pragma once
+
+#include "sparta/simulation/Unit.hpp"
+#include "sparta/simulation/TreeNode.hpp"
+#include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticDef.hpp"
+
+#include "Inst.hpp"
+#include "InstGroup.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace olympia
+{
+
+    /**
+     * @file UopCache.hpp
+     * @brief Decoded micro-op cache sitting beside the ICache/Decode path
+     *
+     * The uop cache holds the post-decode (and post-fusion) contents of
+     * fetch blocks, indexed by the PC of the first instruction of the
+     * block.  Fetch looks up the cache for every fetch block; on a hit
+     * the ICache is not accessed and the instructions held by the line
+     * are tagged as uop cache hits, the younger instructions of the fetch
+     * block are fetched from the ICache.  A fetch block shorter than the
+     * line (different path) misses.  Decode delivers the hits with the
+     * uop cache delivery width instead of num_to_decode and skips the
+     * decode and fusion work for them.  Blocks decoded by the legacy path
+     * are filled into the cache by Decode.
+     *
+     * Switching between the uop cache and the legacy decode path costs
+     * switch_penalty cycles in Decode, no instruction is decoded during
+     * the switch.
+     *
+     * Blocks containing vector instructions are never cached since their
+     * uop expansion depends on the dynamic vector configuration.  Fusion
+     * ghosts do not use uop cache capacity; blocks with a fusion group
+     * crossing the block boundary are not cached.
+     */
+    class UopCache : public sparta::Unit
+    {
+      public:
+        //! \brief Parameters for UopCache model
+        class UopCacheParameterSet : public sparta::ParameterSet
+        {
+          public:
+            UopCacheParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
+
+            PARAMETER(bool, enable, false, "Enable the decoded uop cache")
+            PARAMETER(uint32_t, num_entries, 256, "Number of uop cache lines (fetch blocks)")
+            PARAMETER(uint32_t, num_ways, 8, "Uop cache associativity")
+            PARAMETER(uint32_t, uops_per_entry, 6, "Maximum number of uops held by a line")
+            PARAMETER(uint32_t, delivery_width, 8, "Uops delivered per cycle on a uop cache hit")
+            PARAMETER(uint32_t, switch_penalty, 1,
+                      "Cycles lost switching between the uop cache and the legacy decoders")
+        };
+
+        /**
+         * @brief Constructor for UopCache
+         *
+         * @param node The node that represents (has a pointer to) the UopCache
+         * @param p The UopCache's parameter set
+         */
+        UopCache(sparta::TreeNode* node, const UopCacheParameterSet* p);
+
+        //! \brief Name of this resource. Required by sparta::UnitFactory
+        static constexpr char name[] = "uop_cache";
+
+        bool isEnabled() const { return enabled_; }
+
+        uint32_t getDeliveryWidth() const { return delivery_width_; }
+
+        uint32_t getSwitchPenalty() const { return switch_penalty_; }
+
+        //! \brief Would the fetch block starting at block_pc, num_insts
+        //!        instructions long, hit? (no side effects)
+        bool contains(sparta::memory::addr_t block_pc, uint32_t num_insts) const
+        {
+            const auto & set = getSet_(block_pc);
+            return std::any_of(set.begin(), set.end(),
+                               [block_pc, num_insts](const UopCacheLine & l) {
+                                   return l.valid && (l.tag == block_pc)
+                                          && (num_insts >= l.num_insts);
+                               });
+        }
+
+        //! \brief Look up the fetch block starting at block_pc
+        //!
+        //! On a hit the replacement state is updated, the fetch group is
+        //! trimmed to the instructions held by the line, tagged as
+        //! delivered by the uop cache and the fusion state recorded at
+        //! fill time is restored on the instructions.
+        bool lookup(sparta::memory::addr_t block_pc, const InstGroupPtr & fetch_group);
+
+        //! \brief Fill the decoded (and possibly fused) fetch block
+        void fill(const std::vector<InstPtr> & block);
+
+        //! \brief Record the uops sent downstream by Decode in one cycle
+        void recordDelivery(uint32_t num_uops, bool from_uop_cache);
+
+        //! \brief Record a switch between the uop cache and the legacy decoders
+        void recordSwitch()
+        {
+            ++uop_cache_switches_;
+            uop_cache_switch_penalty_cycles_ += switch_penalty_;
+        }
+
+      private:
+        struct UopCacheLine
+        {
+            bool valid = false;
+            sparta::memory::addr_t tag = 0;
+            uint64_t lru_stamp = 0;
+            uint32_t num_uops = 0;
+            // Instructions of the block, including the fusion ghosts
+            uint32_t num_insts = 0;
+            // Fusion state of the instructions in the block
+            struct FusedStatus
+            {
+                sparta::memory::addr_t pc;
+                Inst::Status status;
+                uint64_t program_id_increment;
+            };
+            std::vector<FusedStatus> fused_status;
+        };
+
+        using UopCacheSet = std::vector<UopCacheLine>;
+
+        uint32_t getSetIndex_(sparta::memory::addr_t block_pc) const
+        {
+            // Fetch blocks can start on any 2-byte boundary
+            return (block_pc >> 1) & (sets_.size() - 1);
+        }
+
+        UopCacheSet & getSet_(sparta::memory::addr_t block_pc)
+        {
+            return sets_[getSetIndex_(block_pc)];
+        }
+
+        const UopCacheSet & getSet_(sparta::memory::addr_t block_pc) const
+        {
+            return sets_[getSetIndex_(block_pc)];
+        }
+
+        const bool enabled_;
+        const uint32_t num_ways_;
+        const uint32_t uops_per_entry_;
+        const uint32_t delivery_width_;
+        const uint32_t switch_penalty_;
+
+        std::vector<UopCacheSet> sets_;
+        uint64_t lru_clock_ = 0;
+
+        sparta::Counter uop_cache_hits_{&unit_stat_set_, "uop_cache_hits",
+                                        "Number of fetch blocks that hit in the uop cache",
+                                        sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_misses_{&unit_stat_set_, "uop_cache_misses",
+                                          "Number of fetch blocks that missed in the uop cache",
+                                          sparta::Counter::COUNT_NORMAL};
+        sparta::StatisticDef uop_cache_hit_rate_{
+            &unit_stat_set_, "uop_cache_hit_rate", "Uop cache hit rate", &unit_stat_set_,
+            "uop_cache_hits/(uop_cache_hits + uop_cache_misses)"};
+        sparta::Counter uop_cache_fills_{&unit_stat_set_, "uop_cache_fills",
+                                         "Number of fetch blocks filled into the uop cache",
+                                         sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_evictions_{&unit_stat_set_, "uop_cache_evictions",
+                                             "Number of valid lines replaced by a fill",
+                                             sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_uncacheable_{
+            &unit_stat_set_, "uop_cache_uncacheable",
+            "Fetch blocks not filled (vector instructions, too many uops or split fusion groups)",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_switches_{
+            &unit_stat_set_, "uop_cache_switches",
+            "Number of switches between the uop cache and the legacy decoders",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_switch_penalty_cycles_{
+            &unit_stat_set_, "uop_cache_switch_penalty_cycles",
+            "Decode cycles lost to uop cache/legacy decoder switches",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_uops_delivered_{&unit_stat_set_, "uop_cache_uops_delivered",
+                                                  "Uops delivered by the uop cache",
+                                                  sparta::Counter::COUNT_NORMAL};
+        sparta::Counter uop_cache_delivery_cycles_{&unit_stat_set_, "uop_cache_delivery_cycles",
+                                                   "Cycles the uop cache delivered uops",
+                                                   sparta::Counter::COUNT_NORMAL};
+        sparta::Counter legacy_uops_delivered_{&unit_stat_set_, "legacy_uops_delivered",
+                                               "Uops delivered by the legacy decoders",
+                                               sparta::Counter::COUNT_NORMAL};
+        sparta::Counter legacy_delivery_cycles_{&unit_stat_set_, "legacy_delivery_cycles",
+                                                "Cycles the legacy decoders delivered uops",
+                                                sparta::Counter::COUNT_NORMAL};
+        sparta::StatisticDef uop_cache_bandwidth_{
+            &unit_stat_set_, "uop_cache_bandwidth", "Average uops per uop cache delivery cycle",
+            &unit_stat_set_, "uop_cache_uops_delivered/uop_cache_delivery_cycles"};
+        sparta::StatisticDef legacy_bandwidth_{
+            &unit_stat_set_, "legacy_bandwidth", "Average uops per legacy decode cycle",
+            &unit_stat_set_, "legacy_uops_delivered/legacy_delivery_cycles"};
+
+        friend class UopCacheTester;
+    };
+
+    class UopCacheTester;
+} // namespace olympia
@@ -0,0 +1,108 @@
+// <VsetPredictor.cpp> -*- C++ -*-
+
+#include "decode/VsetPredictor.hpp"
+
+#include "sparta/utils/LogUtils.hpp"
+#include "sparta/utils/MathUtils.hpp"
+
+namespace olympia
+{
+    constexpr char VsetPredictor::name[];
+
+    VsetPredictor::VsetPredictor(sparta::TreeNode* node, const VsetPredictorParameterSet* p) :
+        sparta::Unit(node),
+        enabled_(p->enable),
+        table_(p->num_entries)
+    {
+        sparta_assert(sparta::utils::is_power_of_2(p->num_entries),
+                      "vset_predictor num_entries must be a power of 2");
+    }
+
+    VectorConfigPtr VsetPredictor::predict(const InstPtr & inst)
+    {
+        const auto & entry = getEntry_(inst->getPC());
+        if (!entry.valid || (entry.pc != inst->getPC()))
+        {
+            ++vset_pred_misses_;
+            return nullptr;
+        }
+
+        ++vset_pred_predictions_;
+        VectorConfigPtr predicted(new VectorConfig(entry.vl, entry.sew, entry.lmul, entry.vta,
+                                                   inst->getVectorConfig()->getVLEN()));
+
+        // The model knows the configuration the vset will produce, the
+        // misprediction is acted upon when the vset retires
+        const VectorConfigPtr & actual = inst->getVectorConfig();
+        if ((actual->getVL() != entry.vl) || (actual->getSEW() != entry.sew)
+            || (actual->getLMUL() != entry.lmul) || (actual->getVTA() != entry.vta))
+        {
+            inst->setMispredicted();
+        }
+        inst->setPredictedVSET(true);
+        predicted_vsets_[inst->getUniqueID()] = getClock()->currentCycle();
+
+        ILOG("Predicted " << predicted << " for " << inst
+                          << (inst->isMispredicted() ? " (mispredicted)" : ""));
+        return predicted;
+    }
+
+    void VsetPredictor::update(const InstPtr & inst)
+    {
+        const VectorConfigPtr & config = inst->getVectorConfig();
+        auto & entry = getEntry_(inst->getPC());
+        entry.valid = true;
+        entry.pc = inst->getPC();
+        entry.vl = config->getVL();
+        entry.sew = config->getSEW();
+        entry.lmul = config->getLMUL();
+        entry.vta = config->getVTA();
+
+        if (!inst->isPredictedVSET())
+        {
+            return;
+        }
+
+        const auto predicted_vset = predicted_vsets_.find(inst->getUniqueID());
+        if (inst->isMispredicted())
+        {
+            ++vset_pred_mispredicts_;
+        }
+        else
+        {
+            ++vset_pred_correct_;
+
+            // Decode would have stalled from the decode of the vset until now.
+            // A misprediction saves nothing, the younger instructions are
+            // flushed and decoded again
+            if (predicted_vset != predicted_vsets_.end())
+            {
+                vset_pred_stall_cycles_saved_ +=
+                    getClock()->currentCycle() - predicted_vset->second;
+            }
+        }
+
+        if (predicted_vset != predicted_vsets_.end())
+        {
+            predicted_vsets_.erase(predicted_vset);
+        }
+    }
+
+    void VsetPredictor::handleFlush(const FlushManager::FlushingCriteria & criteria)
+    {
+        const uint64_t flush_uid = criteria.getInstPtr()->getUniqueID();
+        for (auto it = predicted_vsets_.begin(); it != predicted_vsets_.end();)
+        {
+            const bool flushed =
+                criteria.isInclusiveFlush() ? (it->first >= flush_uid) : (it->first > flush_uid);
+            if (flushed)
+            {
+                it = predicted_vsets_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+} // namespace olympia
@@ -0,0 +1,125 @@
+// <VsetPredictor.hpp> -*- C++ -*-
+//! \file VsetPredictor.hpp
+#pragma once
+
+#include "sparta/simulation/Unit.hpp"
+#include "sparta/simulation/TreeNode.hpp"
+#include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticDef.hpp"
+
+#include "FlushManager.hpp"
+#include "Inst.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace olympia
+{
+
+    /**
+     * @file VsetPredictor.hpp
+     * @brief Vector configuration (VL/VTYPE) predictor
+     *
+     * A vsetvl or vsetvli whose AVL comes from a register stalls Decode
+     * until it executes.  With the predictor, Decode looks up the PC of
+     * the vset in a direct-mapped, tagged table of the last vector
+     * configuration it produced and keeps decoding with the predicted
+     * configuration.  The vset only stalls Decode on a table miss.
+     *
+     * A wrong prediction marks the vset as mispredicted: like a
+     * mispredicted branch, the ROB flushes the instructions after it when
+     * it retires, and Decode restarts from the vset's configuration.
+     *
+     * The table is trained with the configuration of every register
+     * dependent vset when it executes.
+     */
+    class VsetPredictor : public sparta::Unit
+    {
+      public:
+        //! \brief Parameters for VsetPredictor model
+        class VsetPredictorParameterSet : public sparta::ParameterSet
+        {
+          public:
+            VsetPredictorParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
+
+            PARAMETER(bool, enable, false, "Enable the vector configuration predictor")
+            PARAMETER(uint32_t, num_entries, 64, "Number of entries of the prediction table")
+        };
+
+        /**
+         * @brief Constructor for VsetPredictor
+         *
+         * @param node The node that represents (has a pointer to) the VsetPredictor
+         * @param p The VsetPredictor's parameter set
+         */
+        VsetPredictor(sparta::TreeNode* node, const VsetPredictorParameterSet* p);
+
+        //! \brief Name of this resource. Required by sparta::UnitFactory
+        static constexpr char name[] = "vset_predictor";
+
+        bool isEnabled() const { return enabled_; }
+
+        //! \brief Predict the configuration produced by a register dependent vset
+        //!
+        //! Returns nullptr when there is no prediction.  Otherwise the vset
+        //! is marked as predicted, and as mispredicted if the prediction does
+        //! not match its configuration.
+        VectorConfigPtr predict(const InstPtr & inst);
+
+        //! \brief Train the table with an executed vset and score its prediction
+        void update(const InstPtr & inst);
+
+        //! \brief Forget the predicted vsets removed by a flush
+        void handleFlush(const FlushManager::FlushingCriteria & criteria);
+
+      private:
+        struct VsetPredictorEntry
+        {
+            bool valid = false;
+            sparta::memory::addr_t pc = 0;
+            uint32_t vl = 0;
+            uint32_t sew = 0;
+            uint32_t lmul = 0;
+            uint32_t vta = 0;
+        };
+
+        VsetPredictorEntry & getEntry_(sparta::memory::addr_t pc)
+        {
+            // vsets are 4-byte instructions
+            return table_[(pc >> 2) & (table_.size() - 1)];
+        }
+
+        const bool enabled_;
+        std::vector<VsetPredictorEntry> table_;
+
+        // Decode cycle of the predicted vsets in flight, by unique ID
+        std::unordered_map<uint64_t, uint64_t> predicted_vsets_;
+
+        sparta::Counter vset_pred_predictions_{
+            &unit_stat_set_, "vset_pred_predictions",
+            "Register dependent vsets decoded with a predicted configuration",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vset_pred_misses_{&unit_stat_set_, "vset_pred_misses",
+                                          "Register dependent vsets without a prediction",
+                                          sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vset_pred_correct_{&unit_stat_set_, "vset_pred_correct",
+                                           "Executed vsets that were correctly predicted",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vset_pred_mispredicts_{&unit_stat_set_, "vset_pred_mispredicts",
+                                               "Executed vsets that were mispredicted",
+                                               sparta::Counter::COUNT_NORMAL};
+        sparta::StatisticDef vset_pred_accuracy_{
+            &unit_stat_set_, "vset_pred_accuracy", "Vector configuration prediction accuracy",
+            &unit_stat_set_, "vset_pred_correct/(vset_pred_correct + vset_pred_mispredicts)"};
+        sparta::Counter vset_pred_stall_cycles_saved_{
+            &unit_stat_set_, "vset_pred_stall_cycles_saved",
+            "Decode stall cycles avoided by predicting vsets (decode to execute)",
+            sparta::Counter::COUNT_NORMAL};
+
+        friend class VsetPredictorTester;
+    };
+
+    class VsetPredictorTester;
+} // namespace olympia
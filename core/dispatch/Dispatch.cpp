@@ -1,6 +1,7 @@
 // <Dispatch.cpp> -*- C++ -*-
 
 #include <algorithm>
+#include <limits>
 #include "CoreUtils.hpp"
 #include "dispatch/Dispatch.hpp"
 #include "sparta/events/StartupEvent.hpp"
@@ -14,6 +15,7 @@ namespace olympia
         sparta::Unit(node),
         dispatch_queue_("dispatch_queue", p->dispatch_queue_depth, node->getClock(),
                         getStatisticSet()),
+        steering_policy_(SteeringPolicy::create(p->steering_policy, node->getClock())),
         num_to_dispatch_(p->num_to_dispatch),
         dispatch_queue_depth_(p->dispatch_queue_depth)
     {
@@ -80,6 +82,10 @@ namespace olympia
                     &unit_port_set_, "out_" + iq_name + "_write"));
             std::shared_ptr<Dispatcher> dispatcher = std::make_shared<Dispatcher>(
                 iq_name, this, info_logger_, in_credit_port.get(), out_inst_port.get());
+            auto & iq_insts = iq_insts_.emplace_back(new sparta::Counter(
+                getStatisticSet(), "count_" + iq_name + "_insts",
+                "Instructions dispatched to " + iq_name, sparta::Counter::COUNT_NORMAL));
+            dispatcher->setInstCounter(iq_insts.get());
 
             // store in dispatchers_ which issue queues map to which pipe target
             const auto pipe_target_start = std::stoi(iq[0]);
@@ -119,6 +125,22 @@ namespace olympia
             new Dispatcher("lsu", this, info_logger_, &in_lsu_credits_, &out_lsu_write_));
         in_lsu_credits_.enableCollection(node);
 
+        // Vector loads/stores go to the VLSU, unless an execution pipe
+        // handles them
+        vlsu_dispatcher_ = std::make_shared<Dispatcher>("vlsu", this, info_logger_,
+                                                        &in_vlsu_credits_, &out_vlsu_write_);
+        in_vlsu_credits_.enableCollection(node);
+        for (const auto tgt_pipe :
+             {InstArchInfo::TargetPipe::VLOAD, InstArchInfo::TargetPipe::VSTORE})
+        {
+            auto & dispatchers = dispatchers_[static_cast<size_t>(tgt_pipe)];
+            if (dispatchers.empty())
+            {
+                ILOG("mapping target: " << tgt_pipe << vlsu_dispatcher_->getName());
+                dispatchers.emplace_back(vlsu_dispatcher_);
+            }
+        }
+
         in_reorder_credits_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(Dispatch, robCredits_, uint32_t));
         in_reorder_credits_.enableCollection(node);
@@ -242,23 +264,26 @@ namespace olympia
                                  "pipe. Did you define it in the yaml properly?");
             // so we have a map here that checks for which valid dispatchers for that
             // instruction target pipe map needs to be: "int": [exe0, exe1, exe2]
-            if (target_pipe != InstArchInfo::TargetPipe::LSU)
+            if (ex_inst.isTargetROB())
             {
-                uint32_t max_credits = 0;
-                olympia::Dispatcher* best_dispatcher = nullptr;
-                // find the dispatcher with the most amount of credits, i.e the issue queue with
-                // the least amount of entries
-                for (auto & dispatcher_iq : dispatchers)
-                {
-                    if (dispatcher_iq->canAccept() && dispatcher_iq->getCredits() > max_credits)
-                    {
-                        best_dispatcher = dispatcher_iq.get();
-                        max_credits = dispatcher_iq->getCredits();
-                    }
-                }
+                // Eliminated at rename (moves, idioms): only needs a ROB entry
+                ++unit_distribution_[InstArchInfo::TargetPipe::ROB];
+                ++unit_distribution_context_.context(InstArchInfo::TargetPipe::ROB);
+                ++weighted_unit_distribution_context_.context(InstArchInfo::TargetPipe::ROB);
+
+                ex_inst_ptr->setStatus(Inst::Status::COMPLETED);
+                ILOG("Completing eliminated instruction: " << ex_inst_ptr);
+                dispatched = true;
+            }
+            else if (target_pipe != InstArchInfo::TargetPipe::LSU)
+            {
+                olympia::Dispatcher* best_dispatcher =
+                    steering_policy_->selectDispatcher(ex_inst_ptr, dispatchers);
                 if (best_dispatcher != nullptr)
                 {
+                    recordSteering_(best_dispatcher, dispatchers);
                     best_dispatcher->acceptInst(ex_inst_ptr);
+                    steering_policy_->instDispatched(ex_inst_ptr, best_dispatcher);
                     ++unit_distribution_[target_pipe];
                     ++unit_distribution_context_.context(target_pipe);
                     ++weighted_unit_distribution_context_.context(target_pipe);
@@ -277,6 +302,7 @@ namespace olympia
                     if (disp->canAccept())
                     {
                         disp->acceptInst(ex_inst_ptr);
+                        steering_policy_->instDispatched(ex_inst_ptr, disp.get());
                         ++unit_distribution_[target_pipe];
                         ++(unit_distribution_context_.context(target_pipe));
                         ++(weighted_unit_distribution_context_.context(target_pipe));
@@ -334,12 +360,37 @@ namespace olympia
         stall_counters_[current_stall_].startCounting();
     }
 
+    void Dispatch::recordSteering_(const Dispatcher* selected,
+                                   const SteeringPolicy::Dispatchers & dispatchers)
+    {
+        if (dispatchers.size() < 2)
+        {
+            return;
+        }
+        uint32_t min_credits = std::numeric_limits<uint32_t>::max();
+        uint32_t max_credits = 0;
+        for (const auto & disp : dispatchers)
+        {
+            if (disp->canAccept())
+            {
+                min_credits = std::min(min_credits, disp->getCredits());
+                max_credits = std::max(max_credits, disp->getCredits());
+            }
+        }
+        iq_credit_imbalance_.addValue(max_credits - min_credits);
+        if (selected->getCredits() < max_credits)
+        {
+            ++steered_to_fuller_iq_;
+        }
+    }
+
     void Dispatch::handleFlush_(const FlushManager::FlushingCriteria & criteria)
     {
         ILOG("Got a flush call for " << criteria);
         out_dispatch_queue_credits_.send(dispatch_queue_.size());
         dispatch_queue_.clear();
         out_reorder_write_.cancel();
+        steering_policy_->flush();
     }
 
     void Dispatch::dumpDebugContent_(std::ostream & output) const
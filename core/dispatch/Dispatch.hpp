@@ -15,9 +15,11 @@
 #include "sparta/statistics/Counter.hpp"
 #include "sparta/statistics/ContextCounter.hpp"
 #include "sparta/statistics/WeightedContextCounter.hpp"
+#include "sparta/statistics/BasicHistogram.hpp"
 #include "sparta/simulation/ResourceFactory.hpp"
 
 #include "dispatch/Dispatcher.hpp"
+#include "dispatch/SteeringPolicy.hpp"
 #include "CoreTypes.hpp"
 #include "InstGroup.hpp"
 #include "FlushManager.hpp"
@@ -46,6 +48,9 @@ namespace olympia
             PARAMETER(uint32_t, dispatch_queue_depth, 10, "Depth of the dispatch buffer")
             PARAMETER(std::vector<double>, context_weights, std::vector<double>(1, 1),
                       "Relative weight of each context")
+            PARAMETER(std::string, steering_policy, "least_loaded",
+                      "Issue queue steering when several issue queues handle a target pipe: "
+                      "least_loaded, round_robin, dependency or critical_path")
         };
 
         /**
@@ -86,6 +91,10 @@ namespace olympia
                                                      sparta::SchedulingPhase::Tick, 0};
         sparta::DataOutPort<InstQueue::value_type> out_lsu_write_{&unit_port_set_, "out_lsu_write",
                                                                   false};
+        sparta::DataInPort<uint32_t> in_vlsu_credits_{&unit_port_set_, "in_vlsu_credits",
+                                                      sparta::SchedulingPhase::Tick, 0};
+        sparta::DataOutPort<InstQueue::value_type> out_vlsu_write_{&unit_port_set_,
+                                                                   "out_vlsu_write", false};
         sparta::DataInPort<uint32_t> in_reorder_credits_{
             &unit_port_set_, "in_reorder_buffer_credits", sparta::SchedulingPhase::Tick, 0};
         sparta::DataOutPort<InstGroupPtr> out_reorder_write_{&unit_port_set_,
@@ -93,8 +102,13 @@ namespace olympia
 
         std::array<std::vector<std::shared_ptr<Dispatcher>>, InstArchInfo::N_TARGET_PIPES>
             dispatchers_;
+        // Used for the vector loads/stores when no execution pipe handles them
+        std::shared_ptr<Dispatcher> vlsu_dispatcher_;
         InstArchInfo::TargetPipe blocking_dispatcher_ = InstArchInfo::TargetPipe::UNKNOWN;
 
+        // Chooses the issue queue of the instructions
+        std::unique_ptr<SteeringPolicy> steering_policy_;
+
         // For flush
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
             &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
@@ -117,6 +131,8 @@ namespace olympia
         // Dispatch instructions
         void dispatchQueueAppended_(const InstGroupPtr &);
         void dispatchInstructions_();
+        void recordSteering_(const Dispatcher* selected,
+                             const SteeringPolicy::Dispatchers & dispatchers);
 
         // Flush notifications
         void handleFlush_(const FlushManager::FlushingCriteria & criteria);
@@ -314,6 +330,19 @@ namespace olympia
             "dispatch_int_inst_count",
             sparta::CounterBase::COUNT_NORMAL,
             sparta::InstrumentationNode::VIS_NORMAL};
+        // Issue queue balance: the instructions dispatched to each issue
+        // queue, and at each steering decision the credit difference
+        // between the issue queues that could take the instruction
+        std::vector<std::unique_ptr<sparta::Counter>> iq_insts_;
+        sparta::BasicHistogram<uint32_t> iq_credit_imbalance_{
+            *getStatisticSet(), "iq_credit_imbalance",
+            "Credit difference between the most and least loaded candidate issue queues",
+            {0, 1, 2, 4, 8, 16, 32}};
+        sparta::Counter steered_to_fuller_iq_{getStatisticSet(), "steered_to_fuller_iq",
+                                              "Instructions steered to an issue queue with fewer "
+                                              "credits than another candidate",
+                                              sparta::Counter::COUNT_NORMAL};
+
         sparta::StatisticDef total_insts_{
             getStatisticSet(), "count_total_insts_dispatched",
             "Total number of instructions dispatched", getStatisticSet(),
@@ -7,6 +7,7 @@
 
 #include "sparta/ports/DataPort.hpp"
 #include "sparta/log/MessageSource.hpp"
+#include "sparta/statistics/Counter.hpp"
 #include "sparta/utils/LogUtils.hpp"
 
 #include "Inst.hpp"
@@ -65,8 +66,15 @@ namespace olympia
             out_inst_->send(inst);
             --unit_credits_;
             --num_can_dispatch_;
+            if (inst_counter_ != nullptr)
+            {
+                ++(*inst_counter_);
+            }
         }
 
+        // Count the instructions sent through this dispatcher
+        void setInstCounter(sparta::Counter* inst_counter) { inst_counter_ = inst_counter; }
+
         // Reset the bandwidth
         void reset() { num_can_dispatch_ = 1; }
 
@@ -75,6 +83,7 @@ namespace olympia
     private:
         uint32_t unit_credits_ = 0;
         uint32_t num_can_dispatch_ = 1;
+        sparta::Counter            * inst_counter_ = nullptr;
 
         const std::string            name_;
         Dispatch                   * dispatch_ = nullptr;
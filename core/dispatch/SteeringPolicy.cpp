@@ -0,0 +1,190 @@
+// <SteeringPolicy.cpp> -*- C++ -*-
+
+#include "dispatch/SteeringPolicy.hpp"
+
+#include <algorithm>
+
+#include "sparta/utils/SpartaException.hpp"
+
+namespace olympia
+{
+    std::unique_ptr<SteeringPolicy> SteeringPolicy::create(const std::string & policy_name,
+                                                           const sparta::Clock* clk)
+    {
+        if (policy_name == "least_loaded")
+        {
+            return std::make_unique<LeastLoadedSteering>();
+        }
+        else if (policy_name == "round_robin")
+        {
+            return std::make_unique<RoundRobinSteering>();
+        }
+        else if (policy_name == "dependency")
+        {
+            return std::make_unique<DependencySteering>(clk);
+        }
+        else if (policy_name == "critical_path")
+        {
+            return std::make_unique<CriticalPathSteering>(clk);
+        }
+        throw sparta::SpartaException("Unknown steering policy: ")
+            << policy_name
+            << ". Supported policies are: least_loaded, round_robin, dependency, critical_path";
+    }
+
+    Dispatcher* SteeringPolicy::selectLeastLoaded_(const Dispatchers & dispatchers)
+    {
+        uint32_t max_credits = 0;
+        Dispatcher* best_dispatcher = nullptr;
+        // find the dispatcher with the most amount of credits, i.e the issue queue with
+        // the least amount of entries
+        for (auto & dispatcher_iq : dispatchers)
+        {
+            if (dispatcher_iq->canAccept() && dispatcher_iq->getCredits() > max_credits)
+            {
+                best_dispatcher = dispatcher_iq.get();
+                max_credits = dispatcher_iq->getCredits();
+            }
+        }
+        return best_dispatcher;
+    }
+
+    Dispatcher* LeastLoadedSteering::selectDispatcher(const InstPtr &,
+                                                      const Dispatchers & dispatchers)
+    {
+        return selectLeastLoaded_(dispatchers);
+    }
+
+    Dispatcher* RoundRobinSteering::selectDispatcher(const InstPtr & inst,
+                                                     const Dispatchers & dispatchers)
+    {
+        auto & next = next_dispatcher_[static_cast<size_t>(inst->getPipe())];
+        for (uint32_t i = 0; i < dispatchers.size(); ++i)
+        {
+            const uint32_t idx = (next + i) % dispatchers.size();
+            if (dispatchers[idx]->canAccept())
+            {
+                next = idx + 1;
+                return dispatchers[idx].get();
+            }
+        }
+        return nullptr;
+    }
+
+    Dispatcher* DependencySteering::selectDispatcher(const InstPtr & inst,
+                                                     const Dispatchers & dispatchers)
+    {
+        if (Dispatcher* producer = selectProducer_(inst, dispatchers); producer != nullptr)
+        {
+            return producer;
+        }
+        return selectLeastLoaded_(dispatchers);
+    }
+
+    Dispatcher* DependencySteering::selectProducer_(const InstPtr & inst,
+                                                    const Dispatchers & dispatchers) const
+    {
+        // The producer finishing last, the other sources are more likely
+        // to be ready when the instruction issues.  The producers whose
+        // result is already out do not hold the instruction back
+        Dispatcher* selected = nullptr;
+        uint64_t selected_ready_cycle = clk_->currentCycle();
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & src :
+                 inst->getRenameData().getSourceList(static_cast<core_types::RegFile>(rf)))
+            {
+                if (src.phys_reg >= producers_[rf].size())
+                {
+                    continue;
+                }
+                const Producer & producer = producers_[rf][src.phys_reg];
+                if (producer.ready_cycle <= selected_ready_cycle)
+                {
+                    continue;
+                }
+                const auto disp = std::find_if(dispatchers.begin(), dispatchers.end(),
+                                               [&producer](const auto & dispatcher)
+                                               { return dispatcher.get() == producer.dispatcher; });
+                if ((disp != dispatchers.end()) && (*disp)->canAccept())
+                {
+                    selected = disp->get();
+                    selected_ready_cycle = producer.ready_cycle;
+                }
+            }
+        }
+        return selected;
+    }
+
+    uint64_t DependencySteering::getChainLength_(const InstPtr & inst) const
+    {
+        const uint64_t curr_cycle = clk_->currentCycle();
+        uint64_t sources_ready_cycle = curr_cycle;
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & src :
+                 inst->getRenameData().getSourceList(static_cast<core_types::RegFile>(rf)))
+            {
+                if (src.phys_reg < producers_[rf].size())
+                {
+                    sources_ready_cycle =
+                        std::max(sources_ready_cycle, producers_[rf][src.phys_reg].ready_cycle);
+                }
+            }
+        }
+        return (sources_ready_cycle - curr_cycle) + inst->getExecuteTime();
+    }
+
+    void DependencySteering::instDispatched(const InstPtr & inst, const Dispatcher* dispatcher)
+    {
+        const uint64_t ready_cycle = clk_->currentCycle() + getChainLength_(inst);
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & dest :
+                 inst->getRenameData().getDestList(static_cast<core_types::RegFile>(rf)))
+            {
+                if (dest.phys_reg >= producers_[rf].size())
+                {
+                    producers_[rf].resize(dest.phys_reg + 1);
+                }
+                producers_[rf][dest.phys_reg] = {dispatcher, ready_cycle};
+            }
+        }
+    }
+
+    void DependencySteering::flush()
+    {
+        // The flushed producers will not write their PRFs, and the PRFs
+        // they had are given to other instructions
+        for (auto & producers : producers_)
+        {
+            producers.clear();
+        }
+    }
+
+    Dispatcher* CriticalPathSteering::selectDispatcher(const InstPtr & inst,
+                                                       const Dispatchers & dispatchers)
+    {
+        if ((getChainLength_(inst) << 4) > average_chain_length_)
+        {
+            // Critical: keep it with its producer, or send it where it can
+            // issue soonest
+            return DependencySteering::selectDispatcher(inst, dispatchers);
+        }
+        return round_robin_.selectDispatcher(inst, dispatchers);
+    }
+
+    void CriticalPathSteering::instDispatched(const InstPtr & inst, const Dispatcher* dispatcher)
+    {
+        // Moving average over the last 16 instructions
+        average_chain_length_ += getChainLength_(inst) - (average_chain_length_ >> 4);
+        DependencySteering::instDispatched(inst, dispatcher);
+    }
+
+    void CriticalPathSteering::flush()
+    {
+        // The chain lengths are measured again from the flush
+        average_chain_length_ = 0;
+        DependencySteering::flush();
+    }
+} // namespace olympia
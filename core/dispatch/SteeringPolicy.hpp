@@ -0,0 +1,132 @@
+// <SteeringPolicy.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sparta/simulation/Clock.hpp"
+
+#include "dispatch/Dispatcher.hpp"
+#include "CoreTypes.hpp"
+#include "Inst.hpp"
+#include "InstArchInfo.hpp"
+
+namespace olympia
+{
+    /*!
+     * \class SteeringPolicy
+     * \brief Chooses the issue queue of an instruction when several
+     *        issue queues handle its target pipe
+     *
+     * Policies, selected with the Dispatch steering_policy parameter:
+     * - least_loaded:  the issue queue with the most credits
+     * - round_robin:   the issue queues in turn, per target pipe
+     * - dependency:    the issue queue of a source producer, so the
+     *                  dependents stay in the producer's cluster
+     * - critical_path: dependency steering for the instructions on the
+     *                  longer in flight dependency chains, the others go
+     *                  round robin
+     */
+    class SteeringPolicy
+    {
+      public:
+        using Dispatchers = std::vector<std::shared_ptr<Dispatcher>>;
+
+        virtual ~SteeringPolicy() = default;
+
+        // The dispatcher to send the instruction to, nullptr if none of
+        // the dispatchers of its target pipe can accept it
+        virtual Dispatcher* selectDispatcher(const InstPtr & inst,
+                                             const Dispatchers & dispatchers) = 0;
+
+        // The instruction was sent to the dispatcher
+        virtual void instDispatched(const InstPtr &, const Dispatcher*) {}
+
+        // The instructions in flight were flushed
+        virtual void flush() {}
+
+        static std::unique_ptr<SteeringPolicy> create(const std::string & policy_name,
+                                                      const sparta::Clock* clk);
+
+      protected:
+        static Dispatcher* selectLeastLoaded_(const Dispatchers & dispatchers);
+    };
+
+    class LeastLoadedSteering : public SteeringPolicy
+    {
+      public:
+        Dispatcher* selectDispatcher(const InstPtr & inst,
+                                     const Dispatchers & dispatchers) override;
+    };
+
+    class RoundRobinSteering : public SteeringPolicy
+    {
+      public:
+        Dispatcher* selectDispatcher(const InstPtr & inst,
+                                     const Dispatchers & dispatchers) override;
+
+      private:
+        // Per target pipe, the next dispatcher to try
+        std::array<uint32_t, InstArchInfo::N_TARGET_PIPES> next_dispatcher_{};
+    };
+
+    class DependencySteering : public SteeringPolicy
+    {
+      public:
+        explicit DependencySteering(const sparta::Clock* clk) : clk_(clk) {}
+
+        Dispatcher* selectDispatcher(const InstPtr & inst,
+                                     const Dispatchers & dispatchers) override;
+
+        void instDispatched(const InstPtr & inst, const Dispatcher* dispatcher) override;
+
+        void flush() override;
+
+      protected:
+        // A dispatcher of a source producer, with a result still to come,
+        // that can accept the instruction
+        Dispatcher* selectProducer_(const InstPtr & inst, const Dispatchers & dispatchers) const;
+
+        // Latency of the dependency chain ending with the instruction,
+        // counting only the producers that have not completed yet
+        uint64_t getChainLength_(const InstPtr & inst) const;
+
+      private:
+        struct Producer
+        {
+            const Dispatcher* dispatcher = nullptr;
+            // Estimated cycle of the result
+            uint64_t ready_cycle = 0;
+        };
+
+        const sparta::Clock* clk_;
+
+        // The last producer of each PRF
+        std::array<std::vector<Producer>, core_types::N_REGFILES> producers_;
+    };
+
+    class CriticalPathSteering : public DependencySteering
+    {
+      public:
+        explicit CriticalPathSteering(const sparta::Clock* clk) : DependencySteering(clk) {}
+
+        Dispatcher* selectDispatcher(const InstPtr & inst,
+                                     const Dispatchers & dispatchers) override;
+
+        void instDispatched(const InstPtr & inst, const Dispatcher* dispatcher) override;
+
+        void flush() override;
+
+      private:
+        // The instructions off the critical path are spread over the
+        // issue queues
+        RoundRobinSteering round_robin_;
+
+        // Running average of the chain lengths, the instructions with
+        // longer chains are critical.  Fixed point, 4 fractional bits
+        uint64_t average_chain_length_ = 0;
+    };
+} // namespace olympia
@@ -201,6 +201,14 @@ namespace olympia
                 }
             }
         }
+
+        // A vector consumer can issue to another pipe than its chained
+        // producer, all the pipes see the same chained writes
+        const auto chained_writes = std::make_shared<ExecutePipe::ChainedWrites>();
+        for (const auto & exe_pipe_tns : exe_pipe_tns_)
+        {
+            exe_pipe_tns->getResourceAs<olympia::ExecutePipe*>()->setChainedWrites(chained_writes);
+        }
     }
 
     void ExecuteFactory::deleteSubtree(sparta::ResourceTreeNode*)
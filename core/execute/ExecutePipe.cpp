@@ -3,8 +3,11 @@
 #include "execute/ExecutePipe.hpp"
 #include "CoreUtils.hpp"
 #include "sparta/utils/LogUtils.hpp"
+#include "sparta/utils/MathUtils.hpp"
 #include "sparta/utils/SpartaAssert.hpp"
 
+#include <algorithm>
+
 namespace olympia
 {
     const char ExecutePipe::name[] = "exe_pipe";
@@ -15,9 +18,24 @@ namespace olympia
         execute_time_(p->execute_time),
         enable_random_misprediction_(p->enable_random_misprediction && p->contains_branch_unit),
         issue_queue_name_(p->iq_name),
-        valu_adder_num_(p->valu_adder_num),
-        collected_inst_(node, node->getName())
+        dlen_(p->dlen),
+        pipelined_(p->pipelined),
+        enable_vector_chaining_(p->enable_vector_chaining),
+        vector_chaining_latency_(p->vector_chaining_latency),
+        early_out_div_(p->div_latency_model == "lzc"),
+        div_setup_latency_(p->div_setup_latency),
+        div_bits_per_cycle_(p->div_bits_per_cycle),
+        collected_inst_(node, node->getName()),
+        div_latency_histogram_(*getStatisticSet(), "div_latency_histogram",
+                               "Latency of the divides and square roots",
+                               {1, 2, 4, 8, 12, 16, 24, 32, 48, 64})
     {
+        sparta_assert((p->div_latency_model == "fixed") || early_out_div_,
+                      "Unknown div_latency_model: " << p->div_latency_model
+                                                    << ", expected fixed or lzc");
+        sparta_assert(div_bits_per_cycle_ > 0, "div_bits_per_cycle must be at least 1");
+        sparta_assert(sparta::utils::is_power_of_2(dlen_) && (dlen_ >= 64),
+                      "exe pipe dlen must be a power of 2, at least 64: " << dlen_);
         p->enable_random_misprediction.ignore();
         p->contains_branch_unit.ignore();
         in_reorder_flush_.registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(
@@ -53,121 +71,329 @@ namespace olympia
     // change to insertInst
     void ExecutePipe::insertInst(const InstPtr & ex_inst)
     {
-        if (num_passes_needed_ == 0)
+        // A replayed instruction was scheduled the first time it issued
+        if (ex_inst->getStatus() != Inst::Status::SCHEDULED)
         {
             ex_inst->setStatus(Inst::Status::SCHEDULED);
-            // we only need to check if unit_busy_ if instruction doesn't have multiple passes
-            // if it does need multiple passes, we need to keep unit_busy_ blocked so no instruction
-            // can get dispatched before the next pass begins
-            sparta_assert_context(
-                unit_busy_ == false,
-                "ExecutePipe is receiving a new instruction when it's already busy!!");
         }
+        sparta_assert_context(
+            unit_busy_ == false,
+            "ExecutePipe is receiving a new instruction when it's already busy!!");
 
         // Get instruction latency
         uint32_t exe_time = ignore_inst_execute_time_ ? execute_time_ : ex_inst->getExecuteTime();
+        sparta_assert(exe_time != 0);
+        if (ex_inst->getPipe() == InstArchInfo::TargetPipe::DIV)
+        {
+            if (early_out_div_)
+            {
+                exe_time = getDivideLatency_(ex_inst, exe_time);
+            }
+            div_latency_histogram_.addValue(exe_time);
+        }
 
+        // Initiation interval: 1 for a fully pipelined unit, the latency
+        // for an iterative one (e.g. divides and square roots)
+        const uint32_t occupancy = std::min(ex_inst->getOccupancy(), exe_time);
+
+        // A vector uop is executed in passes, each processing a DLEN wide group of elements.
+        // A pass occupies the unit for the occupancy of the instruction, the last pass
+        // completes after the instruction's latency.
+        uint32_t num_passes = 1;
+        uint32_t group_occupancy = occupancy;
+        uint32_t hold_time = 0;
         if (!ex_inst->isVset() && ex_inst->isVector())
         {
-            // have to factor in vlen, sew, valu length to calculate how many passes are needed
-            // i.e if VL = 256 and SEW = 8, but our VALU only has 8 64 bit adders, it will take 4
-            // passes to execute the entire instruction if we have an 8 bit number, the 64 bit adder
-            // will truncate, but we have each adder support the largest SEW possible
-            if (ex_inst->getPipe() == InstArchInfo::TargetPipe::VINT)
+            num_passes = getNumVectorPasses_(ex_inst);
+            vector_passes_ += num_passes;
+            if (ex_inst->getOccupancyScaling() == InstArchInfo::OccupancyScaling::LMUL)
             {
-                // First time seeing this uop, determine number of passes needed
-                if (num_passes_needed_ == 0)
-                {
-                    // The number of non-tail elements in the uop is used to determine how many
-                    // passes are needed
-                    const VectorConfigPtr & vector_config = ex_inst->getVectorConfig();
-                    const uint32_t num_elems_per_uop =
-                        vector_config->getVLMAX() / vector_config->getLMUL();
-                    const uint32_t num_elems_remaining =
-                        vector_config->getVL() - (num_elems_per_uop * (ex_inst->getUOpID() - 1));
-                    const uint32_t vl = std::min(num_elems_per_uop, num_elems_remaining);
-                    const uint32_t num_passes = std::ceil(vl / valu_adder_num_);
-                    if (num_passes > 1)
-                    {
-                        // only care about cases with multiple passes
-                        num_passes_needed_ = num_passes;
-                        curr_num_pass_ = 1;
-                        ILOG("Inst " << ex_inst << " needs " << num_passes_needed_
-                                     << " before completing the instruction, beginning pass: "
-                                     << curr_num_pass_);
-                    }
-                }
-                else
-                {
-                    curr_num_pass_++;
-                    sparta_assert(curr_num_pass_ <= num_passes_needed_,
-                                  "Instruction with multiple passes incremented for more than the "
-                                  "total number of passes needed for instruction: "
-                                      << ex_inst)
-                        ILOG("Inst: "
-                             << ex_inst << " beginning it's pass number: " << curr_num_pass_
-                             << " of the total required passes needed: " << num_passes_needed_);
-                }
+                // Every element group takes LMUL passes
+                group_occupancy *= ex_inst->getVectorConfig()->getLMUL();
             }
+            // The producers may be chained by another pipe
+            hold_time = getChainHoldTime_(ex_inst, group_occupancy);
         }
-        collected_inst_.collectWithDuration(ex_inst, exe_time);
-        ILOG("Executing: " << ex_inst << " for " << exe_time + getClock()->currentCycle());
-        sparta_assert(exe_time != 0);
+        const uint32_t complete_time = hold_time + (num_passes - 1) * occupancy + exe_time;
+        const uint32_t busy_time =
+            pipelined_ ? (hold_time + num_passes * occupancy) : complete_time;
+
+        // Consumers can start once the first element group is written, if
+        // that is before the whole uop completes
+        const uint32_t chain_time = hold_time + exe_time + vector_chaining_latency_;
+        if ((num_passes > 1) && enable_vector_chaining_ && (chain_time < complete_time))
+        {
+            chain_inst_.preparePayload(ex_inst)->schedule(chain_time);
+            const uint64_t complete_cycle = getClock()->currentCycle() + complete_time;
+            for (const auto & dest :
+                 ex_inst->getRenameData().getDestList(core_types::RegFile::RF_VECTOR))
+            {
+                (*chained_writes_)[dest.phys_reg] = {ex_inst, group_occupancy, complete_cycle};
+            }
+        }
+
+        collected_inst_.collectWithDuration(ex_inst, busy_time);
+        ILOG("Executing: " << ex_inst << " passes: " << num_passes << " busy until "
+                           << busy_time + getClock()->currentCycle() << " complete at "
+                           << complete_time + getClock()->currentCycle());
 
         unit_busy_ = true;
-        execute_inst_.preparePayload(ex_inst)->schedule(exe_time);
+        busy_inst_ = ex_inst;
+        ev_release_unit_.schedule(busy_time);
+        execute_inst_.preparePayload(ex_inst)->schedule(complete_time);
     }
 
-    // Called by the scheduler, scheduled by complete_inst_.
+    // Called by the scheduler, scheduled by insertInst.
+    void ExecutePipe::releaseUnit_()
+    {
+        unit_busy_ = false;
+        busy_inst_.reset();
+        // The issue queue can send the next instruction
+        out_execute_pipe_.send(1);
+    }
+
+    // Called by the scheduler, scheduled by insertInst.
     void ExecutePipe::executeInst_(const InstPtr & ex_inst)
     {
-        if (num_passes_needed_ != 0 && curr_num_pass_ < num_passes_needed_)
+        if (ex_inst->isSpeculativelyIssued())
         {
-            issue_inst_.preparePayload(ex_inst)->schedule(sparta::Clock::Cycle(0));
+            // The results can't be written before the load producer is known to hit
+            ILOG("Holding inst: " << ex_inst << " until its load producers hit");
+            spec_executed_insts_.emplace_back(ex_inst);
+            return;
         }
-        else
+        // The pipe writes back one result per cycle
+        completion_queue_.push_back(ex_inst);
+        ev_writeback_.schedule(sparta::Clock::Cycle(0));
+    }
+
+    // Called by the scheduler, scheduled by executeInst_.
+    void ExecutePipe::writebackInst_()
+    {
+        if (completion_queue_.empty())
         {
-            if (num_passes_needed_ != 0)
-            {
-                // reseting counters once vector instruction needing more than 1 pass
-                curr_num_pass_ = 0;
-                num_passes_needed_ = 0;
-            }
-            ILOG("Executed inst: " << ex_inst);
-            if (ex_inst->isVset() && ex_inst->isBlockingVSET())
+            return;
+        }
+        const uint64_t curr_cycle = getClock()->currentCycle();
+        if (curr_cycle == last_writeback_cycle_)
+        {
+            ev_writeback_.schedule(1);
+            return;
+        }
+        last_writeback_cycle_ = curr_cycle;
+
+        const InstPtr ex_inst = completion_queue_.front();
+        completion_queue_.pop_front();
+        if (false == completion_queue_.empty())
+        {
+            ++writeback_stall_cycles_;
+            ev_writeback_.schedule(1);
+        }
+
+        ILOG("Executed inst: " << ex_inst);
+        if (ex_inst->isVset() && (ex_inst->isBlockingVSET() || ex_inst->isPredictedVSET()))
+        {
+            // sending back VSET CSRs
+            const VectorConfigPtr & vector_config = ex_inst->getVectorConfig();
+            ILOG("Forwarding VSET CSRs back to decode, LMUL: "
+                 << vector_config->getLMUL() << " SEW: " << vector_config->getSEW()
+                 << " VTA: " << vector_config->getVTA() << " VL: " << vector_config->getVL());
+            out_vset_.send(ex_inst);
+        }
+
+        setDestRegistersReady_(ex_inst);
+
+        if (enable_random_misprediction_)
+        {
+            if (ex_inst->isBranch() && (std::rand() % 20) == 0)
             {
-                // sending back VSET CSRs
-                const VectorConfigPtr & vector_config = ex_inst->getVectorConfig();
-                ILOG("Forwarding VSET CSRs back to decode, LMUL: "
-                     << vector_config->getLMUL() << " SEW: " << vector_config->getSEW()
-                     << " VTA: " << vector_config->getVTA() << " VL: " << vector_config->getVL());
-                out_vset_.send(ex_inst);
+                ILOG("Randomly injecting a mispredicted branch: " << ex_inst);
+                ex_inst->setMispredicted();
             }
+        }
+
+        // Count the instruction as completely executed
+        ++total_insts_executed_;
 
-            for (auto reg_file = 0; reg_file < core_types::RegFile::N_REGFILES; ++reg_file)
+        // Schedule completion
+        complete_inst_.preparePayload(ex_inst)->schedule(1);
+    }
+
+    // Called by the scheduler, scheduled by insertInst on the first pass
+    void ExecutePipe::chainInst_(const InstPtr & ex_inst)
+    {
+        if (ex_inst->isSpeculativelyIssued())
+        {
+            spec_chained_insts_.emplace_back(ex_inst);
+            return;
+        }
+        ILOG("Chaining inst: " << ex_inst << " first element group written");
+        setDestRegistersReady_(ex_inst);
+        ++vector_chained_uops_;
+    }
+
+    uint32_t ExecutePipe::getNumVectorPasses_(const InstPtr & ex_inst) const
+    {
+        const auto scaling = ex_inst->getOccupancyScaling();
+        if (scaling == InstArchInfo::OccupancyScaling::NONE)
+        {
+            return 1;
+        }
+
+        // The number of non-tail elements in the uop is used to determine how many
+        // passes are needed
+        const VectorConfigPtr & vector_config = ex_inst->getVectorConfig();
+        const uint32_t sew = vector_config->getSEW();
+        const uint32_t vl = vector_config->getVL();
+        const uint32_t num_elems_per_uop = vector_config->getVLEN() / sew;
+        const uint32_t first_elem = num_elems_per_uop * ex_inst->getUOpID();
+        const uint32_t num_elems =
+            (first_elem < vl) ? std::min(num_elems_per_uop, vl - first_elem) : 0;
+        const uint32_t num_elems_per_pass = std::max(dlen_ / sew, 1u);
+        uint32_t num_passes =
+            std::max((num_elems + num_elems_per_pass - 1) / num_elems_per_pass, 1u);
+
+        // Each element group is combined with every source register of the group
+        if (scaling == InstArchInfo::OccupancyScaling::LMUL)
+        {
+            num_passes *= vector_config->getLMUL();
+        }
+        return num_passes;
+    }
+
+    uint32_t ExecutePipe::getDivideLatency_(const InstPtr & ex_inst,
+                                            const uint32_t worst_case) const
+    {
+        // Without the operand values from the trace, or the operand format
+        // from the uarch json, assume the worst case
+        const auto & values = ex_inst->getSourceValues();
+        const auto operands = ex_inst->getDivOperands();
+        if (values.empty() || (operands == InstArchInfo::DivOperands::NONE))
+        {
+            return worst_case;
+        }
+
+        uint32_t latency = worst_case;
+        switch (operands)
+        {
+            case InstArchInfo::DivOperands::FP16:
+            case InstArchInfo::DivOperands::FP32:
+            case InstArchInfo::DivOperands::FP64:
             {
-                const auto & dest_bits =
-                    ex_inst->getDestRegisterBitMask(static_cast<core_types::RegFile>(reg_file));
-                scoreboard_views_[reg_file]->setReady(dest_bits);
+                // Floating point: only zero, infinite and NaN operands end early.  The
+                // narrower values are NaN-boxed, only their low bits are used
+                const uint32_t exp_bits = (operands == InstArchInfo::DivOperands::FP16)   ? 5
+                                          : (operands == InstArchInfo::DivOperands::FP32) ? 8
+                                                                                          : 11;
+                const uint32_t mant_bits = (operands == InstArchInfo::DivOperands::FP16)   ? 10
+                                           : (operands == InstArchInfo::DivOperands::FP32) ? 23
+                                                                                           : 52;
+                auto is_special = [exp_bits, mant_bits](const uint64_t value) -> bool
+                {
+                    const uint64_t exp = (value >> mant_bits) & ((1ull << exp_bits) - 1);
+                    const uint64_t mant = value & ((1ull << mant_bits) - 1);
+                    return (exp == ((1ull << exp_bits) - 1)) || ((exp == 0) && (mant == 0));
+                };
+                if (std::any_of(values.begin(), values.end(), is_special))
+                {
+                    latency = div_setup_latency_;
+                }
+                break;
             }
-
-            if (enable_random_misprediction_)
+            case InstArchInfo::DivOperands::INT32:
+            case InstArchInfo::DivOperands::UINT32:
+            case InstArchInfo::DivOperands::INT64:
+            case InstArchInfo::DivOperands::UINT64:
             {
-                if (ex_inst->isBranch() && (std::rand() % 20) == 0)
+                if (values.size() < 2)
                 {
-                    ILOG("Randomly injecting a mispredicted branch: " << ex_inst);
-                    ex_inst->setMispredicted();
+                    break;
                 }
+                // Integer: one iteration per div_bits_per_cycle quotient bits,
+                // the quotient has as many bits as the dividend has more
+                // significant bits than the divisor
+                const bool is_word = (operands == InstArchInfo::DivOperands::INT32)
+                                     || (operands == InstArchInfo::DivOperands::UINT32);
+                const bool is_signed = (operands == InstArchInfo::DivOperands::INT32)
+                                       || (operands == InstArchInfo::DivOperands::INT64);
+                const uint64_t mask = is_word ? 0xffffffffull : ~0ull;
+                const uint32_t width = is_word ? 32 : 64;
+                auto magnitude = [mask, width, is_signed](uint64_t value) -> uint64_t
+                {
+                    value &= mask;
+                    if (is_signed && ((value >> (width - 1)) & 1))
+                    {
+                        value = (~value + 1) & mask;
+                    }
+                    return value;
+                };
+                const uint64_t dividend = magnitude(values[0]);
+                const uint64_t divisor = magnitude(values[1]);
+                uint32_t quotient_bits = 0;
+                if ((divisor != 0) && (dividend >= divisor))
+                {
+                    quotient_bits = __builtin_clzll(divisor) - __builtin_clzll(dividend) + 1;
+                }
+                const uint32_t iterations =
+                    (quotient_bits + div_bits_per_cycle_ - 1) / div_bits_per_cycle_;
+                latency = div_setup_latency_ + iterations;
+                break;
             }
+            default:
+                // Quad precision values don't fit the trace values
+                break;
+        }
+        return std::clamp(latency, 1u, worst_case);
+    }
 
-            // We're not busy anymore
-            unit_busy_ = false;
-
-            // Count the instruction as completely executed
-            ++total_insts_executed_;
+    uint32_t ExecutePipe::getChainHoldTime_(const InstPtr & ex_inst,
+                                            const uint32_t group_occupancy)
+    {
+        const uint64_t curr_cycle = getClock()->currentCycle();
+        uint64_t hold_until = curr_cycle;
+        uint64_t overlap_until = curr_cycle;
+        for (const auto & src :
+             ex_inst->getRenameData().getSourceList(core_types::RegFile::RF_VECTOR))
+        {
+            const auto it = chained_writes_->find(src.phys_reg);
+            if (it == chained_writes_->end())
+            {
+                continue;
+            }
+            if (it->second.complete_cycle <= curr_cycle)
+            {
+                chained_writes_->erase(it);
+                continue;
+            }
+            // Fewer cycles per element group than the producer: the consumer
+            // would catch up with it and read element groups not written yet
+            if (group_occupancy < it->second.group_occupancy)
+            {
+                hold_until = std::max(hold_until, it->second.complete_cycle);
+            }
+            else
+            {
+                overlap_until = std::max(overlap_until, it->second.complete_cycle);
+            }
+        }
+        if (hold_until > curr_cycle)
+        {
+            ILOG("Holding " << ex_inst << " until its chained producers complete at "
+                            << hold_until);
+            ++vector_chain_holds_;
+            return hold_until - curr_cycle;
+        }
+        vector_chain_overlap_cycles_ += overlap_until - curr_cycle;
+        return 0;
+    }
 
-            // Schedule completion
-            complete_inst_.preparePayload(ex_inst)->schedule(1);
+    void ExecutePipe::setDestRegistersReady_(const InstPtr & ex_inst)
+    {
+        for (auto reg_file = 0; reg_file < core_types::RegFile::N_REGFILES; ++reg_file)
+        {
+            const auto & dest_bits =
+                ex_inst->getDestRegisterBitMask(static_cast<core_types::RegFile>(reg_file));
+            scoreboard_views_[reg_file]->setReady(dest_bits);
         }
     }
 
@@ -177,7 +403,58 @@ namespace olympia
         ex_inst->setStatus(Inst::Status::COMPLETED);
         complete_event_.collect(*ex_inst);
         ILOG("Completing inst: " << ex_inst);
-        out_execute_pipe_.send(1);
+    }
+
+    // Called by the issue queue when the last load producer of the instruction hits.
+    void ExecutePipe::confirmInst(const InstPtr & ex_inst)
+    {
+        // Instructions still executing run the rest of their latency, the
+        // held ones write their results now
+        if (const auto it =
+                std::find(spec_chained_insts_.begin(), spec_chained_insts_.end(), ex_inst);
+            it != spec_chained_insts_.end())
+        {
+            spec_chained_insts_.erase(it);
+            chain_inst_.preparePayload(ex_inst)->schedule(sparta::Clock::Cycle(0));
+        }
+        if (const auto it =
+                std::find(spec_executed_insts_.begin(), spec_executed_insts_.end(), ex_inst);
+            it != spec_executed_insts_.end())
+        {
+            spec_executed_insts_.erase(it);
+            completion_queue_.push_back(ex_inst);
+            ev_writeback_.schedule(sparta::Clock::Cycle(0));
+        }
+    }
+
+    void ExecutePipe::cancelInst(const InstPtr & ex_inst)
+    {
+        ILOG("Cancelling inst: " << ex_inst);
+        auto cancel = [ex_inst](const InstPtr & inst) -> bool { return inst == ex_inst; };
+        execute_inst_.cancelIf(cancel);
+        chain_inst_.cancelIf(cancel);
+        spec_executed_insts_.erase(
+            std::remove(spec_executed_insts_.begin(), spec_executed_insts_.end(), ex_inst),
+            spec_executed_insts_.end());
+        spec_chained_insts_.erase(
+            std::remove(spec_chained_insts_.begin(), spec_chained_insts_.end(), ex_inst),
+            spec_chained_insts_.end());
+        for (const auto & dest :
+             ex_inst->getRenameData().getDestList(core_types::RegFile::RF_VECTOR))
+        {
+            if (const auto it = chained_writes_->find(dest.phys_reg);
+                (it != chained_writes_->end()) && (it->second.producer == ex_inst))
+            {
+                chained_writes_->erase(it);
+            }
+        }
+        if (busy_inst_ == ex_inst)
+        {
+            ev_release_unit_.cancel();
+            unit_busy_ = false;
+            busy_inst_.reset();
+            collected_inst_.closeRecord();
+        }
     }
 
     void ExecutePipe::flushInst_(const FlushManager::FlushingCriteria & criteria)
@@ -187,12 +464,27 @@ namespace olympia
         // instructions on their way to issue
         auto flush = [criteria](const InstPtr & inst) -> bool
         { return criteria.includedInFlush(inst); };
-        issue_inst_.cancel();
         complete_inst_.cancelIf(flush);
         execute_inst_.cancelIf(flush);
-        if (execute_inst_.getNumOutstandingEvents() == 0)
+        chain_inst_.cancelIf(flush);
+        completion_queue_.erase(
+            std::remove_if(completion_queue_.begin(), completion_queue_.end(), flush),
+            completion_queue_.end());
+        spec_executed_insts_.erase(
+            std::remove_if(spec_executed_insts_.begin(), spec_executed_insts_.end(), flush),
+            spec_executed_insts_.end());
+        spec_chained_insts_.erase(
+            std::remove_if(spec_chained_insts_.begin(), spec_chained_insts_.end(), flush),
+            spec_chained_insts_.end());
+        for (auto it = chained_writes_->begin(); it != chained_writes_->end();)
+        {
+            it = flush(it->second.producer) ? chained_writes_->erase(it) : std::next(it);
+        }
+        if (busy_inst_ && flush(busy_inst_))
         {
+            ev_release_unit_.cancel();
             unit_busy_ = false;
+            busy_inst_.reset();
             collected_inst_.closeRecord();
         }
     }
@@ -24,6 +24,13 @@
 #include "sparta/collection/Collectable.hpp"
 #include "sparta/resources/Scoreboard.hpp"
 #include "sparta/pevents/PeventCollector.hpp"
+#include "sparta/statistics/BasicHistogram.hpp"
+
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "CoreTypes.hpp"
 #include "FlushManager.hpp"
@@ -50,8 +57,24 @@ namespace olympia
             PARAMETER(uint32_t, execute_time, 1, "Time for execution")
             PARAMETER(bool, enable_random_misprediction, false,
                       "test mode to inject random branch mispredictions")
-            PARAMETER(uint32_t, valu_adder_num, 8,
-                      "VALU Number of Adders") // # of 64 bit adders, so 8 64 bit adders = 512 bits
+            PARAMETER(uint32_t, dlen, 512,
+                      "Vector datapath width (DLEN) in bits, a vector uop is executed in passes "
+                      "of DLEN/SEW elements")
+            PARAMETER(bool, pipelined, true,
+                      "Accept an instruction every initiation interval (the instruction's "
+                      "occupancy) instead of when the previous one completes")
+            PARAMETER(bool, enable_vector_chaining, false,
+                      "Wake up the consumers of a multi-pass vector uop once its first element "
+                      "group is written instead of when the whole uop completes")
+            PARAMETER(uint32_t, vector_chaining_latency, 1,
+                      "Cycles between writing an element group and a chained consumer reading it")
+            PARAMETER(std::string, div_latency_model, "fixed",
+                      "Divide/square root latency: fixed (the uarch json latency) or lzc (early "
+                      "out on the leading zeros of the operands, when the trace has their values)")
+            PARAMETER(uint32_t, div_setup_latency, 3,
+                      "lzc divide latency model: cycles to normalize the operands")
+            PARAMETER(uint32_t, div_bits_per_cycle, 2,
+                      "lzc divide latency model: quotient bits produced per cycle")
             HIDDEN_PARAMETER(bool, contains_branch_unit, false,
                              "Does this exe pipe contain a branch unit")
             HIDDEN_PARAMETER(std::string, iq_name, "", "issue queue name for scoreboard view")
@@ -73,10 +96,45 @@ namespace olympia
         // Write result to registers
         void insertInst(const InstPtr &);
 
+        /**
+         * @brief Drop an instruction that issued on a speculative load wakeup
+         *
+         * The issue queue replays it, the pipe is free on return.
+         */
+        void cancelInst(const InstPtr &);
+
+        /**
+         * @brief The load producers of a speculatively issued instruction hit
+         *
+         * An instruction still executing runs the rest of its latency.  One
+         * that executed or chained while waiting for its loads writes its
+         * results in this cycle: it issued when the load data arrived, so its
+         * latency already ran from its operands.
+         */
+        void confirmInst(const InstPtr &);
+
         // Used to set enable_random_misprediction_ for an execution pipe
         // set from Execute.cpp
         void setBranchRandomMisprediction(bool is_branch);
 
+        struct ChainedWrite
+        {
+            InstPtr producer;
+            // Cycles the producer spends on each element group
+            uint32_t group_occupancy = 0;
+            // Cycle the last element group is written
+            uint64_t complete_cycle = 0;
+        };
+        // In flight chained producers, by destination vector PRF
+        using ChainedWrites = std::map<uint32_t, ChainedWrite>;
+
+        // The chained writes are seen by the consumers of every pipe sharing
+        // them, set from Execute.cpp to the ones of all its pipes
+        void setChainedWrites(const std::shared_ptr<ChainedWrites> & chained_writes)
+        {
+            chained_writes_ = chained_writes;
+        }
+
       private:
         // Ports and the set -- remove the ", 1" to experience a DAG issue!
         sparta::DataInPort<InstQueue::value_type> in_execute_inst_{&unit_port_set_,
@@ -100,19 +158,50 @@ namespace olympia
         const uint32_t execute_time_;
         const bool enable_random_misprediction_;
         const std::string issue_queue_name_;
-        uint32_t valu_adder_num_;
-        uint32_t num_passes_needed_ = 0;
-        uint32_t curr_num_pass_ = 0;
+        const uint32_t dlen_;
+        const bool pipelined_;
+
+        // Instruction in the first stage, the unit accepts the next one
+        // after its initiation interval
+        InstPtr busy_inst_;
+
+        // Executed instructions waiting for the write back port
+        std::deque<InstPtr> completion_queue_;
+        uint64_t last_writeback_cycle_ = std::numeric_limits<uint64_t>::max();
+
+        // Speculatively issued instructions that executed, or wrote their first element
+        // group, before their load producers hit.  They wait here for confirmInst
+        std::vector<InstPtr> spec_executed_insts_;
+        std::vector<InstPtr> spec_chained_insts_;
+
+        // Vector chaining: a multi-pass uop makes its destination ready once
+        // the first element group is written.  A consumer spending at least
+        // as many cycles per element group as the producer stays behind it
+        // and never reads a group before it is written.  A faster consumer
+        // is not chained: it is held in its pipe until the producer
+        // completes, whichever pipe the producer is in.
+        const bool enable_vector_chaining_;
+        const uint32_t vector_chaining_latency_;
+        std::shared_ptr<ChainedWrites> chained_writes_ = std::make_shared<ChainedWrites>();
+
+        // Operand dependent (early out) divide latency
+        const bool early_out_div_;
+        const uint32_t div_setup_latency_;
+        const uint32_t div_bits_per_cycle_;
         // Events used to issue, execute and complete the instruction
-        sparta::PayloadEvent<InstPtr> issue_inst_{
-            &unit_event_set_, getName() + "_insert_inst",
-            CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, insertInst, InstPtr)};
+        sparta::UniqueEvent<> ev_release_unit_{&unit_event_set_, getName() + "_release_unit",
+                                               CREATE_SPARTA_HANDLER(ExecutePipe, releaseUnit_)};
         sparta::PayloadEvent<InstPtr> execute_inst_{
             &unit_event_set_, getName() + "_execute_inst",
             CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, executeInst_, InstPtr)};
         sparta::PayloadEvent<InstPtr> complete_inst_{
             &unit_event_set_, getName() + "_complete_inst",
             CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, completeInst_, InstPtr)};
+        sparta::UniqueEvent<> ev_writeback_{&unit_event_set_, getName() + "_writeback",
+                                            CREATE_SPARTA_HANDLER(ExecutePipe, writebackInst_)};
+        sparta::PayloadEvent<InstPtr> chain_inst_{
+            &unit_event_set_, getName() + "_chain_inst",
+            CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, chainInst_, InstPtr)};
 
         // A pipeline collector
         sparta::collection::Collectable<InstPtr> collected_inst_;
@@ -125,10 +214,50 @@ namespace olympia
         sparta::Counter total_insts_executed_{getStatisticSet(), "total_insts_executed",
                                               "Total instructions executed",
                                               sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_passes_{getStatisticSet(), "vector_passes",
+                                       "Execution passes (element groups) of vector uops",
+                                       sparta::Counter::COUNT_NORMAL};
+        sparta::Counter writeback_stall_cycles_{
+            getStatisticSet(), "writeback_stall_cycles",
+            "Cycles an executed instruction waited for the pipe's write back port",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_chained_uops_{
+            getStatisticSet(), "vector_chained_uops",
+            "Multi-pass vector uops whose consumers were woken up after the first element group",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_chain_holds_{
+            getStatisticSet(), "vector_chain_holds",
+            "Consumers of a chained vector uop held until it completes, their passes are faster",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_chain_overlap_cycles_{
+            getStatisticSet(), "vector_chain_overlap_cycles",
+            "Cycles chained consumers started executing before their producers completed",
+            sparta::Counter::COUNT_NORMAL};
+
+        // Latency histogram of the divides and square roots
+        sparta::BasicHistogram<uint32_t> div_latency_histogram_;
 
         void setupExecutePipe_();
+        void releaseUnit_();
+
         void executeInst_(const InstPtr &);
 
+        void writebackInst_();
+
+        // Make the destination registers of a chained vector uop ready
+        void chainInst_(const InstPtr &);
+
+        void setDestRegistersReady_(const InstPtr &);
+
+        // Cycles a consumer of chained vector uops waits before its first
+        // pass, 0 unless it would outrun one of its producers
+        uint32_t getChainHoldTime_(const InstPtr &, const uint32_t group_occupancy);
+
+        // Number of passes needed to execute a vector uop
+        uint32_t getNumVectorPasses_(const InstPtr &) const;
+
+        uint32_t getDivideLatency_(const InstPtr &, const uint32_t worst_case) const;
+
         // Callback from Scoreboard to inform Operand Readiness
         // void handleOperandIssueCheck_(const InstPtr &);
         // Used to complete the inst in the FPU
@@ -3,26 +3,49 @@
 #include "execute/IssueQueue.hpp"
 #include "CoreUtils.hpp"
 
+#include <algorithm>
+
 namespace olympia
 {
     const char IssueQueue::name[] = "issue_queue";
 
     IssueQueue::IssueQueue(sparta::TreeNode* node, const IssueQueueParameterSet* p) :
         sparta::Unit(node),
-        ready_queue_(IssueQueueSorter(&iq_sorter)),
         scheduler_size_(p->scheduler_size),
-        in_order_issue_(p->in_order_issue)
+        in_order_issue_(p->in_order_issue),
+        num_issue_ports_(p->num_issue_ports),
+        enable_load_hit_speculation_(p->enable_load_hit_speculation),
+        replay_penalty_(p->replay_penalty),
+        bypass_cycles_(p->bypass_cycles)
     {
+        sparta_assert(scheduler_size_ > 0, "Issue queue " << node->getName() << " has no slots");
+        slots_.resize(scheduler_size_);
+        occupied_slots_.resize(scheduler_size_);
+        ready_slots_.resize(scheduler_size_);
+        aged_slots_.resize(scheduler_size_);
+        age_matrix_.assign(scheduler_size_, SlotMask(scheduler_size_));
+        spec_srcs_.resize(scheduler_size_, 0);
+        spec_issued_slots_.resize(scheduler_size_);
+        issued_pipe_.resize(scheduler_size_, 0);
+        issue_cycle_.resize(scheduler_size_, 0);
+        replay_hold_slots_.resize(scheduler_size_);
+        bypass_srcs_.resize(scheduler_size_);
+        num_read_ports_ = {p->num_int_read_ports, p->num_float_read_ports,
+                           p->num_vector_read_ports};
+
         in_execute_inst_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, receiveInstsFromDispatch_, InstPtr));
         in_exe_pipe_done_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, readyExeUnit_, uint32_t));
         in_reorder_flush_.registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(
             IssueQueue, flushInst_, FlushManager::FlushingCriteria));
+        in_load_spec_wakeup_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, speculativeLoadWakeup_, InstPtr));
+        in_load_spec_cancel_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, cancelLoadWakeup_, InstPtr));
         sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(IssueQueue, setupIssueQueue_));
         node->getParent()->registerForNotification<bool, IssueQueue, &IssueQueue::onROBTerminate_>(
             this, "rob_stopped_notif_channel", false /* ROB maybe not be constructed yet */);
-        iq_sorter.setSorting(p->in_order_issue);
     }
 
     void IssueQueue::setupIssueQueue_()
@@ -49,21 +72,20 @@ namespace olympia
     {
         output << "Issue Queue Structure Contents" << std::endl;
 
-        output << "Ready Queue Contents:" << std::endl;
-        for (const auto & entry : ready_queue_)
-        {
-            output << '\t' << entry << std::endl;
-        }
-        output << "Issue Queue Contents:" << std::endl;
-        for (const auto & entry : issue_queue_)
+        for (auto slot = occupied_slots_.find_first(); slot != SlotMask::npos;
+             slot = occupied_slots_.find_next(slot))
         {
-            output << '\t' << entry << std::endl;
+            output << '\t' << slot
+                   << (ready_slots_.test(slot)
+                           ? " ready "
+                           : (spec_issued_slots_.test(slot) ? " spec issued " : " waiting "))
+                   << slots_[slot] << std::endl;
         }
     }
 
     void IssueQueue::onStartingTeardown_()
     {
-        if ((false == rob_stopped_simulation_) && (false == ready_queue_.empty()))
+        if ((false == rob_stopped_simulation_) && (ready_slots_.any() || spec_issued_slots_.any()))
         {
             dumpDebugContent_(std::cerr);
             sparta_assert(false, "Issue queue has pending instructions");
@@ -78,93 +100,423 @@ namespace olympia
     void IssueQueue::setExePipeMapping(const InstArchInfo::TargetPipe tgt_pipe,
                                        olympia::ExecutePipe* exe_pipe)
     {
-        if (pipe_exe_pipe_mapping_.find(tgt_pipe) == pipe_exe_pipe_mapping_.end())
+        auto pipe_itr = std::find(pipes_.begin(), pipes_.end(), exe_pipe);
+        const uint32_t pipe_idx = std::distance(pipes_.begin(), pipe_itr);
+        if (pipe_itr == pipes_.end())
         {
-            pipe_exe_pipe_mapping_[tgt_pipe] = std::vector<olympia::ExecutePipe*>();
+            pipes_.push_back(exe_pipe);
+            pipe_request_masks_.emplace_back(scheduler_size_);
         }
-        auto pipe_vector = pipe_exe_pipe_mapping_.find(tgt_pipe);
-        pipe_vector->second.emplace_back(exe_pipe);
-        pipes_.push_back(exe_pipe);
+        pipe_exe_pipe_mapping_[tgt_pipe].emplace_back(pipe_idx);
     }
 
     void IssueQueue::receiveInstsFromDispatch_(const InstPtr & ex_inst)
     {
         sparta_assert(ex_inst->getStatus() == Inst::Status::DISPATCHED,
                       "Bad instruction status: " << ex_inst);
-        appendIssueQueue_(ex_inst);
-        handleOperandIssueCheck_(ex_inst);
+        handleOperandIssueCheck_(allocateSlot_(ex_inst));
+    }
+
+    uint32_t IssueQueue::allocateSlot_(const InstPtr & inst_ptr)
+    {
+        const SlotMask free_slots = ~occupied_slots_;
+        const auto slot = free_slots.find_first();
+        sparta_assert(slot != SlotMask::npos, "Appending issue queue causes overflows!");
+
+        slots_[slot] = inst_ptr;
+        occupied_slots_.set(slot);
+        const auto pipe_idxs = pipe_exe_pipe_mapping_.find(inst_ptr->getPipe());
+        if (pipe_idxs != pipe_exe_pipe_mapping_.end())
+        {
+            for (const auto pipe_idx : pipe_idxs->second)
+            {
+                pipe_request_masks_[pipe_idx].set(slot);
+            }
+        }
+        if (!in_order_issue_)
+        {
+            // Dispatch is in program order, so the dispatch order is the age
+            enterAgeOrder_(slot);
+        }
+        return slot;
+    }
+
+    void IssueQueue::freeSlot_(const uint32_t slot)
+    {
+        slots_[slot].reset();
+        occupied_slots_.reset(slot);
+        ready_slots_.reset(slot);
+        spec_issued_slots_.reset(slot);
+        replay_hold_slots_.reset(slot);
+        spec_srcs_[slot] = 0;
+        for (auto & bypass_srcs : bypass_srcs_[slot])
+        {
+            bypass_srcs.reset();
+        }
+        leaveAgeOrder_(slot);
+        for (auto & request_mask : pipe_request_masks_)
+        {
+            request_mask.reset(slot);
+        }
+    }
+
+    void IssueQueue::enterAgeOrder_(const uint32_t slot)
+    {
+        age_matrix_[slot] = aged_slots_;
+        aged_slots_.set(slot);
     }
 
-    void IssueQueue::handleOperandIssueCheck_(const InstPtr & ex_inst)
+    void IssueQueue::leaveAgeOrder_(const uint32_t slot)
     {
-        // Assume all ready
-        bool all_srcs_ready = true;
+        aged_slots_.reset(slot);
+        for (auto row = occupied_slots_.find_first(); row != SlotMask::npos;
+             row = occupied_slots_.find_next(row))
+        {
+            age_matrix_[row].reset(slot);
+        }
+    }
+
+    void IssueQueue::unready_(const uint32_t slot)
+    {
+        ready_slots_.reset(slot);
+        if (in_order_issue_)
+        {
+            // Back in the FIFO when it is ready again
+            leaveAgeOrder_(slot);
+        }
+    }
+
+    void IssueQueue::markReady_(const uint32_t slot)
+    {
+        ILOG("Sending to issue queue " << slots_[slot]);
+        ready_slots_.set(slot);
+        if (in_order_issue_)
+        {
+            // First in first out from the time the operands are ready
+            enterAgeOrder_(slot);
+        }
+        ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+    }
+
+    uint32_t IssueQueue::selectOldest_(const SlotMask & candidates) const
+    {
+        for (auto slot = candidates.find_first(); slot != SlotMask::npos;
+             slot = candidates.find_next(slot))
+        {
+            if (!age_matrix_[slot].intersects(candidates))
+            {
+                return slot;
+            }
+        }
+        sparta_assert(false, "No oldest instruction among the issue candidates");
+        return 0;
+    }
+
+    bool IssueQueue::acquireReadPorts_(const uint32_t slot, PrfReadCounts & ports_used)
+    {
+        const InstPtr & inst = slots_[slot];
+        const uint64_t curr_cycle = getClock()->currentCycle();
+        PrfReadCounts prf_reads{};
+        uint32_t num_bypassed = 0;
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            const auto & src_bits =
+                inst->getSrcRegisterBitMask(static_cast<core_types::RegFile>(rf));
+            if (src_bits.none())
+            {
+                continue;
+            }
+            core_types::RegisterBitMask bypassed = src_bits & bypass_srcs_[slot][rf];
+            if ((bypass_cycles_ > 0) && bypassed.any())
+            {
+                for (const auto & src :
+                     inst->getRenameData().getSourceList(static_cast<core_types::RegFile>(rf)))
+                {
+                    const uint32_t prf = src.phys_reg;
+                    if (bypassed.test(prf)
+                        && ((curr_cycle - prf_wakeup_cycle_[rf][prf]) > bypass_cycles_))
+                    {
+                        // Gone from the bypass network, written to the PRF
+                        bypassed.reset(prf);
+                    }
+                }
+            }
+            num_bypassed += bypassed.count();
+            prf_reads[rf] = (src_bits & ~bypassed).count();
+
+            // An instruction with more sources than read ports reads them
+            // all when it has the ports to itself
+            if ((num_read_ports_[rf] > 0) && (ports_used[rf] > 0)
+                && ((ports_used[rf] + prf_reads[rf]) > num_read_ports_[rf]))
+            {
+                ILOG("Instruction " << inst << " needs " << prf_reads[rf] << " "
+                                    << static_cast<core_types::RegFile>(rf)
+                                    << " PRF read ports, " << ports_used[rf] << " are used");
+                ++(*read_port_conflicts_[rf]);
+                return false;
+            }
+        }
 
-        for (auto reg_file = 0; reg_file < core_types::RegFile::N_REGFILES; ++reg_file)
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
         {
-            const auto srcs =
-                ex_inst->getRenameData().getSourceList(static_cast<core_types::RegFile>(reg_file));
+            ports_used[rf] += prf_reads[rf];
+            prf_reads_ += prf_reads[rf];
+        }
+        bypassed_srcs_ += num_bypassed;
+        return true;
+    }
 
-            if (true == srcs.empty())
+    void IssueQueue::handleOperandIssueCheck_(const uint32_t slot)
+    {
+        const InstPtr & ex_inst = slots_[slot];
+        // Put the instruction on the wakeup list of every source PRF that
+        // is not ready yet
+        uint32_t num_pending_srcs = 0;
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            // vector-scalar operations have 1 vector src and 1
+            // scalar src that need to be checked, so can't assume
+            // the register files are the same for every source
+            const auto & src_bits =
+                ex_inst->getSrcRegisterBitMask(static_cast<core_types::RegFile>(rf));
+            if (src_bits.none() || scoreboard_views_[rf]->isSet(src_bits))
             {
                 continue;
             }
 
-            // Lambda function to check if a source is ready.
-            // Returns true if source is ready.
-            // Returns false and registers a callback if source is not ready.
-            auto check_src_ready = [this, ex_inst](const RenameData::Reg & src, auto reg_file)
+            for (const auto & src :
+                 ex_inst->getRenameData().getSourceList(static_cast<core_types::RegFile>(rf)))
             {
-                // vector-scalar operations have 1 vector src and 1
-                // scalar src that need to be checked, so can't assume
-                // the register files are the same for every source
-                const auto & src_bits =
-                    ex_inst->getSrcRegisterBitMask(static_cast<core_types::RegFile>(reg_file));
-                if (scoreboard_views_[reg_file]->isSet(src_bits))
+                const uint32_t prf = src.phys_reg;
+                if (!src_bits.test(prf))
                 {
-                    return true;
+                    continue;
                 }
-                else
+                core_types::RegisterBitMask prf_bits;
+                prf_bits.set(prf);
+                if (scoreboard_views_[rf]->isSet(prf_bits))
                 {
-                    // temporary fix for clearCallbacks not working
-                    scoreboard_views_[reg_file]->registerReadyCallback(
-                        src_bits, ex_inst->getUniqueID(),
-                        [this, ex_inst](const sparta::Scoreboard::RegisterBitMask &)
-                        { this->handleOperandIssueCheck_(ex_inst); });
-                    return false;
+                    continue;
                 }
-            };
 
-            for (const auto & src : srcs)
-            {
-                const bool src_ready = check_src_ready(src, reg_file);
+                if (prf >= wakeup_lists_[rf].size())
+                {
+                    wakeup_lists_[rf].resize(prf + 1);
+                    prf_wakeup_cycle_[rf].resize(prf + 1, 0);
+                }
+                auto & wakeup_list = wakeup_lists_[rf][prf];
+                if (!wakeup_list.empty() && (wakeup_list.back() == slot))
+                {
+                    // Same PRF used twice by the instruction
+                    continue;
+                }
+                wakeup_list.emplace_back(slot);
+                bypass_srcs_[slot][rf].set(prf);
+                if (spec_woken_[rf].test(prf))
+                {
+                    // The load producer is assumed to hit
+                    ++spec_srcs_[slot];
+                    ++load_spec_wakeups_;
+                    continue;
+                }
+                ++num_pending_srcs;
 
-                if (!src_ready)
+                if (!wakeup_registered_[rf].test(prf))
                 {
-                    ILOG("Instruction NOT ready: "
-                         << ex_inst << " Bits needed:"
-                         << sparta::printBitSet(ex_inst->getSrcRegisterBitMask(
-                                static_cast<core_types::RegFile>(reg_file)))
-                         << " rf: " << static_cast<core_types::RegFile>(reg_file));
-                    all_srcs_ready = false;
-
-                    // we break to prevent multiple callbacks from
-                    // being sent out
-                    break;
+                    wakeup_registered_[rf].set(prf);
+                    scoreboard_views_[rf]->registerReadyCallback(
+                        prf_bits, prf,
+                        [this, rf, prf](const sparta::Scoreboard::RegisterBitMask &)
+                        { this->wakeupConsumers_(static_cast<core_types::RegFile>(rf), prf); });
                 }
+                ILOG("Instruction NOT ready: " << ex_inst << " waiting on PRF " << prf
+                                               << " rf: " << static_cast<core_types::RegFile>(rf));
             }
         }
 
-        // we wait till the final callback comes back and checks in
-        // the case where both RF are ready at the same time
-        if (all_srcs_ready)
+        ex_inst->setNumPendingSources(num_pending_srcs);
+        if (num_pending_srcs == 0)
         {
             // all register file types are ready
-            ILOG("Sending to issue queue " << ex_inst);
-            // will insert based on if in_order_issue_ is set
-            // if it is, will be first in first out, if not it'll be by age, so by UniqueID (UID)
-            ready_queue_.insert(ex_inst);
-            ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+            markReady_(slot);
+        }
+    }
+
+    void IssueQueue::wakeupConsumers_(const core_types::RegFile rf, const uint32_t prf)
+    {
+        wakeup_registered_[rf].reset(prf);
+        const bool spec_woken = spec_woken_[rf].test(prf);
+        spec_woken_[rf].reset(prf);
+        auto & consumers = wakeup_lists_[rf][prf];
+        if (!spec_woken)
+        {
+            prf_wakeup_cycle_[rf][prf] = getClock()->currentCycle();
+        }
+        for (const auto slot : consumers)
+        {
+            if (spec_woken)
+            {
+                // Already woken up, the load hit
+                confirmSpecSource_(slot);
+                continue;
+            }
+            ++source_wakeups_;
+            if (slots_[slot]->wakeupSource() == 0)
+            {
+                markReady_(slot);
+            }
+        }
+        consumers.clear();
+    }
+
+    void IssueQueue::removeFromWakeupLists_(const uint32_t slot)
+    {
+        const InstPtr & inst_ptr = slots_[slot];
+        if ((inst_ptr->getNumPendingSources() == 0) && (spec_srcs_[slot] == 0))
+        {
+            return;
+        }
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & src :
+                 inst_ptr->getRenameData().getSourceList(static_cast<core_types::RegFile>(rf)))
+            {
+                if (src.phys_reg < wakeup_lists_[rf].size())
+                {
+                    auto & wakeup_list = wakeup_lists_[rf][src.phys_reg];
+                    wakeup_list.erase(std::remove(wakeup_list.begin(), wakeup_list.end(), slot),
+                                      wakeup_list.end());
+                    if (wakeup_list.empty())
+                    {
+                        // A flushed load leaves no consumer behind, its PRF
+                        // may be renamed again
+                        spec_woken_[rf].reset(src.phys_reg);
+                    }
+                }
+            }
+        }
+    }
+
+    void IssueQueue::speculativeLoadWakeup_(const InstPtr & load_inst)
+    {
+        if (!enable_load_hit_speculation_)
+        {
+            return;
+        }
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & dest :
+                 load_inst->getRenameData().getDestList(static_cast<core_types::RegFile>(rf)))
+            {
+                // Only PRFs with waiting consumers, the Scoreboard callback
+                // confirms the hit
+                const uint32_t prf = dest.phys_reg;
+                if (!wakeup_registered_[rf].test(prf) || spec_woken_[rf].test(prf)
+                    || wakeup_lists_[rf][prf].empty())
+                {
+                    continue;
+                }
+                ILOG("Speculative wakeup on PRF " << prf << " rf: "
+                                                  << static_cast<core_types::RegFile>(rf)
+                                                  << " from " << load_inst);
+                spec_woken_[rf].set(prf);
+                prf_wakeup_cycle_[rf][prf] = getClock()->currentCycle();
+                for (const auto slot : wakeup_lists_[rf][prf])
+                {
+                    ++spec_srcs_[slot];
+                    ++load_spec_wakeups_;
+                    if (slots_[slot]->wakeupSource() == 0)
+                    {
+                        markReady_(slot);
+                    }
+                }
+            }
+        }
+    }
+
+    void IssueQueue::cancelLoadWakeup_(const InstPtr & load_inst)
+    {
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for (const auto & dest :
+                 load_inst->getRenameData().getDestList(static_cast<core_types::RegFile>(rf)))
+            {
+                const uint32_t prf = dest.phys_reg;
+                if (!spec_woken_[rf].test(prf))
+                {
+                    continue;
+                }
+                ILOG("Cancel speculative wakeup on PRF " << prf << " rf: "
+                                                         << static_cast<core_types::RegFile>(rf)
+                                                         << " from " << load_inst);
+                spec_woken_[rf].reset(prf);
+                for (const auto slot : wakeup_lists_[rf][prf])
+                {
+                    const InstPtr & inst = slots_[slot];
+                    --spec_srcs_[slot];
+                    inst->setNumPendingSources(inst->getNumPendingSources() + 1);
+                    if (spec_issued_slots_.test(slot))
+                    {
+                        replayInst_(slot);
+                    }
+                    else
+                    {
+                        unready_(slot);
+                    }
+                }
+            }
+        }
+    }
+
+    void IssueQueue::confirmSpecSource_(const uint32_t slot)
+    {
+        sparta_assert(spec_srcs_[slot] > 0, "No speculative source to confirm " << slots_[slot]);
+        if (--spec_srcs_[slot] > 0)
+        {
+            return;
+        }
+        if (spec_issued_slots_.test(slot))
+        {
+            // The instruction can write its results and leave the issue queue
+            ILOG("Load hit confirmed for " << slots_[slot]);
+            slots_[slot]->setSpeculativelyIssued(false);
+            pipes_[issued_pipe_[slot]]->confirmInst(slots_[slot]);
+            freeSlot_(slot);
+            out_scheduler_credits_.send(1, 0);
+        }
+    }
+
+    void IssueQueue::replayInst_(const uint32_t slot)
+    {
+        const InstPtr & inst = slots_[slot];
+        ILOG("Replaying " << inst << ", a load producer missed");
+        pipes_[issued_pipe_[slot]]->cancelInst(inst);
+        inst->setSpeculativelyIssued(false);
+        spec_issued_slots_.reset(slot);
+        ++replayed_insts_;
+        wasted_issue_cycles_ += getClock()->currentCycle() - issue_cycle_[slot];
+
+        // Hold it for the replay penalty, the pipe it used is free
+        replay_hold_slots_.set(slot);
+        ev_replay_release_.cancelIf([inst](const InstPtr & held) -> bool { return held == inst; });
+        ev_replay_release_.preparePayload(inst)->schedule(replay_penalty_);
+        ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+    }
+
+    void IssueQueue::releaseReplay_(const InstPtr & inst)
+    {
+        for (auto slot = replay_hold_slots_.find_first(); slot != SlotMask::npos;
+             slot = replay_hold_slots_.find_next(slot))
+        {
+            if (slots_[slot] == inst)
+            {
+                replay_hold_slots_.reset(slot);
+                if (ready_slots_.test(slot))
+                {
+                    ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+                }
+                return;
+            }
         }
     }
 
@@ -175,7 +527,7 @@ namespace olympia
           have a map/mask to see which execution units are ready
           signal port
         */
-        if (!ready_queue_.empty())
+        if (ready_slots_.any())
         {
             ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
         }
@@ -183,33 +535,76 @@ namespace olympia
 
     void IssueQueue::sendReadyInsts_()
     {
-        sparta_assert(ready_queue_.size() <= scheduler_size_,
-                      "ready queue greater than issue queue size: " << scheduler_size_);
-        auto inst_itr = ready_queue_.begin();
-        while (inst_itr != ready_queue_.end())
-        {
-            auto inst = *inst_itr;
-            const auto & valid_exe_pipe = pipe_exe_pipe_mapping_[inst->getPipe()];
-            bool sent = false;
-            for (auto & exe_pipe : valid_exe_pipe)
+        const uint32_t num_ports = (num_issue_ports_ > 0) ? num_issue_ports_ : pipes_.size();
+        uint32_t num_issued = 0;
+        PrfReadCounts read_ports_used{};
+        // Slots that did not get their read ports this cycle, the ports used
+        // only increase so the next pipes don't try them again
+        SlotMask port_stalled_slots(scheduler_size_);
+        for (uint32_t pipe_idx = 0; pipe_idx < pipes_.size(); ++pipe_idx)
+        {
+            auto exe_pipe = pipes_[pipe_idx];
+            if (!exe_pipe->canAccept())
+            {
+                continue;
+            }
+            SlotMask candidates = (ready_slots_ - replay_hold_slots_ - port_stalled_slots)
+                                  & pipe_request_masks_[pipe_idx];
+            if (candidates.none())
+            {
+                continue;
+            }
+            if (num_issued == num_ports)
             {
-                if (exe_pipe->canAccept())
+                // A pipe could take an instruction, but the ports are used
+                ++issue_port_limited_;
+                ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(1));
+                break;
+            }
+
+            // The oldest candidate whose PRF reads fit in the free read ports
+            uint32_t slot = selectOldest_(candidates);
+            while (!acquireReadPorts_(slot, read_ports_used))
+            {
+                port_stalled_slots.set(slot);
+                candidates.reset(slot);
+                if (candidates.none())
                 {
-                    ILOG("Sending instruction " << inst << " to exe_pipe " << exe_pipe->getName())
-                    exe_pipe->insertInst(inst);
-                    auto delete_iter = inst_itr++;
-                    sent = true;
-                    ready_queue_.erase(delete_iter);
-                    popIssueQueue_(inst);
-                    ++total_insts_issued_;
-                    issue_event_.collect(*inst);
                     break;
                 }
+                slot = selectOldest_(candidates);
+            }
+            if (candidates.none())
+            {
+                continue;
             }
-            if (!sent)
+            const InstPtr inst = slots_[slot];
+            ILOG("Sending instruction " << inst << " to exe_pipe " << exe_pipe->getName())
+            exe_pipe->insertInst(inst);
+            if (spec_srcs_[slot] > 0)
             {
-                ++inst_itr;
+                // Keep the slot to replay the instruction if a load producer misses
+                inst->setSpeculativelyIssued(true);
+                issued_pipe_[slot] = pipe_idx;
+                issue_cycle_[slot] = getClock()->currentCycle();
+                unready_(slot);
+                spec_issued_slots_.set(slot);
             }
+            else
+            {
+                freeSlot_(slot);
+                // send credit back to dispatch, we now have more room in IQ
+                out_scheduler_credits_.send(1, 0);
+            }
+            ++num_issued;
+            ++total_insts_issued_;
+            issue_event_.collect(*inst);
+        }
+
+        if (port_stalled_slots.any())
+        {
+            // Try again when the read ports are free
+            ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(1));
         }
     }
 
@@ -217,24 +612,19 @@ namespace olympia
     {
         uint32_t credits_to_send = 0;
 
-        auto issue_queue_iter = issue_queue_.begin();
-        while (issue_queue_iter != issue_queue_.end())
+        for (auto slot = occupied_slots_.find_first(); slot != SlotMask::npos;
+             slot = occupied_slots_.find_next(slot))
         {
-            auto delete_iter = issue_queue_iter++;
-
-            auto inst_ptr = *delete_iter;
+            const InstPtr inst_ptr = slots_[slot];
 
             // Remove flushed instruction from issue queue and clear scoreboard
             // callbacks
             if (criteria.includedInFlush(inst_ptr))
             {
-                issue_queue_.erase(delete_iter);
-
-                // Clear scoreboard callbacks for all register file types
-                for (uint32_t rf = 0; rf < core_types::N_REGFILES; ++rf)
-                {
-                    scoreboard_views_[rf]->clearCallbacks(inst_ptr->getUniqueID());
-                }
+                // Remove it from the wakeup lists, the Scoreboard callbacks
+                // are shared with the other consumers of the PRFs
+                removeFromWakeupLists_(slot);
+                freeSlot_(slot);
 
                 ++credits_to_send;
 
@@ -248,44 +638,5 @@ namespace olympia
 
             ILOG("Flush " << credits_to_send << " instructions in issue queue!");
         }
-
-        // Flush instructions in the ready queue
-        auto ready_queue_iter = ready_queue_.begin();
-        while (ready_queue_iter != ready_queue_.end())
-        {
-            auto delete_iter = ready_queue_iter++;
-            auto inst_ptr = *delete_iter;
-            if (criteria.includedInFlush(inst_ptr))
-            {
-                ready_queue_.erase(delete_iter);
-                ILOG("Flush Instruction ID: " << inst_ptr->getUniqueID() << " from ready queue");
-            }
-        }
-    }
-
-    // Append instruction into issue queue
-    void IssueQueue::appendIssueQueue_(const InstPtr & inst_ptr)
-    {
-        sparta_assert(issue_queue_.size() <= scheduler_size_,
-                      "Appending issue queue causes overflows!");
-
-        issue_queue_.emplace_back(inst_ptr);
-    }
-
-    // Pop completed instruction out of issue queue
-    void IssueQueue::popIssueQueue_(const InstPtr & inst_ptr)
-    {
-        // Look for the instruction to be completed, and remove it from issue queue
-        for (auto iter = issue_queue_.begin(); iter != issue_queue_.end(); iter++)
-        {
-            if (*iter == inst_ptr)
-            {
-                issue_queue_.erase(iter);
-                out_scheduler_credits_.send(
-                    1, 0); // send credit back to dispatch, we now have more room in IQ
-                return;
-            }
-        }
-        sparta_assert(false, "Attempt to complete instruction no longer exiting in issue queue!");
     }
 } // namespace olympia
@@ -4,6 +4,7 @@
 
 #include "sparta/collection/Collectable.hpp"
 #include "sparta/events/EventSet.hpp"
+#include "sparta/events/PayloadEvent.hpp"
 #include "sparta/events/StartupEvent.hpp"
 #include "sparta/events/UniqueEvent.hpp"
 #include "sparta/ports/DataPort.hpp"
@@ -16,7 +17,7 @@
 #include "sparta/simulation/Unit.hpp"
 #include "sparta/pevents/PeventCollector.hpp"
 
-#include "sparta/resources/PriorityQueue.hpp"
+#include <boost/dynamic_bitset.hpp>
 
 #include "CoreTypes.hpp"
 #include "execute/ExecutePipe.hpp"
@@ -42,39 +43,22 @@ namespace olympia
             IssueQueueParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
             PARAMETER(uint32_t, scheduler_size, 8, "Scheduler queue size")
             PARAMETER(bool, in_order_issue, true, "Force in order issue")
-        };
-
-        class IssueQueueSorter
-        {
-          public:
-            IssueQueueSorter() {}
-
-            IssueQueueSorter(IssueQueueSorter* sorter) : dyn_sorter_(sorter) {}
-
-            bool operator()(const InstPtr existing, const InstPtr to_be_inserted) const
-            {
-                return dyn_sorter_->choose(existing, to_be_inserted);
-            }
-
-            bool choose(const InstPtr existing, const InstPtr to_be_inserted)
-            {
-                if (fifo_)
-                {
-                    // we just want to insert it in the back for fifo order
-                    return false;
-                }
-                else
-                {
-                    // age based insertion
-                    return existing->getUniqueID() > to_be_inserted->getUniqueID();
-                }
-            }
-
-            void setSorting(const bool sort_type) { fifo_ = sort_type; }
-
-          private:
-            bool fifo_ = true;
-            IssueQueueSorter* dyn_sorter_ = this;
+            PARAMETER(uint32_t, num_issue_ports, 0,
+                      "Instructions issued per cycle (0: one per execution pipe)")
+            PARAMETER(bool, enable_load_hit_speculation, false,
+                      "Wake up the consumers of a load assuming it hits in the L1, replay them "
+                      "if it misses")
+            PARAMETER(uint32_t, replay_penalty, 2,
+                      "Cycles before a consumer replayed on a load miss can issue again")
+            PARAMETER(uint32_t, num_int_read_ports, 0,
+                      "Integer PRF read ports of the issued instructions (0: unlimited)")
+            PARAMETER(uint32_t, num_float_read_ports, 0,
+                      "Float PRF read ports of the issued instructions (0: unlimited)")
+            PARAMETER(uint32_t, num_vector_read_ports, 0,
+                      "Vector PRF read ports of the issued instructions (0: unlimited)")
+            PARAMETER(uint32_t, bypass_cycles, 0,
+                      "Cycles a result stays on the bypass network after it wakes up its "
+                      "consumers, older sources are read from the PRF (0: full bypass)")
         };
 
         IssueQueue(sparta::TreeNode* node, const IssueQueueParameterSet* p);
@@ -87,6 +71,11 @@ namespace olympia
         const StringToExePipe & getExePipes() { return exe_pipes_; };
 
       private:
+        // One bit per scheduler slot
+        using SlotMask = boost::dynamic_bitset<uint64_t>;
+        // PRF reads per register file
+        using PrfReadCounts = std::array<uint32_t, core_types::N_REGFILES>;
+
         // Scoreboards
         using ScoreboardViews =
             std::array<std::unique_ptr<sparta::ScoreboardView>, core_types::N_REGFILES>;
@@ -100,9 +89,22 @@ namespace olympia
         void flushInst_(const FlushManager::FlushingCriteria & criteria);
         void sendReadyInsts_();
         void readyExeUnit_(const uint32_t &);
-        void appendIssueQueue_(const InstPtr &);
-        void popIssueQueue_(const InstPtr &);
-        void handleOperandIssueCheck_(const InstPtr &);
+        uint32_t allocateSlot_(const InstPtr &);
+        void freeSlot_(const uint32_t slot);
+        void markReady_(const uint32_t slot);
+        void enterAgeOrder_(const uint32_t slot);
+        uint32_t selectOldest_(const SlotMask & candidates) const;
+        bool acquireReadPorts_(const uint32_t slot, PrfReadCounts & ports_used);
+        void handleOperandIssueCheck_(const uint32_t slot);
+        void wakeupConsumers_(const core_types::RegFile rf, const uint32_t prf);
+        void removeFromWakeupLists_(const uint32_t slot);
+        void leaveAgeOrder_(const uint32_t slot);
+        void unready_(const uint32_t slot);
+        void speculativeLoadWakeup_(const InstPtr & load_inst);
+        void cancelLoadWakeup_(const InstPtr & load_inst);
+        void confirmSpecSource_(const uint32_t slot);
+        void replayInst_(const uint32_t slot);
+        void releaseReplay_(const InstPtr &);
         void onROBTerminate_(const bool & val);
         void onStartingTeardown_() override;
         void dumpDebugContent_(std::ostream & output) const override final;
@@ -115,27 +117,118 @@ namespace olympia
                                                              "out_scheduler_credits"};
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
             &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
+        // A load that looked up the cache would return its data now if it hits, its
+        // consumers can wake up assuming a hit
+        sparta::DataInPort<InstPtr> in_load_spec_wakeup_{&unit_port_set_, "in_load_spec_wakeup",
+                                                         0};
+        // The load missed, the consumers woken up by it are replayed
+        sparta::DataInPort<InstPtr> in_load_spec_cancel_{&unit_port_set_, "in_load_spec_cancel",
+                                                         0};
+        sparta::PayloadEvent<InstPtr> ev_replay_release_{
+            &unit_event_set_, "replay_release",
+            CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, releaseReplay_, InstPtr)};
         // mapping used to lookup based on execution unit name
         // {"alu0": ExecutePipe0}
         StringToExePipe exe_pipes_;
-        // mapping of target pipe -> vector of execute pipes
-        // i.e {"INT", <ExecutePipe0, ExecutePipe1>}
-        std::unordered_map<InstArchInfo::TargetPipe, std::vector<olympia::ExecutePipe*>>
+        // mapping of target pipe -> indexes in pipes_ of the execute pipes
+        // i.e {"INT", <0, 1>}
+        std::unordered_map<InstArchInfo::TargetPipe, std::vector<uint32_t>>
             pipe_exe_pipe_mapping_;
-        // storage of what pipes are in this issue queues
+        // storage of what pipes are in this issue queues, each pipe once
         std::vector<olympia::ExecutePipe*> pipes_;
         std::vector<std::string> exe_unit_str_;
-        IssueQueueSorter iq_sorter;
-        sparta::PriorityQueue<InstPtr, IssueQueueSorter>
-            ready_queue_;                // queue for instructions that have operands ready
-        std::list<InstPtr> issue_queue_; // instructions that have been sent from dispatch,
-                                         // not ready yet
+
+        // Scheduler slots.  An instruction keeps its slot from dispatch
+        // until it issues or is flushed
+        std::vector<InstPtr> slots_;
+        SlotMask occupied_slots_;
+        // Slots with all their sources ready
+        SlotMask ready_slots_;
+        // Slots ordered by the age matrix: from dispatch when issuing by
+        // age, from becoming ready when issuing in order
+        SlotMask aged_slots_;
+        // Row i holds the slots that entered the age order before slot i,
+        // the oldest candidate is the one with no candidate in its row
+        std::vector<SlotMask> age_matrix_;
+        // Per pipe in pipes_, the slots whose instruction can go to it
+        std::vector<SlotMask> pipe_request_masks_;
+
+        // Load hit speculation: per slot, the number of sources woken up
+        // assuming their load producer hits.  An instruction issued with
+        // such sources keeps its slot until the loads hit, it's replayed
+        // from the slot if one misses
+        std::vector<uint32_t> spec_srcs_;
+        SlotMask spec_issued_slots_;
+        std::vector<uint32_t> issued_pipe_;
+        std::vector<uint64_t> issue_cycle_;
+        // Replayed slots waiting for the replay penalty
+        SlotMask replay_hold_slots_;
+        // PRFs whose consumers were woken up speculatively
+        std::array<core_types::RegisterBitMask, core_types::N_REGFILES> spec_woken_;
+
+        // Register file read ports and bypass network.  A source woken up
+        // by its producer is bypassed for bypass_cycles_ after the wakeup,
+        // any other source is read from the PRF at issue
+        std::vector<std::array<core_types::RegisterBitMask, core_types::N_REGFILES>>
+            bypass_srcs_;
+        std::array<std::vector<uint64_t>, core_types::N_REGFILES> prf_wakeup_cycle_;
+        PrfReadCounts num_read_ports_;
+
+        // Wakeup lists: the slots of the instructions waiting on each source PRF that is
+        // not ready.  A single Scoreboard callback is registered per PRF,
+        // when it fires the consumers on the list decrement their number of
+        // pending sources instead of checking all their sources again
+        using WakeupList = std::vector<uint32_t>;
+        std::array<std::vector<WakeupList>, core_types::N_REGFILES> wakeup_lists_;
+        std::array<core_types::RegisterBitMask, core_types::N_REGFILES> wakeup_registered_;
 
         const uint32_t scheduler_size_;
         const bool in_order_issue_;
+        const uint32_t num_issue_ports_;
+        const bool enable_load_hit_speculation_;
+        const uint32_t replay_penalty_;
+        const uint32_t bypass_cycles_;
         sparta::Counter total_insts_issued_{getStatisticSet(), "total_insts_issued",
                                             "Total instructions issued",
                                             sparta::Counter::COUNT_NORMAL};
+        sparta::Counter source_wakeups_{getStatisticSet(), "source_wakeups",
+                                        "Source operands woken up by their producer",
+                                        sparta::Counter::COUNT_NORMAL};
+        sparta::Counter issue_port_limited_{getStatisticSet(), "issue_port_limited",
+                                            "Cycles with ready instructions left behind because "
+                                            "all the issue ports were used",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter load_spec_wakeups_{getStatisticSet(), "load_spec_wakeups",
+                                           "Source operands woken up assuming a load hit",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter replayed_insts_{getStatisticSet(), "replayed_insts",
+                                        "Instructions replayed because their load producer "
+                                        "missed",
+                                        sparta::Counter::COUNT_NORMAL};
+        sparta::Counter wasted_issue_cycles_{getStatisticSet(), "wasted_issue_cycles",
+                                             "Execution pipe cycles used by replayed "
+                                             "instructions",
+                                             sparta::Counter::COUNT_NORMAL};
+        sparta::Counter prf_reads_{getStatisticSet(), "prf_reads",
+                                   "Source operands read from the register files",
+                                   sparta::Counter::COUNT_NORMAL};
+        sparta::Counter bypassed_srcs_{getStatisticSet(), "bypassed_srcs",
+                                       "Source operands taken from the bypass network",
+                                       sparta::Counter::COUNT_NORMAL};
+        sparta::Counter int_read_port_conflicts_{getStatisticSet(), "int_read_port_conflicts",
+                                                 "Ready instructions not issued for lack of "
+                                                 "integer PRF read ports",
+                                                 sparta::Counter::COUNT_NORMAL};
+        sparta::Counter float_read_port_conflicts_{getStatisticSet(), "float_read_port_conflicts",
+                                                   "Ready instructions not issued for lack of "
+                                                   "float PRF read ports",
+                                                   sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_read_port_conflicts_{
+            getStatisticSet(), "vector_read_port_conflicts",
+            "Ready instructions not issued for lack of vector PRF read ports",
+            sparta::Counter::COUNT_NORMAL};
+        std::array<sparta::Counter*, core_types::N_REGFILES> read_port_conflicts_{
+            &int_read_port_conflicts_, &float_read_port_conflicts_, &vector_read_port_conflicts_};
         bool rob_stopped_simulation_ = false;
         friend class IssueQueueTester;
 
@@ -0,0 +1,292 @@
+#include "fetch/BranchPredEval.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace olympia
+{
+namespace BranchPredictor
+{
+
+    const char * getBranchClassName(BranchClass branch_class)
+    {
+        switch (branch_class) {
+            case BranchClass::CONDITIONAL:
+                return "conditional";
+            case BranchClass::DIRECT_JUMP:
+                return "direct_jump";
+            case BranchClass::INDIRECT_JUMP:
+                return "indirect_jump";
+            case BranchClass::CALL:
+                return "call";
+            case BranchClass::RETURN:
+                return "return";
+            case BranchClass::N_BRANCH_CLASSES:
+                break;
+        }
+        sparta_assert(false, "Unknown branch class: " << static_cast<uint32_t>(branch_class));
+        return "";
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // STFBranchStream
+
+    STFBranchStream::STFBranchStream(const std::string & filename, bool skip_nonuser_mode,
+                                     uint64_t inst_limit) :
+        inst_limit_(inst_limit)
+    {
+        constexpr bool CHECK_FOR_STF_PTE = false;
+        constexpr bool FILTER_MODE_CHANGE_EVENTS = true;
+        reader_.reset(new stf::STFBranchReader(filename, skip_nonuser_mode, CHECK_FOR_STF_PTE,
+                                               FILTER_MODE_CHANGE_EVENTS));
+        next_it_ = reader_->begin();
+    }
+
+    STFBranchStream::~STFBranchStream() {}
+
+    bool STFBranchStream::read(BranchRecordList & records, size_t max_records)
+    {
+        records.clear();
+        if (done_) {
+            return false;
+        }
+
+        auto & it = next_it_;
+        for (; (it != reader_->end()) && (records.size() < max_records); ++it) {
+            if ((inst_limit_ != 0) && (it->index() > inst_limit_)) {
+                num_insts_ = inst_limit_;
+                done_ = true;
+                break;
+            }
+
+            BranchRecord & record = records.emplace_back();
+            record.pc = it->getPC();
+            record.target = it->getTargetPC();
+            record.inst_index = it->index();
+            record.taken = it->isTaken();
+            // RVC encodings are the ones whose 2 LSBs are not 0b11
+            record.inst_size = ((it->getOpcode() & 0x3) != 0x3)
+                ? DefaultBranchPredictorIF::bytes_per_compressed_inst
+                : DefaultBranchPredictorIF::bytes_per_uncompressed_inst;
+            if (it->isReturn()) {
+                record.branch_class = BranchClass::RETURN;
+            }
+            else if (it->isCall()) {
+                record.branch_class = BranchClass::CALL;
+            }
+            else if (it->isConditional()) {
+                record.branch_class = BranchClass::CONDITIONAL;
+            }
+            else if (it->isIndirect()) {
+                record.branch_class = BranchClass::INDIRECT_JUMP;
+            }
+            else {
+                record.branch_class = BranchClass::DIRECT_JUMP;
+            }
+            num_insts_ = record.inst_index;
+        }
+
+        if (it == reader_->end()) {
+            // The instructions after the last branch count too
+            num_insts_ = reader_->numInstsRead();
+            if (inst_limit_ != 0) {
+                num_insts_ = std::min(num_insts_, inst_limit_);
+            }
+            done_ = true;
+        }
+        return !records.empty();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // BranchPredEvaluator
+
+    void BranchPredEvaluator::evaluate(const BranchRecord & branch)
+    {
+        // Each branch is looked up as the first instruction of a fetch packet
+        DefaultInput input;
+        input.fetch_PC = branch.pc;
+        const DefaultPrediction prediction = predictor_.getPrediction(input);
+
+        // The branch is predicted taken if the predictor redirects at the
+        // first instruction of the packet; any other prediction (including
+        // a BTB miss) continues sequentially past the branch
+        const uint64_t fall_through_pc = branch.pc + branch.inst_size;
+        const bool predicted_taken =
+            (prediction.branch_idx == 0) && (prediction.predicted_PC != fall_through_pc);
+        const bool mispredicted = branch.taken
+            ? (!predicted_taken || (prediction.predicted_PC != branch.target))
+            : predicted_taken;
+        const uint64_t next_pc = branch.taken ? branch.target : fall_through_pc;
+
+        DefaultUpdate update;
+        update.fetch_PC = branch.pc;
+        update.branch_idx = 0;
+        update.corrected_PC = next_pc;
+        update.fall_through_PC = fall_through_pc;
+        update.actually_taken = branch.taken;
+        predictor_.updatePredictor(update);
+
+        auto & class_stats = class_stats_[static_cast<uint32_t>(branch.branch_class)];
+        auto & pc_stats = pc_stats_[branch.pc];
+        ++class_stats.branches;
+        ++pc_stats.branches;
+        if (mispredicted) {
+            ++class_stats.mispredicts;
+            ++pc_stats.mispredicts;
+        }
+    }
+
+    uint64_t BranchPredEvaluator::getNumBranches() const
+    {
+        uint64_t branches = 0;
+        for (const auto & stats : class_stats_) {
+            branches += stats.branches;
+        }
+        return branches;
+    }
+
+    uint64_t BranchPredEvaluator::getNumMispredicts() const
+    {
+        uint64_t mispredicts = 0;
+        for (const auto & stats : class_stats_) {
+            mispredicts += stats.mispredicts;
+        }
+        return mispredicts;
+    }
+
+    void BranchPredEvaluator::report(std::ostream & os, uint64_t num_insts, uint32_t top_pcs) const
+    {
+        auto mpki = [num_insts](uint64_t mispredicts) {
+            return (num_insts == 0) ? 0.0 : (1000.0 * mispredicts) / num_insts;
+        };
+        auto accuracy = [](const BranchStats & stats) {
+            return (stats.branches == 0) ? 0.0
+                : 100.0 * (stats.branches - stats.mispredicts) / stats.branches;
+        };
+
+        const BranchStats total{getNumBranches(), getNumMispredicts()};
+
+        os << "Branch predictor: " << name_ << std::endl;
+        os << "  instructions: " << num_insts << std::endl;
+        os << "  branches:     " << total.branches << std::endl;
+        os << "  mispredicts:  " << total.mispredicts << std::endl;
+        os << std::fixed << std::setprecision(3);
+        os << "  MPKI:         " << mpki(total.mispredicts) << std::endl;
+        os << "  accuracy:     " << accuracy(total) << "%" << std::endl;
+
+        os << std::endl << "  " << std::left << std::setw(16) << "class" << std::right
+           << std::setw(14) << "branches" << std::setw(14) << "mispredicts" << std::setw(10)
+           << "MPKI" << std::setw(12) << "accuracy" << std::endl;
+        for (uint32_t idx = 0; idx < static_cast<uint32_t>(BranchClass::N_BRANCH_CLASSES); ++idx) {
+            const auto & stats = class_stats_[idx];
+            os << "  " << std::left << std::setw(16)
+               << getBranchClassName(static_cast<BranchClass>(idx)) << std::right
+               << std::setw(14) << stats.branches << std::setw(14) << stats.mispredicts
+               << std::setw(10) << mpki(stats.mispredicts) << std::setw(11) << accuracy(stats)
+               << "%" << std::endl;
+        }
+
+        if (top_pcs == 0) {
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, BranchStats>> worst_pcs(pc_stats_.begin(), pc_stats_.end());
+        const auto num_pcs = std::min<size_t>(top_pcs, worst_pcs.size());
+        std::partial_sort(worst_pcs.begin(), worst_pcs.begin() + num_pcs, worst_pcs.end(),
+                          [](const auto & lhs, const auto & rhs) {
+                              if (lhs.second.mispredicts == rhs.second.mispredicts) {
+                                  return lhs.first < rhs.first;
+                              }
+                              return lhs.second.mispredicts > rhs.second.mispredicts;
+                          });
+
+        os << std::endl << "  Top " << num_pcs << " mispredicted branch PCs" << std::endl;
+        os << "  " << std::left << std::setw(18) << "pc" << std::right << std::setw(14)
+           << "branches" << std::setw(14) << "mispredicts" << std::setw(10) << "MPKI"
+           << std::setw(12) << "accuracy" << std::endl;
+        for (size_t idx = 0; idx < num_pcs; ++idx) {
+            const auto & [pc, stats] = worst_pcs[idx];
+            std::ostringstream pc_str;
+            pc_str << "0x" << std::hex << pc;
+            os << "  " << std::left << std::setw(18) << pc_str.str() << std::right
+               << std::setw(14) << stats.branches << std::setw(14) << stats.mispredicts
+               << std::setw(10) << mpki(stats.mispredicts) << std::setw(11) << accuracy(stats)
+               << "%" << std::endl;
+        }
+        os << std::defaultfloat;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // ParallelBranchPredEval
+
+    ParallelBranchPredEval::ParallelBranchPredEval(
+        const std::vector<BranchPredEvaluator *> & evaluators)
+    {
+        workers_.reserve(evaluators.size());
+        for (auto * evaluator : evaluators) {
+            workers_.emplace_back(&ParallelBranchPredEval::worker_, this, evaluator);
+        }
+    }
+
+    ParallelBranchPredEval::~ParallelBranchPredEval()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [this] { return num_busy_ == 0; });
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto & worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void ParallelBranchPredEval::start(const BranchRecordList & branches)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sparta_assert(num_busy_ == 0, "Started a chunk before the previous one was done");
+            branches_ = &branches;
+            num_busy_ = workers_.size();
+            ++chunk_id_;
+        }
+        start_cv_.notify_all();
+    }
+
+    void ParallelBranchPredEval::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return num_busy_ == 0; });
+    }
+
+    void ParallelBranchPredEval::worker_(BranchPredEvaluator * evaluator)
+    {
+        uint64_t last_chunk_id = 0;
+        while (true) {
+            const BranchRecordList * branches = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return stop_ || (chunk_id_ != last_chunk_id); });
+                if (stop_) {
+                    return;
+                }
+                last_chunk_id = chunk_id_;
+                branches = branches_;
+            }
+
+            evaluator->evaluate(*branches);
+
+            bool last_done = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last_done = (--num_busy_ == 0);
+            }
+            if (last_done) {
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+} // namespace BranchPredictor
+} // namespace olympia
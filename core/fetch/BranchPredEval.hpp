@@ -0,0 +1,178 @@
+// <BranchPredEval.hpp> -*- C++ -*-
+
+//!
+//! \file BranchPredEval.hpp
+//! \brief Standalone (trace-only) evaluation of branch predictors
+//!
+
+/*
+ * This file defines a light weight harness that evaluates implementations of
+ * the Branch Prediction API without the pipeline model.  Only the branch
+ * records of an STF trace are read (stf::STFBranchReader); each branch is
+ * presented to the predictor as a fetch packet starting at the branch PC,
+ * and the predictor is immediately updated with the outcome.
+ *
+ * The predictor is scored on the direction and target of the branch:
+ * taken branches must be predicted taken (redirecting at the first
+ * instruction of the packet) to the right target, not taken branches
+ * must not be predicted taken.
+ * Results are reported as MPKI by branch class and per branch PC.
+ * */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "fetch/SimpleBranchPred.hpp"
+
+#include "stf-inc/stf_branch_reader.hpp"
+
+namespace olympia
+{
+namespace BranchPredictor
+{
+
+    using DefaultBranchPredictorIF = BranchPredictorIF<DefaultPrediction, DefaultUpdate, DefaultInput>;
+
+    enum class BranchClass : uint8_t
+    {
+        CONDITIONAL,
+        DIRECT_JUMP,
+        INDIRECT_JUMP,
+        CALL,
+        RETURN,
+        N_BRANCH_CLASSES
+    };
+
+    const char * getBranchClassName(BranchClass branch_class);
+
+    // A branch read from a trace
+    struct BranchRecord
+    {
+        uint64_t pc = 0;
+        uint64_t target = 0;
+        // Index of the branch in the instruction stream
+        uint64_t inst_index = 0;
+        BranchClass branch_class = BranchClass::CONDITIONAL;
+        // Size of the branch instruction, 2 for RVC branches
+        uint8_t inst_size = 4;
+        bool taken = false;
+    };
+
+    using BranchRecordList = std::vector<BranchRecord>;
+
+    // Reads the branch records of an STF trace, in chunks
+    class STFBranchStream
+    {
+    public:
+        STFBranchStream(const std::string & filename, bool skip_nonuser_mode,
+                        uint64_t inst_limit = 0);
+        ~STFBranchStream();
+
+        // Replace the contents of records with the next (up to) max_records
+        // branches.  Returns false when there are no more branches.
+        bool read(BranchRecordList & records, size_t max_records);
+
+        // Number of instructions covered by the branches read so far, all
+        // the instructions of the trace (up to the limit) once read()
+        // returned false
+        uint64_t getNumInsts() const { return num_insts_; }
+
+    private:
+        std::unique_ptr<stf::STFBranchReader> reader_;
+
+        // Always points to the *next* stf branch
+        stf::STFBranchReader::iterator next_it_;
+
+        const uint64_t inst_limit_;
+        uint64_t num_insts_ = 0;
+        bool done_ = false;
+    };
+
+    // Drives one predictor with branch records and collects its accuracy
+    class BranchPredEvaluator
+    {
+    public:
+        BranchPredEvaluator(const std::string & name, DefaultBranchPredictorIF & predictor) :
+            name_(name),
+            predictor_(predictor)
+        {}
+
+        void evaluate(const BranchRecord & branch);
+
+        void evaluate(const BranchRecordList & branches)
+        {
+            for (const auto & branch : branches) {
+                evaluate(branch);
+            }
+        }
+
+        const std::string & getName() const { return name_; }
+
+        uint64_t getNumBranches() const;
+        uint64_t getNumMispredicts() const;
+
+        // Report MPKI by branch class and the top_pcs most mispredicted PCs
+        void report(std::ostream & os, uint64_t num_insts, uint32_t top_pcs) const;
+
+    private:
+        struct BranchStats
+        {
+            uint64_t branches = 0;
+            uint64_t mispredicts = 0;
+        };
+
+        const std::string name_;
+        DefaultBranchPredictorIF & predictor_;
+
+        BranchStats class_stats_[static_cast<uint32_t>(BranchClass::N_BRANCH_CLASSES)];
+        std::unordered_map<uint64_t, BranchStats> pc_stats_;
+    };
+
+    // Drives several evaluators from the same branch records, with a
+    // thread per evaluator.  The branch records are shared read-only by all
+    // threads, so a trace is decoded once regardless of the number of
+    // predictors being evaluated.
+    //
+    // Usage: start() a chunk, read the next chunk into another buffer,
+    // then wait() before starting it.  The chunk passed to start() must
+    // not be modified until wait() returns.
+    class ParallelBranchPredEval
+    {
+    public:
+        explicit ParallelBranchPredEval(const std::vector<BranchPredEvaluator *> & evaluators);
+        ~ParallelBranchPredEval();
+
+        ParallelBranchPredEval(const ParallelBranchPredEval &) = delete;
+        ParallelBranchPredEval & operator=(const ParallelBranchPredEval &) = delete;
+
+        // Start evaluating branches on all evaluators
+        void start(const BranchRecordList & branches);
+
+        // Wait for all evaluators to finish the last started chunk
+        void wait();
+
+    private:
+        void worker_(BranchPredEvaluator * evaluator);
+
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable start_cv_;
+        std::condition_variable done_cv_;
+        const BranchRecordList * branches_ = nullptr;
+        // Incremented for every started chunk
+        uint64_t chunk_id_ = 0;
+        uint32_t num_busy_ = 0;
+        bool stop_ = false;
+    };
+
+} // namespace BranchPredictor
+} // namespace olympia
@@ -25,6 +25,8 @@
  * */
 #pragma once
 
+#include <cstdint>
+
 namespace olympia
 {
 namespace BranchPredictor
@@ -34,8 +36,11 @@ namespace BranchPredictor
     class BranchPredictorIF
     {
     public:
-        // TODO: create constexpr for bytes per compressed and uncompressed inst
-        static constexpr uint8_t bytes_per_inst = 4;
+        static constexpr uint8_t bytes_per_compressed_inst = 2;
+        static constexpr uint8_t bytes_per_uncompressed_inst = 4;
+        // With RVC, instructions are 2 byte aligned: predictors index
+        // their tables with the PC at this granularity
+        static constexpr uint8_t pc_granularity = bytes_per_compressed_inst;
         virtual ~BranchPredictorIF() { };
         virtual PredictionT getPrediction(const InputT &) = 0;
         virtual void updatePredictor(const UpdateT &) = 0;
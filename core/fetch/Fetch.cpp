@@ -9,6 +9,8 @@
 #include "fetch/Fetch.hpp"
 #include "InstGenerator.hpp"
 #include "decode/MavisUnit.hpp"
+#include "decode/UopCache.hpp"
+#include "decode/LoopBuffer.hpp"
 #include "OlympiaAllocators.hpp"
 
 #include "sparta/utils/MathUtils.hpp"
@@ -70,6 +72,27 @@ namespace olympia
                                                          workload->getValueAsString(),
                                                          skip_nonuser_mode_);
 
+        // The uop cache is optional and lives under decode
+        if (auto uop_cache_node = getContainer()->getParent()->getChild("decode.uop_cache", false);
+            uop_cache_node != nullptr)
+        {
+            auto uop_cache = uop_cache_node->getResourceAs<olympia::UopCache*>();
+            if (uop_cache->isEnabled())
+            {
+                uop_cache_ = uop_cache;
+            }
+        }
+
+        if (auto loop_buffer_node = getContainer()->getParent()->getChild("decode.loop_buffer", false);
+            loop_buffer_node != nullptr)
+        {
+            auto loop_buffer = loop_buffer_node->getResourceAs<olympia::LoopBuffer*>();
+            if (loop_buffer->isEnabled())
+            {
+                loop_buffer_ = loop_buffer;
+            }
+        }
+
         ev_fetch_insts->schedule(1);
     }
 
@@ -89,13 +112,16 @@ namespace olympia
             }
         }
 
-        if (credits_icache_ == 0 || ibuf_.empty() || fetch_buffer_.size() > fetch_buffer_capacity_) { return; }
+        if (ibuf_.empty() || fetch_buffer_.size() > fetch_buffer_capacity_) { return; }
+
+        // The frontend is gated while the loop buffer replays a loop
+        if (replayLoop_()) { return; }
 
-        // Gather instructions going to the same cacheblock
-        // NOTE: This doesn't deal with instructions straddling the blocks,
-        // they should be placed into the next group
+        // Gather instructions going to the same cacheblock.  Instructions
+        // straddling two blocks are placed into the group of the block
+        // holding their last bytes.
         auto different_blocks = [this](const auto &lhs, const auto &rhs) {
-            return (lhs->getPC() >> icache_block_shift_) != (rhs->getPC() >> icache_block_shift_) ||
+            return getLastBlock_(lhs) != getLastBlock_(rhs) ||
                     lhs->isTakenBranch() ||
                     rhs->isCoF();
         };
@@ -105,42 +131,142 @@ namespace olympia
             ++block_end;
         }
 
-        // Send to ICache
-        auto memory_access_ptr = sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator_,
-                                                                    ibuf_.front()->getPC());
+        // A uop cache hit does not need the ICache
+        const auto block_pc = ibuf_.front()->getPC();
+        const bool uop_cache_hit = (uop_cache_ != nullptr) &&
+            uop_cache_->contains(block_pc, std::distance(ibuf_.begin(), block_end));
 
-        InstGroupPtr fetch_group_ptr = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
+        // A group starting with an instruction straddling two blocks needs
+        // both blocks.  The first one was usually requested by the previous
+        // group, unless the instruction is the target of a branch.
+        const bool straddle_access = !uop_cache_hit &&
+            (getFirstBlock_(ibuf_.front()) != getLastBlock_(ibuf_.front())) &&
+            (getFirstBlock_(ibuf_.front()) != last_requested_block_);
+        const uint32_t icache_accesses = straddle_access ? 2 : 1;
+        if (credits_icache_ < icache_accesses && !uop_cache_hit) { return; }
 
-        // Place in fetch group for the memory access, and place in fetch buffer for later processing.
+        InstGroupPtr fetch_group_ptr = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
         for (auto iter = ibuf_.begin(); iter != block_end; iter++) {
             fetch_group_ptr->emplace_back(*iter);
-            fetch_buffer_.emplace_back(*iter);
+        }
+
+        // A hit only delivers the instructions held by the uop cache line,
+        // the younger ones stay in the ibuf for the next fetch
+        if (uop_cache_ != nullptr && uop_cache_->lookup(block_pc, fetch_group_ptr)) {
+            block_end = std::next(ibuf_.begin(), fetch_group_ptr->size());
+        }
+
+        // Place in fetch buffer for later processing.
+        for (const auto & inst : *fetch_group_ptr) {
+            fetch_buffer_.emplace_back(inst);
+            if (inst->isCompressed()) {
+                ++fetch_compressed_insts_;
+            }
+            if (getFirstBlock_(inst) != getLastBlock_(inst)) {
+                ++fetch_straddling_insts_;
+            }
         }
 
         // Set the last in block
         fetch_buffer_.back()->setLastInFetchBlock(true);
 
-        // Associate the icache transaction with the instructions
-        memory_access_ptr->setFetchGroup(fetch_group_ptr);
+        if (uop_cache_hit) {
+            // Decoded uops are available right away, skip the ICache
+            ILOG("uop cache hit: " << fetch_group_ptr);
+            for (auto & inst : *fetch_group_ptr) {
+                inst->setStatus(Inst::Status::FETCHED);
+            }
+            last_requested_block_ = INVALID_BLOCK;
+            ev_send_insts->schedule(sparta::Clock::Cycle(0));
+        }
+        else {
+            if (straddle_access) {
+                // Request the first block of the straddling instruction.  No
+                // instructions are associated with it, the group is
+                // released by the (younger) access to the second block.
+                auto first_block_access_ptr = sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(
+                    memory_access_allocator_, block_pc);
+                first_block_access_ptr->setFetchGroup(
+                    sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator));
+
+                ILOG("requesting first block of straddling inst: " << ibuf_.front());
+
+                out_fetch_icache_req_.send(first_block_access_ptr);
+                --credits_icache_;
+                ++fetch_straddle_accesses_;
+            }
+
+            // Send to ICache, addressing the block holding the group
+            const auto last_block = getLastBlock_(fetch_group_ptr->back());
+            const auto request_pc = (getFirstBlock_(ibuf_.front()) == last_block)
+                ? block_pc : (last_block << icache_block_shift_);
+            auto memory_access_ptr = sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(memory_access_allocator_,
+                                                                                              request_pc);
 
-        ILOG("requesting: " << fetch_group_ptr);
+            // Associate the icache transaction with the instructions
+            memory_access_ptr->setFetchGroup(fetch_group_ptr);
 
-        out_fetch_icache_req_.send(memory_access_ptr);
-        --credits_icache_;
+            ILOG("requesting: " << fetch_group_ptr);
+
+            out_fetch_icache_req_.send(memory_access_ptr);
+            --credits_icache_;
+            last_requested_block_ = last_block;
+        }
 
         // We want to track blocks, not instructions.
         ++fetch_buffer_occupancy_;
 
+        // Without ICache credits, only a uop cache hit can keep fetching
         ibuf_.erase(ibuf_.begin(), block_end);
-        if (!ibuf_.empty() && credits_icache_ > 0 && fetch_buffer_occupancy_ < fetch_buffer_capacity_) {
+        if (!ibuf_.empty() && (credits_icache_ > 0 || uop_cache_hit) &&
+            fetch_buffer_occupancy_ < fetch_buffer_capacity_) {
+            ev_fetch_insts->schedule(1);
+        }
+    }
+
+    bool Fetch::replayLoop_()
+    {
+        if (loop_buffer_ == nullptr || !loop_buffer_->isLocked()) { return false; }
+
+        InstGroupPtr replay_group_ptr = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
+        while (!ibuf_.empty() && (replay_group_ptr->size() < loop_buffer_->getDeliveryWidth()) &&
+               loop_buffer_->replay(ibuf_.front())) {
+            auto & inst = ibuf_.front();
+            inst->setLoopBufferReplay(true);
+            inst->setStatus(Inst::Status::FETCHED);
+            replay_group_ptr->emplace_back(inst);
+            fetch_buffer_.emplace_back(inst);
+            ibuf_.pop_front();
+        }
+
+        // Loop exit, fetch from the ICache again
+        if (replay_group_ptr->size() == 0) { return false; }
+
+        ILOG("loop buffer replay: " << replay_group_ptr);
+
+        last_requested_block_ = INVALID_BLOCK;
+
+        fetch_buffer_.back()->setLastInFetchBlock(true);
+        ++fetch_buffer_occupancy_;
+
+        ev_send_insts->schedule(sparta::Clock::Cycle(0));
+        if (fetch_buffer_occupancy_ < fetch_buffer_capacity_) {
             ev_fetch_insts->schedule(1);
         }
+        return true;
     }
 
     // Read instructions from the fetch buffer and send them to decode
     void Fetch::sendInstructions_()
     {
-        const uint32_t upper = std::min({credits_inst_queue_, num_insts_to_fetch_,
+        // Groups delivered by the uop cache or replayed by the loop buffer
+        // use their own delivery width
+        const bool from_uop_cache = !fetch_buffer_.empty() && fetch_buffer_.front()->isUopCacheHit();
+        const bool from_loop_buffer = !fetch_buffer_.empty() && fetch_buffer_.front()->isLoopBufferReplay();
+        const uint32_t width = from_loop_buffer ? loop_buffer_->getDeliveryWidth()
+                             : from_uop_cache ? uop_cache_->getDeliveryWidth()
+                             : num_insts_to_fetch_;
+        const uint32_t upper = std::min({credits_inst_queue_, width,
                                          static_cast<uint32_t>(fetch_buffer_.size())});
 
         // Nothing to send.  Don't need to schedule this again.
@@ -156,8 +282,15 @@ namespace olympia
                 break;
             }
 
-            // Don't group instructions where there has been a change of flow
-            if (entry->isCoF() && insts_to_send->size() > 0) {
+            // Don't mix uop cache, loop buffer and ICache instructions in a group
+            if (entry->isUopCacheHit() != from_uop_cache ||
+                entry->isLoopBufferReplay() != from_loop_buffer) {
+                break;
+            }
+
+            // Don't group instructions where there has been a change of flow,
+            // unless they are streamed by the loop buffer
+            if (entry->isCoF() && insts_to_send->size() > 0 && !from_loop_buffer) {
                 break;
             }
 
@@ -172,7 +305,7 @@ namespace olympia
             }
 
             // Only one taken branch per group
-            if (entry->isTakenBranch()) {
+            if (entry->isTakenBranch() && !from_loop_buffer) {
                 break;
             }
         }
@@ -259,6 +392,14 @@ namespace olympia
         ibuf_.clear();
         fetch_buffer_.clear();
 
+        // Stop replaying the loop, if any
+        if (loop_buffer_ != nullptr) {
+            loop_buffer_->flush();
+        }
+
+        // Fetch restarts at the redirect target
+        last_requested_block_ = INVALID_BLOCK;
+
         // No longer speculative
         // speculative_path_ = false;
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <limits>
 #include <string>
 #include "sparta/ports/DataPort.hpp"
 #include "sparta/events/SingleCycleUniqueEvent.hpp"
@@ -15,6 +16,7 @@
 #include "sparta/simulation/Unit.hpp"
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
 
 #include "CoreTypes.hpp"
 #include "InstGroup.hpp"
@@ -24,6 +26,8 @@
 namespace olympia
 {
     class InstGenerator;
+    class UopCache;
+    class LoopBuffer;
 
     /**
      * @file   Fetch.h
@@ -123,6 +127,22 @@ namespace olympia
         // Amount to left shift an Instructions PC to get the ICache block number
         const uint32_t icache_block_shift_;
 
+        // ICache block holding the first/last byte of an instruction.  They
+        // differ for an instruction straddling two blocks (only possible
+        // with RVC, as 32-bit instructions can then be 2 byte aligned)
+        uint64_t getFirstBlock_(const InstPtr & inst) const {
+            return inst->getPC() >> icache_block_shift_;
+        }
+        uint64_t getLastBlock_(const InstPtr & inst) const {
+            return (inst->getPC() + inst->getInstSize() - 1) >> icache_block_shift_;
+        }
+
+        // Last ICache block requested, a straddling instruction at the head
+        // of a group needs a second access unless its first block was
+        // the previous one requested
+        static constexpr uint64_t INVALID_BLOCK = std::numeric_limits<uint64_t>::max();
+        uint64_t last_requested_block_ = INVALID_BLOCK;
+
         // Buffers up instructions read from the tracefile
         std::deque<InstPtr> ibuf_;
 
@@ -148,6 +168,12 @@ namespace olympia
         // Instruction generation
         std::unique_ptr<InstGenerator> inst_generator_;
 
+        // Decoded uop cache, looked up in parallel with the ICache (nullptr if disabled)
+        UopCache * uop_cache_ = nullptr;
+
+        // Loop stream buffer, replays locked loops (nullptr if disabled)
+        LoopBuffer * loop_buffer_ = nullptr;
+
         // Fetch instruction event, the callback is set to request
         // instructions from the instruction cache and place them in the
         // fetch buffer.
@@ -169,6 +195,9 @@ namespace olympia
         // Read data from a trace
         void fetchInstruction_();
 
+        // Send the instructions of a locked loop to decode without the ICache
+        bool replayLoop_();
+
         // Read instructions from the fetch buffer and send them to decode
         void sendInstructions_();
 
@@ -188,6 +217,19 @@ namespace olympia
 
         // Are we fetching a speculative path?
         bool speculative_path_ = false;
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Counters
+        sparta::Counter fetch_compressed_insts_{&unit_stat_set_, "fetch_compressed_insts",
+                                                "Number of RVC instructions fetched",
+                                                sparta::Counter::COUNT_NORMAL};
+        sparta::Counter fetch_straddling_insts_{&unit_stat_set_, "fetch_straddling_insts",
+                                                "Number of instructions straddling two ICache blocks",
+                                                sparta::Counter::COUNT_NORMAL};
+        sparta::Counter fetch_straddle_accesses_{&unit_stat_set_, "fetch_straddle_accesses",
+                                                 "Extra ICache accesses for the first block of "
+                                                 "straddling instructions",
+                                                 sparta::Counter::COUNT_NORMAL};
     };
 
 }
@@ -0,0 +1,89 @@
+#include "GShareBranchPred.hpp"
+
+/*
+ * Prediction:
+ *    - index the PHT with (fetch PC ^ global history); the counter
+ *      gives the direction (> 1 is taken)
+ *    - look up the BTB with the fetch PC
+ *       - BTB hit: branch idx comes from the BTB entry, predicted_PC is
+ *         the BTB target if predicted taken, the fall through addr if not
+ *       - BTB miss: branch idx is the last instr of the FetchPacket and
+ *         predicted PC is the fall through addr of the FetchPacket
+ * Update:
+ *    - train the PHT counter selected by the same index as the prediction
+ *    - allocate/update the BTB entry for taken branches
+ *    - shift the outcome into the global history
+ *
+ */
+namespace olympia
+{
+namespace BranchPredictor
+{
+
+    GShareBranchPredictor::GShareBranchPredictor(uint32_t max_fetch_insts, uint32_t pht_entries,
+                                                 uint32_t history_bits, uint32_t btb_entries) :
+        max_fetch_insts_(max_fetch_insts),
+        pht_mask_(pht_entries - 1),
+        history_mask_((history_bits >= 64) ? ~0ull : ((1ull << history_bits) - 1)),
+        btb_mask_(btb_entries - 1),
+        pattern_history_table_(pht_entries, 1),
+        branch_target_buffer_(btb_entries)
+    {
+        sparta_assert((pht_entries != 0) && ((pht_entries & pht_mask_) == 0),
+                      "gshare pht_entries must be a power of 2: " << pht_entries);
+        sparta_assert((btb_entries != 0) && ((btb_entries & btb_mask_) == 0),
+                      "gshare btb_entries must be a power of 2: " << btb_entries);
+    }
+
+    uint32_t GShareBranchPredictor::getPHTIndex_(uint64_t fetch_PC) const {
+        return ((fetch_PC / pc_granularity) ^ global_history_) & pht_mask_;
+    }
+
+    uint32_t GShareBranchPredictor::getBTBIndex_(uint64_t fetch_PC) const {
+        return (fetch_PC / pc_granularity) & btb_mask_;
+    }
+
+    void GShareBranchPredictor::updatePredictor(const DefaultUpdate & update) {
+        uint8_t & counter = pattern_history_table_[getPHTIndex_(update.fetch_PC)];
+        TaggedBTBEntry & btb_entry = branch_target_buffer_[getBTBIndex_(update.fetch_PC)];
+        if (update.actually_taken) {
+            counter = (counter == 3) ? 3 : counter + 1;
+            btb_entry.valid = true;
+            btb_entry.fetch_PC = update.fetch_PC;
+            btb_entry.entry = BTBEntry(update.branch_idx, update.corrected_PC,
+                                       update.fall_through_PC);
+        } else {
+            counter = (counter == 0) ? 0 : counter - 1;
+            if (btb_entry.valid && (btb_entry.fetch_PC == update.fetch_PC)) {
+                btb_entry.entry.branch_idx = update.branch_idx;
+                btb_entry.entry.fall_through_PC = update.fall_through_PC;
+            }
+        }
+        global_history_ = ((global_history_ << 1) | (update.actually_taken ? 1 : 0)) & history_mask_;
+    }
+
+    DefaultPrediction GShareBranchPredictor::getPrediction(const DefaultInput & input) {
+        const bool predictTaken = (pattern_history_table_[getPHTIndex_(input.fetch_PC)] > 1);
+        const TaggedBTBEntry & btb_entry = branch_target_buffer_[getBTBIndex_(input.fetch_PC)];
+
+        DefaultPrediction prediction;
+        if (btb_entry.valid && (btb_entry.fetch_PC == input.fetch_PC)) {
+            // BTB hit
+            prediction.branch_idx = btb_entry.entry.branch_idx;
+            if (predictTaken) {
+                prediction.predicted_PC = btb_entry.entry.predicted_PC;
+            } else {
+                // fall through address
+                prediction.predicted_PC = btb_entry.entry.fall_through_PC;
+            }
+        } else {
+            // BTB miss
+            prediction.branch_idx = max_fetch_insts_;
+            prediction.predicted_PC = input.fetch_PC + max_fetch_insts_ * bytes_per_uncompressed_inst;
+        }
+
+        return prediction;
+    }
+
+} // namespace BranchPredictor
+} // namespace olympia
@@ -0,0 +1,62 @@
+// <GShareBranchPred.hpp> -*- C++ -*-
+
+//!
+//! \file GShareBranchPred.hpp
+//! \brief Class definition of a table-based gshare branch predictor
+//!
+
+/*
+ * This file defines the class GShareBranchPredictor, a finite-size
+ * predictor using the default Prediction/Update/Input classes of
+ * SimpleBranchPred.hpp.  Its direction predictor is a table of 2-bit
+ * saturating counters indexed by the fetch PC XOR'ed with the global
+ * branch history; targets come from a direct mapped, tagged BTB.
+ *
+ * Unlike the SimpleBranchPredictor, the table sizes and history length
+ * are configurable so that predictor sizes can be swept.
+ * */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "SimpleBranchPred.hpp"
+
+namespace olympia
+{
+namespace BranchPredictor
+{
+
+    class GShareBranchPredictor : public BranchPredictorIF<DefaultPrediction, DefaultUpdate, DefaultInput>
+    {
+    public:
+        // pht_entries and btb_entries must be powers of 2
+        GShareBranchPredictor(uint32_t max_fetch_insts, uint32_t pht_entries,
+                              uint32_t history_bits, uint32_t btb_entries);
+        DefaultPrediction getPrediction(const DefaultInput &);
+        void updatePredictor(const DefaultUpdate &);
+    private:
+        uint32_t getPHTIndex_(uint64_t fetch_PC) const;
+        uint32_t getBTBIndex_(uint64_t fetch_PC) const;
+
+        // maximum number of instructions in a FetchPacket
+        const uint32_t max_fetch_insts_;
+        const uint64_t pht_mask_;
+        const uint64_t history_mask_;
+        const uint64_t btb_mask_;
+
+        // global history of branch outcomes, youngest in bit 0
+        uint64_t global_history_ = 0;
+        // 2 bit saturating counters, initialized weakly not taken
+        std::vector<uint8_t> pattern_history_table_; // PHT
+
+        struct TaggedBTBEntry
+        {
+            bool valid = false;
+            uint64_t fetch_PC = 0;
+            BTBEntry entry;
+        };
+        std::vector<TaggedBTBEntry> branch_target_buffer_; // BTB
+    };
+
+} // namespace BranchPredictor
+} // namespace olympia
@@ -31,6 +31,7 @@ namespace BranchPredictor
 
         sparta_assert(branch_target_buffer_.find(update.fetch_PC) != branch_target_buffer_.end());
         branch_target_buffer_[update.fetch_PC].branch_idx = update.branch_idx;
+        branch_target_buffer_[update.fetch_PC].fall_through_PC = update.fall_through_PC;
         if (update.actually_taken) {
             branch_history_table_[update.fetch_PC] =
                 (branch_history_table_[update.fetch_PC] == 3) ? 3 :
@@ -61,15 +62,16 @@ namespace BranchPredictor
                 prediction.predicted_PC = btb_entry.predicted_PC;
             } else {
                 // fall through address
-                prediction.predicted_PC = input.fetch_PC + prediction.branch_idx + BranchPredictorIF::bytes_per_inst;
+                prediction.predicted_PC = btb_entry.fall_through_PC;
             }
         } else {
             // BTB miss
             prediction.branch_idx = max_fetch_insts_;
-            prediction.predicted_PC = input.fetch_PC + max_fetch_insts_ * bytes_per_inst;
+            prediction.predicted_PC = input.fetch_PC + max_fetch_insts_ * bytes_per_uncompressed_inst;
             // add new entry to BTB
             branch_target_buffer_.insert(std::pair<uint64_t,BTBEntry>(
-                input.fetch_PC, BTBEntry(prediction.branch_idx, prediction.predicted_PC)));
+                input.fetch_PC, BTBEntry(prediction.branch_idx, prediction.predicted_PC,
+                                         prediction.predicted_PC)));
         }
 
         return prediction;
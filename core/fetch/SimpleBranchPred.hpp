@@ -42,6 +42,8 @@ namespace BranchPredictor
         uint64_t fetch_PC = std::numeric_limits<uint64_t>::max();
         uint32_t branch_idx = std::numeric_limits<uint32_t>::max();
         uint64_t corrected_PC = std::numeric_limits<uint64_t>::max();
+        // PC of the instruction following the branch (branch PC + branch size)
+        uint64_t fall_through_PC = std::numeric_limits<uint64_t>::max();
         bool actually_taken = false;
     };
 
@@ -57,16 +59,19 @@ namespace BranchPredictor
     public:
         // use of BTBEntry in std:map operator [] requires default constructor
         BTBEntry() = default;
-        BTBEntry(uint32_t bidx, uint64_t predPC) :
+        BTBEntry(uint32_t bidx, uint64_t predPC, uint64_t fallThroughPC) :
             branch_idx(bidx),
-            predicted_PC(predPC)
+            predicted_PC(predPC),
+            fall_through_PC(fallThroughPC)
         {}
         uint32_t branch_idx {std::numeric_limits<uint32_t>::max()};
         uint64_t predicted_PC {std::numeric_limits<uint64_t>::max()};
+        // PC following the branch, the branch may be a 2 or 4 byte instruction
+        uint64_t fall_through_PC {std::numeric_limits<uint64_t>::max()};
     };
 
-    // Currently SimpleBranchPredictor works only with uncompressed instructions
-    // TODO: generalize SimpleBranchPredictor for both compressed and uncompressed instructions
+    // The size of a FetchPacket is not known on a BTB miss, the fall through
+    // addr assumes max_fetch_insts uncompressed instructions
     class SimpleBranchPredictor : public BranchPredictorIF<DefaultPrediction, DefaultUpdate, DefaultInput>
     {
     public:
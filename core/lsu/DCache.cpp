@@ -25,7 +25,11 @@ namespace olympia
         in_l2cache_credits_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(DCache, getCreditsFromL2Cache_, uint32_t));
 
+        in_vlsu_lookup_req_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(DCache, receiveMemReqFromVLSU_, MemoryAccessInfoPtr));
+
         in_lsu_lookup_req_.registerConsumerEvent(in_l2_cache_resp_receive_event_);
+        in_vlsu_lookup_req_.registerConsumerEvent(in_l2_cache_resp_receive_event_);
         in_l2cache_resp_.registerConsumerEvent(in_l2_cache_resp_receive_event_);
         setupL1Cache_(p);
 
@@ -68,8 +72,7 @@ namespace olympia
     // Access L1Cache
     bool DCache::dataLookup_(const MemoryAccessInfoPtr & mem_access_info_ptr)
     {
-        const InstPtr & inst_ptr = mem_access_info_ptr->getInstPtr();
-        uint64_t phyAddr = inst_ptr->getRAdr();
+        const uint64_t phyAddr = mem_access_info_ptr->getPhyAddr();
 
         bool cache_hit = false;
 
@@ -127,7 +130,7 @@ namespace olympia
         if (hit)
         {
             mem_access_info_ptr->setCacheState(MemoryAccessInfo::CacheState::HIT);
-            out_lsu_lookup_ack_.send(mem_access_info_ptr);
+            sendLookupAck_(mem_access_info_ptr, false);
             return;
         }
 
@@ -138,7 +141,7 @@ namespace olympia
         {
             // Should be Nack but miss should work for now
             mem_access_info_ptr->setCacheState(MemoryAccessInfo::CacheState::MISS);
-            out_lsu_lookup_ack_.send(mem_access_info_ptr);
+            sendLookupAck_(mem_access_info_ptr, false);
             return;
         }
 
@@ -177,14 +180,25 @@ namespace olympia
             (*mshr_it)->setMemRequest(mem_access_info_ptr);
             mem_access_info_ptr->setCacheState(MemoryAccessInfo::CacheState::MISS);
         }
-        out_lsu_lookup_ack_.send(mem_access_info_ptr);
+        sendLookupAck_(mem_access_info_ptr, false);
     }
 
     uint64_t DCache::getBlockAddr(const MemoryAccessInfoPtr & mem_access_info_ptr) const
     {
-        const InstPtr & inst_ptr = mem_access_info_ptr->getInstPtr();
-        const auto & inst_target_addr = inst_ptr->getRAdr();
-        return addr_decoder_->calcBlockAddr(inst_target_addr);
+        return addr_decoder_->calcBlockAddr(mem_access_info_ptr->getPhyAddr());
+    }
+
+    void DCache::sendLookupAck_(const MemoryAccessInfoPtr & mem_access_info_ptr,
+                                bool data_read)
+    {
+        if (!isVLSUReq_(mem_access_info_ptr))
+        {
+            out_lsu_lookup_ack_.send(mem_access_info_ptr);
+        }
+        else if (data_read)
+        {
+            out_vlsu_lookup_ack_.send(mem_access_info_ptr);
+        }
     }
 
     // Data read stage
@@ -204,19 +218,26 @@ namespace olympia
         {
             mem_access_info_ptr->setDataReady(true);
         }
+        else if (isVLSUReq_(mem_access_info_ptr)
+                 && !mem_access_info_ptr->getMSHRInfoIterator().isValid())
+        {
+            // No free MSHR, the VLSU looks the line up again
+            ILOG("No MSHR for the VLSU miss " << mem_access_info_ptr);
+        }
         else
         {
             if (!l2cache_busy_)
             {
                 out_l2cache_req_.send(mem_access_info_ptr);
                 l2cache_busy_ = true;
+                ++dl1_l2cache_reqs_;
             }
             else
             {
                 uev_mshr_request_.schedule(sparta::Clock::Cycle(1));
             }
         }
-        out_lsu_lookup_ack_.send(mem_access_info_ptr);
+        sendLookupAck_(mem_access_info_ptr, true);
     }
 
     void DCache::mshrRequest_()
@@ -237,6 +258,7 @@ namespace olympia
                         ILOG("Sending mshr request when not busy " << mem_info);
                         out_l2cache_req_.send(mem_info);
                         l2cache_busy_ = true;
+                        ++dl1_l2cache_reqs_;
                         break;
                     }
                 }
@@ -253,6 +275,13 @@ namespace olympia
         ILOG(mem_access_info_ptr << " in deallocate stage");
         if (mem_access_info_ptr->isRefill())
         {
+            // The refill is the VLSU's own line request, the VLSU waits
+            // for it instead of looking the line up again
+            if (isVLSUReq_(mem_access_info_ptr))
+            {
+                out_vlsu_lookup_ack_.send(mem_access_info_ptr);
+                return;
+            }
             const auto & mshr_it = mem_access_info_ptr->getMSHRInfoIterator();
             if (mshr_it.isValid())
             {
@@ -274,6 +303,15 @@ namespace olympia
         lsu_mem_access_info_ = memory_access_info_ptr;
     }
 
+    void DCache::receiveMemReqFromVLSU_(const MemoryAccessInfoPtr & memory_access_info_ptr)
+    {
+        ILOG("Received memory access request from VLSU " << memory_access_info_ptr);
+        sparta_assert(!vlsu_mem_access_info_.isValid(),
+                      "VLSU sent a request before the previous one was accepted");
+        in_l2_cache_resp_receive_event_.schedule();
+        vlsu_mem_access_info_ = memory_access_info_ptr;
+    }
+
     void DCache::receiveRespFromL2Cache_(const MemoryAccessInfoPtr & memory_access_info_ptr)
     {
         ILOG("Received cache refill " << memory_access_info_ptr);
@@ -303,6 +341,7 @@ namespace olympia
 
         const auto & it = mshr_file_.push_back(mshr_entry);
         mem_access_info_ptr->setMSHREntryInfoIterator(it);
+        ++dl1_mshr_allocations_;
     }
 
 } // namespace olympia
@@ -63,6 +63,17 @@ namespace olympia
 
         uint64_t getBlockAddr(const MemoryAccessInfoPtr & mem_access_info_ptr) const;
 
+        // Requests for vector uops come from the VLSU
+        static bool isVLSUReq_(const MemoryAccessInfoPtr & mem_access_info_ptr)
+        {
+            return mem_access_info_ptr->getInstPtr()->isVector();
+        }
+
+        // The LSU is acked at lookup and at data read, the VLSU only
+        // gets the outcome of the access (data read) and the refill of
+        // its misses
+        void sendLookupAck_(const MemoryAccessInfoPtr & mem_access_info_ptr, bool data_read);
+
         using MSHREntryInfoPtr = sparta::SpartaSharedPointer<MSHREntryInfo>;
         using MSHREntryIterator = sparta::Buffer<MSHREntryInfoPtr>::const_iterator;
         // Ongoing Refill request
@@ -90,6 +101,8 @@ namespace olympia
 
         void receiveMemReqFromLSU_(const MemoryAccessInfoPtr & memory_access_info_ptr);
 
+        void receiveMemReqFromVLSU_(const MemoryAccessInfoPtr & memory_access_info_ptr);
+
         void receiveAckFromL2Cache_(const uint32_t & ack);
 
         void receiveRespFromL2Cache_(const MemoryAccessInfoPtr & memory_access_info_ptr);
@@ -107,6 +120,9 @@ namespace olympia
         sparta::DataInPort<MemoryAccessInfoPtr> in_lsu_lookup_req_{&unit_port_set_,
                                                                    "in_lsu_lookup_req", 0};
 
+        sparta::DataInPort<MemoryAccessInfoPtr> in_vlsu_lookup_req_{&unit_port_set_,
+                                                                    "in_vlsu_lookup_req", 0};
+
         sparta::DataInPort<uint32_t> in_l2cache_credits_{&unit_port_set_, "in_l2cache_credits", 1};
 
         sparta::DataInPort<MemoryAccessInfoPtr> in_l2cache_resp_{&unit_port_set_,
@@ -123,6 +139,11 @@ namespace olympia
         sparta::DataOutPort<MemoryAccessInfoPtr> out_lsu_lookup_req_{&unit_port_set_,
                                                                      "out_lsu_lookup_req", 1};
 
+        sparta::SignalOutPort out_vlsu_free_req_{&unit_port_set_, "out_vlsu_free_req", 0};
+
+        sparta::DataOutPort<MemoryAccessInfoPtr> out_vlsu_lookup_ack_{&unit_port_set_,
+                                                                      "out_vlsu_lookup_ack", 0};
+
         sparta::DataOutPort<MemoryAccessInfoPtr> out_l2cache_req_{&unit_port_set_,
                                                                   "out_l2cache_req", 0};
 
@@ -134,7 +155,11 @@ namespace olympia
 
         sparta::utils::ValidValue<MemoryAccessInfoPtr> l2_mem_access_info_;
         sparta::utils::ValidValue<MemoryAccessInfoPtr> lsu_mem_access_info_;
+        sparta::utils::ValidValue<MemoryAccessInfoPtr> vlsu_mem_access_info_;
 
+        // Refills have priority over the LSU, the LSU over the VLSU.  A VLSU
+        // request waits for a free cycle and the VLSU is signaled when it
+        // enters the pipeline.
         void arbitrateL2LsuReq_()
         {
             if (l2_mem_access_info_.isValid())
@@ -143,12 +168,20 @@ namespace olympia
                 ILOG("Received Refill request " << mem_access_info_ptr);
                 cache_pipeline_.append(mem_access_info_ptr);
             }
-            else
+            else if (lsu_mem_access_info_.isValid())
             {
                 auto mem_access_info_ptr = lsu_mem_access_info_.getValue();
                 ILOG("Received LSU request " << mem_access_info_ptr);
                 cache_pipeline_.append(mem_access_info_ptr);
             }
+            else
+            {
+                auto mem_access_info_ptr = vlsu_mem_access_info_.getValue();
+                ILOG("Received VLSU request " << mem_access_info_ptr);
+                cache_pipeline_.append(mem_access_info_ptr);
+                vlsu_mem_access_info_.clearValid();
+                out_vlsu_free_req_.send();
+            }
             if (l2_mem_access_info_.isValid())
             {
                 l2_mem_access_info_.clearValid();
@@ -157,6 +190,10 @@ namespace olympia
             {
                 lsu_mem_access_info_.clearValid();
             }
+            if (vlsu_mem_access_info_.isValid())
+            {
+                in_l2_cache_resp_receive_event_.schedule(1);
+            }
             uev_mshr_request_.schedule(1);
         }
 
@@ -178,6 +215,14 @@ namespace olympia
                                                  "DL1 HIT/MISS Ratio", getStatisticSet(),
                                                  "dl1_cache_hits/dl1_cache_misses"};
 
+        sparta::Counter dl1_mshr_allocations_{getStatisticSet(), "dl1_mshr_allocations",
+                                              "Number of DL1 MSHR entries allocated",
+                                              sparta::Counter::COUNT_NORMAL};
+
+        sparta::Counter dl1_l2cache_reqs_{getStatisticSet(), "dl1_l2cache_reqs",
+                                          "Number of DL1 miss requests sent to the L2Cache",
+                                          sparta::Counter::COUNT_NORMAL};
+
         sparta::Buffer<MSHREntryInfoPtr> mshr_file_;
         MSHREntryInfoAllocator & mshr_entry_allocator_;
         void allocateMSHREntry_(const MemoryAccessInfoPtr & mem_access_info_ptr);
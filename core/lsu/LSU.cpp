@@ -536,6 +536,7 @@ namespace olympia
                 ILOG("Found forwarding store for load " << inst_ptr);
                 mem_access_info_ptr->setDataReady(true);
                 mem_access_info_ptr->setCacheState(MemoryAccessInfo::CacheState::HIT);
+                sendLoadSpecWakeup_(inst_ptr);
                 return;
             }
         }
@@ -564,6 +565,39 @@ namespace olympia
         }
 
         out_cache_lookup_req_.send(mem_access_info_ptr);
+        sendLoadSpecWakeup_(inst_ptr);
+    }
+
+    void LSU::sendLoadSpecWakeup_(const InstPtr & inst_ptr)
+    {
+        // A hit returns the data at the complete stage.  The consumers read
+        // their operands when they issue, so they are woken up in that cycle
+        if (!inst_ptr->isStoreInst() && out_load_spec_wakeup_.isBound())
+        {
+            ev_load_spec_wakeup_.preparePayload(inst_ptr)->schedule(complete_stage_
+                                                                    - cache_lookup_stage_);
+        }
+    }
+
+    void LSU::loadSpecWakeup_(const InstPtr & inst_ptr)
+    {
+        // The consumers in the issue queues assume a hit until the load
+        // completes
+        ILOG("Speculative wakeup of the consumers of " << inst_ptr);
+        out_load_spec_wakeup_.send(inst_ptr);
+    }
+
+    void LSU::sendLoadSpecCancel_(const InstPtr & inst_ptr)
+    {
+        if (!inst_ptr->isStoreInst() && out_load_spec_cancel_.isBound())
+        {
+            // A miss known before the wakeup leaves the consumers waiting,
+            // the ones already woken up are replayed
+            ev_load_spec_wakeup_.cancelIf([inst_ptr](const InstPtr & load) -> bool
+                                          { return load == inst_ptr; });
+            ILOG("Cancel the speculative wakeup of " << inst_ptr);
+            out_load_spec_cancel_.send(inst_ptr);
+        }
     }
 
     void LSU::getAckFromCache_(const MemoryAccessInfoPtr & mem_access_info_ptr)
@@ -641,6 +675,7 @@ namespace olympia
         if (false == mem_access_info_ptr->isCacheHit())
         {
             ILOG("Cannot complete inst, cache miss: " << mem_access_info_ptr);
+            sendLoadSpecCancel_(mem_access_info_ptr->getInstPtr());
             if (allow_speculative_load_exec_)
             {
                 updateInstReplayReady_(load_store_info_ptr);
@@ -839,6 +874,8 @@ namespace olympia
         { return criteria.includedInFlush(ldst_info_ptr->getInstPtr()); };
         uev_append_ready_.cancelIf(flush);
         uev_replay_ready_.cancelIf(flush);
+        ev_load_spec_wakeup_.cancelIf([&criteria](const InstPtr & inst_ptr) -> bool
+                                      { return criteria.includedInFlush(inst_ptr); });
 
         // Cancel issue event already scheduled if no ready-to-issue inst left after flush
         if (!isReadyToIssueInsts_())
@@ -1147,6 +1184,11 @@ namespace olympia
                 const auto & pipeline_inst = ldst_pipeline_[stage];
                 if (pipeline_inst == load_store_inst_info_ptr)
                 {
+                    if (stage >= cache_lookup_stage_)
+                    {
+                        // Its consumers may have been woken up
+                        sendLoadSpecCancel_(load_store_inst_info_ptr->getInstPtr());
+                    }
                     ldst_pipeline_.invalidateStage(stage);
                     return;
                 }
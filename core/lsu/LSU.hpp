@@ -133,6 +133,15 @@ namespace olympia
         sparta::DataOutPort<MemoryAccessInfoPtr> out_cache_lookup_req_{&unit_port_set_,
                                                                        "out_cache_lookup_req", 0};
 
+        // Speculative wakeup of the consumers of a load in the issue queues,
+        // sent when a hit would return the data, and its cancellation when
+        // the load misses
+        sparta::DataOutPort<InstPtr> out_load_spec_wakeup_{&unit_port_set_,
+                                                           "out_load_spec_wakeup", 0};
+
+        sparta::DataOutPort<InstPtr> out_load_spec_cancel_{&unit_port_set_,
+                                                           "out_load_spec_cancel", 0};
+
         ////////////////////////////////////////////////////////////////////////////////
         // Internal States
         ////////////////////////////////////////////////////////////////////////////////
@@ -203,6 +212,12 @@ namespace olympia
             &unit_event_set_, "append_ready",
             CREATE_SPARTA_HANDLER_WITH_DATA(LSU, appendReady_, LoadStoreInstInfoPtr)};
 
+        // Speculative wakeup of a load that looked up the cache, the L1 hit
+        // latency after the lookup
+        sparta::PayloadEvent<InstPtr> ev_load_spec_wakeup_{
+            &unit_event_set_, "load_spec_wakeup",
+            CREATE_SPARTA_HANDLER_WITH_DATA(LSU, loadSpecWakeup_, InstPtr)};
+
         ////////////////////////////////////////////////////////////////////////////////
         // Callbacks
         ////////////////////////////////////////////////////////////////////////////////
@@ -236,6 +251,11 @@ namespace olympia
         void handleCacheReadyReq_(const MemoryAccessInfoPtr & memory_access_info_ptr);
         void getAckFromCache_(const MemoryAccessInfoPtr & updated_memory_access_info_ptr);
 
+        // Wake up the consumers of a load assuming it hits, or cancel it
+        void sendLoadSpecWakeup_(const InstPtr & inst_ptr);
+        void loadSpecWakeup_(const InstPtr & inst_ptr);
+        void sendLoadSpecCancel_(const InstPtr & inst_ptr);
+
         // Perform cache read
         void handleCacheRead_();
         // Retire load/store instruction
@@ -0,0 +1,410 @@
+// <VLSU.cpp> -*- C++ -*-
+
+#include "sparta/utils/SpartaAssert.hpp"
+#include "VLSU.hpp"
+
+#include "OlympiaAllocators.hpp"
+
+#include <algorithm>
+
+namespace olympia
+{
+    const char VLSU::name[] = "vlsu";
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Constructor
+    ////////////////////////////////////////////////////////////////////////////////
+
+    VLSU::VLSU(sparta::TreeNode* node, const VLSUParameterSet* p) :
+        sparta::Unit(node),
+        vlsu_inst_queue_size_(p->vlsu_inst_queue_size),
+        line_size_(p->line_size),
+        miss_retry_delay_(p->miss_retry_delay),
+        memory_access_allocator_(sparta::notNull(OlympiaAllocators::getOlympiaAllocators(node))
+                                     ->memory_access_allocator)
+    {
+        sparta_assert(line_size_ != 0 && (line_size_ & (line_size_ - 1)) == 0,
+                      "vlsu line_size must be a power of 2: " << line_size_);
+        sparta_assert(miss_retry_delay_ > 0, "vlsu miss_retry_delay must be at least one cycle");
+
+        // Startup handler for sending initial credits
+        sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(VLSU, sendInitialCredits_));
+
+        in_vlsu_insts_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(VLSU, getInstsFromDispatch_, InstPtr));
+
+        in_reorder_flush_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(VLSU, handleFlush_, FlushManager::FlushingCriteria));
+
+        in_cache_lookup_ack_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(VLSU, getAckFromCache_, MemoryAccessInfoPtr));
+
+        in_cache_free_req_.registerConsumerHandler(CREATE_SPARTA_HANDLER(VLSU, cacheFreeReq_));
+
+        ILOG("VLSU construct: #" << node->getGroupIdx());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Callbacks
+    ////////////////////////////////////////////////////////////////////////////////
+
+    // Send initial credits (vlsu_inst_queue_size_) to Dispatch Unit
+    void VLSU::sendInitialCredits_()
+    {
+        // Vector loads/stores share the LSU's row of the scoreboard latency matrix
+        auto cpu_node = getContainer()->findAncestorByName("core.*");
+        if (cpu_node == nullptr)
+        {
+            cpu_node = getContainer()->getRoot();
+        }
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            scoreboard_views_[rf].reset(
+                new sparta::ScoreboardView("lsu", core_types::regfile_names[rf], cpu_node));
+        }
+
+        out_vlsu_credits_.send(vlsu_inst_queue_size_);
+        ILOG("VLSU initial credits for Dispatch Unit: " << vlsu_inst_queue_size_);
+    }
+
+    // Receive a new vector load/store uop from Dispatch Unit
+    void VLSU::getInstsFromDispatch_(const InstPtr & inst_ptr)
+    {
+        sparta_assert(vlsu_inst_queue_.size() < vlsu_inst_queue_size_,
+                      "VLSU received an instruction with no credits: " << inst_ptr);
+
+        auto & access = vlsu_inst_queue_.emplace_back();
+        access.inst = inst_ptr;
+        access.type = getAccessType_(inst_ptr);
+        generateLineAddrs_(access);
+
+        ILOG("New instruction added to the vlsu queue " << inst_ptr << " lines: "
+                                                        << access.line_addrs.size());
+        ++vlsu_insts_dispatched_;
+
+        handleOperandIssueCheck_(inst_ptr);
+    }
+
+    // Callback from Scoreboard to inform Operand Readiness
+    void VLSU::handleOperandIssueCheck_(const InstPtr & inst_ptr)
+    {
+        VectorMemAccess* access = findAccess_(inst_ptr);
+        if ((access == nullptr) || access->ready)
+        {
+            return;
+        }
+
+        // Address, index and store data operands
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            const auto reg_file = static_cast<core_types::RegFile>(rf);
+            auto operand_bits = inst_ptr->getSrcRegisterBitMask(reg_file);
+            operand_bits |= inst_ptr->getDataRegisterBitMask(reg_file);
+            if (!scoreboard_views_[rf]->isSet(operand_bits))
+            {
+                scoreboard_views_[rf]->registerReadyCallback(
+                    operand_bits, inst_ptr->getUniqueID(),
+                    [this, inst_ptr](const sparta::Scoreboard::RegisterBitMask &)
+                    { this->handleOperandIssueCheck_(inst_ptr); });
+                ILOG("Instruction NOT ready: " << inst_ptr << " Bits needed:"
+                                               << sparta::printBitSet(operand_bits)
+                                               << " rf: " << reg_file);
+                return;
+            }
+        }
+
+        ILOG("Instruction ready: " << inst_ptr);
+        access->ready = true;
+        inst_ptr->setStatus(Inst::Status::SCHEDULED);
+
+        if (access->line_addrs.empty())
+        {
+            completeAccess_(access);
+            return;
+        }
+        uev_issue_line_req_.schedule(sparta::Clock::Cycle(0));
+    }
+
+    void VLSU::issueLineReq_()
+    {
+        if (cache_busy_)
+        {
+            return;
+        }
+
+        // Missed lines go first, they hold the oldest accesses
+        while (!retry_lines_.empty())
+        {
+            const MemoryAccessInfoPtr mem_access_info_ptr = retry_lines_.front();
+            retry_lines_.pop_front();
+
+            auto line_buffer = line_buffers_.find(mem_access_info_ptr->getPhyAddr());
+            sparta_assert(line_buffer != line_buffers_.end());
+            sparta_assert(line_buffer->second.mem_access_info == mem_access_info_ptr);
+            // All the accesses to the line were flushed
+            if (line_buffer->second.waiters.empty())
+            {
+                line_buffers_.erase(line_buffer);
+                continue;
+            }
+            ++vlsu_line_retries_;
+            sendLineReq_(mem_access_info_ptr);
+            return;
+        }
+
+        for (auto & access : vlsu_inst_queue_)
+        {
+            if (!access.ready)
+            {
+                continue;
+            }
+            while (access.next_line < access.line_addrs.size())
+            {
+                const uint64_t line_addr = access.line_addrs[access.next_line++];
+                auto [line_buffer, inserted] = line_buffers_.try_emplace(line_addr);
+                line_buffer->second.waiters.emplace_back(&access);
+                if (!inserted)
+                {
+                    ILOG("Merging " << access.inst << " into the line request of 0x" << std::hex
+                                    << line_addr);
+                    ++vlsu_mshr_merges_;
+                    continue;
+                }
+                line_buffer->second.mem_access_info =
+                    sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(
+                        memory_access_allocator_, access.inst, line_addr);
+                sendLineReq_(line_buffer->second.mem_access_info);
+                return;
+            }
+        }
+    }
+
+    void VLSU::getAckFromCache_(const MemoryAccessInfoPtr & mem_access_info_ptr)
+    {
+        const uint64_t line_addr = mem_access_info_ptr->getPhyAddr();
+        ILOG("Cache ack: " << mem_access_info_ptr);
+
+        auto line_buffer = line_buffers_.find(line_addr);
+        const bool refill = mem_access_info_ptr->isRefill();
+        if (refill
+            && ((line_buffer == line_buffers_.end())
+                || (line_buffer->second.mem_access_info != mem_access_info_ptr)))
+        {
+            // Refill of a store line, stores complete when written to the MSHR
+            ILOG("No line request waiting for the refill " << mem_access_info_ptr);
+            return;
+        }
+        sparta_assert(line_buffer != line_buffers_.end(),
+                      "No line request for the DCache ack " << mem_access_info_ptr);
+
+        if (refill || mem_access_info_ptr->isDataReady())
+        {
+            const auto waiters = std::move(line_buffer->second.waiters);
+            line_buffers_.erase(line_buffer);
+            for (auto waiter : waiters)
+            {
+                lineDone_(waiter);
+            }
+            return;
+        }
+
+        if (!line_buffer->second.missed)
+        {
+            line_buffer->second.missed = true;
+            ++vlsu_line_misses_;
+        }
+        // The DCache acks the refill of the MSHR, without one the line
+        // is looked up again
+        if (!mem_access_info_ptr->getMSHRInfoIterator().isValid())
+        {
+            ev_retry_line_.preparePayload(mem_access_info_ptr)->schedule(miss_retry_delay_);
+        }
+    }
+
+    // The DCache accepted the last request
+    void VLSU::cacheFreeReq_()
+    {
+        cache_busy_ = false;
+        uev_issue_line_req_.schedule(sparta::Clock::Cycle(0));
+    }
+
+    void VLSU::retryLine_(const MemoryAccessInfoPtr & mem_access_info_ptr)
+    {
+        retry_lines_.emplace_back(mem_access_info_ptr);
+        uev_issue_line_req_.schedule(sparta::Clock::Cycle(1));
+    }
+
+    void VLSU::handleFlush_(const FlushManager::FlushingCriteria & criteria)
+    {
+        ILOG("Received flush " << criteria);
+
+        uint32_t credits_to_send = 0;
+        auto iter = vlsu_inst_queue_.begin();
+        while (iter != vlsu_inst_queue_.end())
+        {
+            if (!criteria.includedInFlush(iter->inst))
+            {
+                ++iter;
+                continue;
+            }
+
+            for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+            {
+                scoreboard_views_[rf]->clearCallbacks(iter->inst->getUniqueID());
+            }
+            // Outstanding lines are still accessed, without the flushed access
+            for (auto & [line_addr, line_buffer] : line_buffers_)
+            {
+                auto & waiters = line_buffer.waiters;
+                waiters.erase(std::remove(waiters.begin(), waiters.end(), &(*iter)),
+                              waiters.end());
+            }
+
+            ILOG("Flush Instruction ID: " << iter->inst->getUniqueID());
+            iter = vlsu_inst_queue_.erase(iter);
+            ++credits_to_send;
+            ++vlsu_flushes_;
+        }
+
+        if (credits_to_send > 0)
+        {
+            out_vlsu_credits_.send(credits_to_send);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Regular Function/Subroutine Call
+    ////////////////////////////////////////////////////////////////////////////////
+
+    VLSU::AccessType VLSU::getAccessType_(const InstPtr & inst_ptr)
+    {
+        // Addressing mode from the Mavis instruction types
+        if (inst_ptr->isVectorIndexed())
+        {
+            return AccessType::INDEXED;
+        }
+        if (inst_ptr->isVectorStrided())
+        {
+            return AccessType::STRIDED;
+        }
+        return AccessType::UNIT_STRIDE;
+    }
+
+    void VLSU::generateLineAddrs_(VectorMemAccess & access)
+    {
+        const InstPtr & inst_ptr = access.inst;
+        const auto & vector_config = inst_ptr->getVectorConfig();
+
+        // The memory access size of indexed accesses is the size of the
+        // index, their data elements are SEW wide
+        uint32_t eew = inst_ptr->getMemAccessSize();
+        if ((eew == 0) || (access.type == AccessType::INDEXED))
+        {
+            eew = vector_config->getSEW() / 8;
+        }
+
+        // Same split of the elements as the uop generator
+        const uint32_t elems_per_uop = vector_config->getVLEN() / vector_config->getSEW();
+        const uint32_t first_elem = inst_ptr->getUOpID() * elems_per_uop;
+        const uint32_t vl = vector_config->getVL();
+        const uint32_t num_elems = (first_elem < vl) ? std::min(elems_per_uop, vl - first_elem) : 0;
+
+        const uint64_t line_mask = ~static_cast<uint64_t>(line_size_ - 1);
+        // Same fake translation as Inst::getRAdr
+        auto add_line = [&access, line_mask](const uint64_t vaddr)
+        {
+            const uint64_t line_addr = (vaddr & line_mask) | 0x8000000;
+            if (std::find(access.line_addrs.begin(), access.line_addrs.end(), line_addr)
+                == access.line_addrs.end())
+            {
+                access.line_addrs.emplace_back(line_addr);
+            }
+        };
+
+        const auto & vaddrs = inst_ptr->getVAddrVector();
+        if ((access.type != AccessType::UNIT_STRIDE) && (vaddrs != nullptr))
+        {
+            const uint32_t last_elem =
+                std::min<uint32_t>(first_elem + num_elems, static_cast<uint32_t>(vaddrs->size()));
+            for (uint32_t elem = first_elem; elem < last_elem; ++elem)
+            {
+                add_line((*vaddrs)[elem]);
+            }
+        }
+        else if (num_elems > 0)
+        {
+            if (access.type != AccessType::UNIT_STRIDE)
+            {
+                ++vlsu_no_element_addrs_;
+            }
+            // Contiguous elements, one request per line
+            const uint64_t start = inst_ptr->getTargetVAddr() + first_elem * eew;
+            const uint64_t end = start + num_elems * eew - 1;
+            for (uint64_t line = start & line_mask; line <= (end & line_mask); line += line_size_)
+            {
+                add_line(line);
+            }
+        }
+
+        switch (access.type)
+        {
+            case AccessType::UNIT_STRIDE:
+                ++vlsu_unit_stride_insts_;
+                break;
+            case AccessType::STRIDED:
+                ++vlsu_strided_insts_;
+                break;
+            case AccessType::INDEXED:
+                ++vlsu_indexed_insts_;
+                break;
+        }
+        vlsu_elements_ += num_elems;
+        vlsu_line_accesses_ += access.line_addrs.size();
+        access.lines_pending = access.line_addrs.size();
+    }
+
+    void VLSU::sendLineReq_(const MemoryAccessInfoPtr & mem_access_info_ptr)
+    {
+        ILOG("Line request 0x" << std::hex << mem_access_info_ptr->getPhyAddr() << std::dec
+                               << " for " << mem_access_info_ptr->getInstPtr());
+        out_cache_lookup_req_.send(mem_access_info_ptr);
+        cache_busy_ = true;
+        ++vlsu_cache_reqs_;
+    }
+
+    VLSU::VectorMemAccess* VLSU::findAccess_(const InstPtr & inst_ptr)
+    {
+        auto access = std::find_if(vlsu_inst_queue_.begin(), vlsu_inst_queue_.end(),
+                                   [&inst_ptr](const VectorMemAccess & access)
+                                   { return access.inst == inst_ptr; });
+        return (access == vlsu_inst_queue_.end()) ? nullptr : &(*access);
+    }
+
+    void VLSU::lineDone_(VectorMemAccess* access)
+    {
+        sparta_assert(access->lines_pending > 0, "Too many lines accessed by " << access->inst);
+        if (--access->lines_pending == 0)
+        {
+            completeAccess_(access);
+        }
+    }
+
+    void VLSU::completeAccess_(VectorMemAccess* access)
+    {
+        const InstPtr inst_ptr = access->inst;
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            const auto & dest_bits =
+                inst_ptr->getDestRegisterBitMask(static_cast<core_types::RegFile>(rf));
+            scoreboard_views_[rf]->setReady(dest_bits);
+        }
+
+        vlsu_inst_queue_.remove_if([access](const VectorMemAccess & entry)
+                                   { return &entry == access; });
+
+        ILOG("Completing inst: " << inst_ptr);
+        inst_ptr->setStatus(Inst::Status::COMPLETED);
+        out_vlsu_credits_.send(1);
+        ++vlsu_insts_completed_;
+    }
+} // namespace olympia
@@ -0,0 +1,259 @@
+// <VLSU.hpp> -*- C++ -*-
+
+#pragma once
+
+#include "sparta/ports/PortSet.hpp"
+#include "sparta/ports/SignalPort.hpp"
+#include "sparta/ports/DataPort.hpp"
+#include "sparta/events/EventSet.hpp"
+#include "sparta/events/UniqueEvent.hpp"
+#include "sparta/events/PayloadEvent.hpp"
+#include "sparta/events/StartupEvent.hpp"
+#include "sparta/simulation/Unit.hpp"
+#include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/simulation/TreeNode.hpp"
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/utils/LogUtils.hpp"
+#include "sparta/resources/Scoreboard.hpp"
+
+#include "Inst.hpp"
+#include "CoreTypes.hpp"
+#include "FlushManager.hpp"
+#include "MemoryAccessInfo.hpp"
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace olympia
+{
+    /**
+     * @file VLSU.hpp
+     * @brief Vector load/store unit
+     *
+     * Vector load/store uops are dispatched to the VLSU (instead of an
+     * execution pipe) when no execution pipe of the core supports the
+     * vload/vstore targets.  Each uop is turned into cache line requests
+     * to the DCache, which it shares with the scalar LSU:
+     *
+     * - Unit-stride accesses are coalesced: the contiguous range of
+     *   elements of the uop is covered with line sized requests.
+     * - Strided and indexed (gather/scatter) accesses use the per-element
+     *   addresses of the trace; elements falling in the same line share a
+     *   request.
+     *
+     * A line request is tracked in a line buffer until the line is
+     * accessed; other accesses to that line merge into the line buffer
+     * instead of sending their own request (MSHR merging).  The line
+     * request is kept in the line buffer: a missed line waits for the
+     * DCache refill, it is only looked up again (with the same request,
+     * so that it keeps its MSHR) when the DCache had no free MSHR.
+     *
+     * Vector stores complete once their lines are written to the DCache,
+     * they do not wait for retirement.
+     */
+    class VLSU : public sparta::Unit
+    {
+      public:
+        //! \brief Parameters for VLSU model
+        class VLSUParameterSet : public sparta::ParameterSet
+        {
+          public:
+            VLSUParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
+
+            PARAMETER(uint32_t, vlsu_inst_queue_size, 8, "VLSU instruction queue size")
+            PARAMETER(uint32_t, line_size, 64,
+                      "Size of the line requests (power of 2), should match the DCache line size")
+            PARAMETER(uint32_t, miss_retry_delay, 4,
+                      "Cycles before a line that found no free DCache MSHR is looked up again")
+        };
+
+        /**
+         * @brief Constructor for VLSU
+         *
+         * @param node The node that represents (has a pointer to) the VLSU
+         * @param p The VLSU's parameter set
+         */
+        VLSU(sparta::TreeNode* node, const VLSUParameterSet* p);
+
+        //! \brief Name of this resource. Required by sparta::UnitFactory
+        static const char name[];
+
+        enum class AccessType
+        {
+            UNIT_STRIDE,
+            STRIDED,
+            INDEXED
+        };
+
+      private:
+        // A vector load/store uop in the VLSU
+        struct VectorMemAccess
+        {
+            InstPtr inst;
+            AccessType type = AccessType::UNIT_STRIDE;
+            // Lines touched by the uop, in access order
+            std::vector<uint64_t> line_addrs;
+            // Next line to request
+            uint32_t next_line = 0;
+            // Lines not accessed yet
+            uint32_t lines_pending = 0;
+            bool ready = false;
+        };
+
+        using VectorMemAccessList = std::list<VectorMemAccess>;
+
+        // An outstanding line request, and the accesses waiting on it
+        struct LineBuffer
+        {
+            // Sent to the DCache once, and again on a retry
+            MemoryAccessInfoPtr mem_access_info;
+            std::vector<VectorMemAccess*> waiters;
+            bool missed = false;
+        };
+
+        using ScoreboardViews =
+            std::array<std::unique_ptr<sparta::ScoreboardView>, core_types::N_REGFILES>;
+        ScoreboardViews scoreboard_views_;
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Ports
+        ////////////////////////////////////////////////////////////////////////////////
+        sparta::DataInPort<InstQueue::value_type> in_vlsu_insts_{&unit_port_set_,
+                                                                 "in_vlsu_insts", 1};
+
+        sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
+            &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
+
+        sparta::DataInPort<MemoryAccessInfoPtr> in_cache_lookup_ack_{&unit_port_set_,
+                                                                     "in_cache_lookup_ack", 0};
+
+        sparta::SignalInPort in_cache_free_req_{&unit_port_set_, "in_cache_free_req", 0};
+
+        sparta::DataOutPort<uint32_t> out_vlsu_credits_{&unit_port_set_, "out_vlsu_credits"};
+
+        sparta::DataOutPort<MemoryAccessInfoPtr> out_cache_lookup_req_{&unit_port_set_,
+                                                                       "out_cache_lookup_req", 0};
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Internal state
+        ////////////////////////////////////////////////////////////////////////////////
+        const uint32_t vlsu_inst_queue_size_;
+        const uint32_t line_size_;
+        const uint32_t miss_retry_delay_;
+
+        // Uops in program order
+        VectorMemAccessList vlsu_inst_queue_;
+
+        // Outstanding line requests, by line address
+        std::unordered_map<uint64_t, LineBuffer> line_buffers_;
+
+        // Line requests due for another lookup
+        std::deque<MemoryAccessInfoPtr> retry_lines_;
+
+        // A request is waiting for the DCache pipeline
+        bool cache_busy_ = false;
+
+        MemoryAccessInfoAllocator & memory_access_allocator_;
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Events
+        ////////////////////////////////////////////////////////////////////////////////
+        sparta::UniqueEvent<> uev_issue_line_req_{
+            &unit_event_set_, "issue_line_req", CREATE_SPARTA_HANDLER(VLSU, issueLineReq_)};
+
+        sparta::PayloadEvent<MemoryAccessInfoPtr> ev_retry_line_{
+            &unit_event_set_, "retry_line",
+            CREATE_SPARTA_HANDLER_WITH_DATA(VLSU, retryLine_, MemoryAccessInfoPtr)};
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Callbacks
+        ////////////////////////////////////////////////////////////////////////////////
+        void sendInitialCredits_();
+
+        void getInstsFromDispatch_(const InstPtr &);
+
+        void handleOperandIssueCheck_(const InstPtr &);
+
+        // Send the next line request to the DCache
+        void issueLineReq_();
+
+        void getAckFromCache_(const MemoryAccessInfoPtr &);
+
+        void cacheFreeReq_();
+
+        void retryLine_(const MemoryAccessInfoPtr &);
+
+        void handleFlush_(const FlushManager::FlushingCriteria &);
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Regular Function/Subroutine Call
+        ////////////////////////////////////////////////////////////////////////////////
+        static AccessType getAccessType_(const InstPtr &);
+
+        // Compute the lines touched by the elements of the uop
+        void generateLineAddrs_(VectorMemAccess & access);
+
+        void sendLineReq_(const MemoryAccessInfoPtr &);
+
+        VectorMemAccess* findAccess_(const InstPtr & inst);
+
+        void lineDone_(VectorMemAccess* access);
+
+        void completeAccess_(VectorMemAccess* access);
+
+        ////////////////////////////////////////////////////////////////////////////////
+        // Counters
+        ////////////////////////////////////////////////////////////////////////////////
+        sparta::Counter vlsu_insts_dispatched_{getStatisticSet(), "vlsu_insts_dispatched",
+                                               "Number of vector load/store uops dispatched",
+                                               sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_insts_completed_{getStatisticSet(), "vlsu_insts_completed",
+                                              "Number of vector load/store uops completed",
+                                              sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_unit_stride_insts_{getStatisticSet(), "vlsu_unit_stride_insts",
+                                                "Unit-stride vector load/store uops",
+                                                sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_strided_insts_{getStatisticSet(), "vlsu_strided_insts",
+                                            "Strided vector load/store uops",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_indexed_insts_{getStatisticSet(), "vlsu_indexed_insts",
+                                            "Indexed (gather/scatter) vector load/store uops",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_no_element_addrs_{
+            getStatisticSet(), "vlsu_no_element_addrs",
+            "Strided/indexed uops without element addresses in the trace (treated as unit-stride)",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_elements_{getStatisticSet(), "vlsu_elements",
+                                       "Elements accessed by vector loads/stores",
+                                       sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_line_accesses_{getStatisticSet(), "vlsu_line_accesses",
+                                            "Cache lines accessed by vector loads/stores",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::StatisticDef vlsu_elements_per_line_{
+            getStatisticSet(), "vlsu_elements_per_line",
+            "Average number of elements coalesced in a line access", getStatisticSet(),
+            "vlsu_elements/vlsu_line_accesses"};
+        sparta::Counter vlsu_cache_reqs_{getStatisticSet(), "vlsu_cache_reqs",
+                                         "Line requests sent to the DCache (including retries)",
+                                         sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_line_misses_{getStatisticSet(), "vlsu_line_misses",
+                                          "Lines that missed in the DCache",
+                                          sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_line_retries_{getStatisticSet(), "vlsu_line_retries",
+                                           "Line lookups retried for lack of a DCache MSHR",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_mshr_merges_{
+            getStatisticSet(), "vlsu_mshr_merges",
+            "Line accesses merged into an outstanding line request",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vlsu_flushes_{getStatisticSet(), "vlsu_flushes",
+                                      "Number of uops flushed from the VLSU",
+                                      sparta::Counter::COUNT_NORMAL};
+
+        friend class VLSUTester;
+    };
+
+    class VLSUTester;
+} // namespace olympia
@@ -10,6 +10,7 @@
 
 #include "CoreUtils.hpp"
 #include "Rename.hpp"
+#include "decode/MavisUnit.hpp"
 #include "sparta/events/StartupEvent.hpp"
 #include "sparta/app/FeatureConfiguration.hpp"
 #include "sparta/simulation/ResourceTreeNode.hpp"
@@ -23,6 +24,9 @@ namespace olympia
         num_to_rename_per_cycle_(p->num_to_rename),
         partial_rename_(p->partial_rename),
         enable_move_elimination_(p->move_elimination),
+        enable_idiom_elimination_(p->idiom_elimination),
+        enable_sanity_check_(p->enable_sanity_check),
+        num_checkpoints_(p->num_checkpoints),
         rename_histogram_(*getStatisticSet(), "rename_histogram", "Rename Stage Histogram",
                           [&p]()
                           {
@@ -35,6 +39,9 @@ namespace olympia
     {
         uop_queue_.enableCollection(node);
 
+        // The sanity check runs every cycle, it must not keep the simulation alive
+        ev_sanity_check_.setContinuing(false);
+
         // The path into the Rename block
         // - Instructions are received on the Uop Queue Append port
         // - Credits arrive on the dispatch queue credits port
@@ -83,9 +90,10 @@ namespace olympia
                 // that is "bare metal"
                 reference_counter.emplace_back(1);
             }
+            rcomp.freelist.resize(std::max(num_renames, num_regs_reserved));
             for (uint32_t j = num_regs_reserved; j < num_renames; ++j)
             {
-                rcomp.freelist.emplace(j);
+                rcomp.freelist.push(j);
                 reference_counter.emplace_back(0);
             }
         };
@@ -172,7 +180,10 @@ namespace olympia
         out_uop_queue_credits_.send(uop_queue_.capacity());
         stall_counters_[current_stall_].startCounting();
 
-        // ev_sanity_check_.schedule(1);
+        if (enable_sanity_check_)
+        {
+            ev_sanity_check_.schedule(1);
+        }
     }
 
     void Rename::creditsDispatchQueue_(const uint32_t & credits)
@@ -216,7 +227,7 @@ namespace olympia
                 {
                     ILOG("\tpushing " << dest.op_info.reg_file << " " << prev_dest
                                       << " on freelist for uid:" << inst_ptr->getUniqueID());
-                    rcomp.freelist.emplace(prev_dest);
+                    rcomp.freelist.push(prev_dest);
                 }
             }
         };
@@ -243,6 +254,15 @@ namespace olympia
             sparta_assert(oldest_inst->getUniqueID() == inst_ptr->getUniqueID(),
                           "ROB and rename inst_queue out of sync");
             inst_queue_.pop_front();
+
+            // The checkpoint of a retired branch is no longer needed.  A
+            // mispredicted branch flushes the younger instructions when it
+            // retires, its checkpoint is released by that flush
+            if (!checkpoints_.empty() && (checkpoints_.front().branch == inst_ptr)
+                && !inst_ptr->isMispredicted())
+            {
+                checkpoints_.pop_front();
+            }
         }
 
         if (credits_dispatch_ > 0 && (uop_queue_.size() > 0))
@@ -256,8 +276,30 @@ namespace olympia
     {
         ILOG("Got a flush call for " << criteria);
 
-        // Restore the rename map, reference counters and freelist by
-        // walking through the inst_queue_
+        // Drop the checkpoints of flushed branches.  If the flush starts
+        // right after the youngest remaining checkpointed branch, the
+        // rename map is restored from its checkpoint in one step.
+        // Otherwise it is restored by undoing the flushed destinations.
+        while (!checkpoints_.empty() && criteria.includedInFlush(checkpoints_.back().branch))
+        {
+            checkpoints_.pop_back();
+        }
+        const Checkpoint* restore_checkpoint = nullptr;
+        if (!checkpoints_.empty())
+        {
+            const uint64_t oldest_rename_idx = num_insts_renamed_ - inst_queue_.size();
+            const uint64_t next_inst_idx =
+                checkpoints_.back().branch_rename_idx - oldest_rename_idx + 1;
+            if ((next_inst_idx == inst_queue_.size())
+                || criteria.includedInFlush(inst_queue_[next_inst_idx]))
+            {
+                restore_checkpoint = &checkpoints_.back();
+            }
+        }
+
+        // Restore the reference counters and freelist (and the rename map
+        // without a checkpoint) by walking through the inst_queue_
+        uint32_t num_flushed = 0;
         // inst_queue_.erase((++it).base()) will advance the
         // reverse_iterator and then erase the element it previously
         // pointed to. it remains valid because we're erasing from the
@@ -284,8 +326,11 @@ namespace olympia
                         // restore rename table following a flush
                         if (!dest.op_info.is_x0)
                         {
-                            map_table_[dest.op_info.reg_file][dest.op_info.field_value] =
-                                dest.prev_dest;
+                            if (nullptr == restore_checkpoint)
+                            {
+                                map_table_[dest.op_info.reg_file][dest.op_info.field_value] =
+                                    dest.prev_dest;
+                            }
 
                             // free renamed PRF mapping when reference counter reaches zero
                             ILOG("\t\treclaiming: " << dest.op_info.reg_file
@@ -298,16 +343,41 @@ namespace olympia
                             {
                                 sparta_assert(dest.op_info.reg_file
                                               != core_types::RegFile::RF_INVALID);
-                                rcomp.freelist.emplace(dest.phys_reg);
+                                rcomp.freelist.push(dest.phys_reg);
                             }
                         }
                     }
 
                     inst_ptr->getRenameData().clear(static_cast<core_types::RegFile>(reg_file));
                 }
+                --num_insts_renamed_;
+                ++num_flushed;
             }
         }
 
+        if (num_flushed > 0)
+        {
+            if (restore_checkpoint)
+            {
+                ILOG("\trestoring rename map from the checkpoint of "
+                     << restore_checkpoint->branch);
+                map_table_ = restore_checkpoint->map_table;
+                ++checkpoint_restores_;
+            }
+            else
+            {
+                ++walk_recoveries_;
+                walk_recovery_insts_ += num_flushed;
+            }
+        }
+
+        // The checkpoint of the retired mispredicted branch causing the flush
+        if (!checkpoints_.empty()
+            && (checkpoints_.back().branch->getStatus() == Inst::Status::RETIRED))
+        {
+            checkpoints_.pop_back();
+        }
+
         setStall_(NO_DECODE_INSTS);
         if (false == uop_queue_.empty())
         {
@@ -348,6 +418,10 @@ namespace olympia
                         ++uop_queue_regcount_data_.cumulative_reg_counts[reg_file];
                     }
                 }
+                if (inst->isBranch())
+                {
+                    ++uop_queue_regcount_data_.num_branches;
+                }
                 if (partial_rename_)
                 {
                     // just need to update register counts for the
@@ -382,6 +456,14 @@ namespace olympia
                 break;
             }
         }
+
+        // Branches need a free checkpoint
+        if (enough_renames && (num_checkpoints_ > 0)
+            && (uop_queue_regcount_data_.num_branches > num_checkpoints_ - checkpoints_.size()))
+        {
+            enough_renames = false;
+            stall_reason = StallReason::NO_CHECKPOINTS;
+        }
         return {enough_renames, stall_reason};
     }
 
@@ -482,6 +564,13 @@ namespace olympia
             inst_queue_.emplace_back(inst_to_rename);
             rename_event_.collect(*inst_to_rename);
 
+            if ((num_checkpoints_ > 0) && inst_to_rename->isBranch())
+            {
+                checkpoints_.push_back({inst_to_rename, num_insts_renamed_, map_table_});
+                ++checkpoints_taken_;
+            }
+            ++num_insts_renamed_;
+
             if (partial_rename_)
             {
                 if (false == uop_queue_.empty())
@@ -581,9 +670,44 @@ namespace olympia
         }
     }
 
+    Rename::Idiom Rename::getIdiom_(const InstPtr & inst) const
+    {
+        const auto & srcs = inst->getSrcOpInfoListWithRegfile();
+        switch (inst->getMavisUid())
+        {
+        case MAVIS_UID_XOR:
+        case MAVIS_UID_SUB:
+        case MAVIS_UID_SUBW:
+            // Same register on both sides: the result is 0
+            if ((srcs.size() == 2) && (srcs[0].field_value == srcs[1].field_value))
+            {
+                return Idiom::ZERO;
+            }
+            break;
+        case MAVIS_UID_ADDI:
+        case MAVIS_UID_ADDIW:
+        case MAVIS_UID_ORI:
+        case MAVIS_UID_XORI:
+            // x0 combined with the immediate: the result is the immediate
+            if ((srcs.size() == 1) && srcs[0].is_x0)
+            {
+                return Idiom::CONSTANT;
+            }
+            break;
+        case MAVIS_UID_LUI:
+        case MAVIS_UID_C_LI:
+        case MAVIS_UID_C_LUI:
+            return Idiom::CONSTANT;
+        default:
+            break;
+        }
+        return Idiom::NONE;
+    }
+
     void Rename::renameDests_(const InstPtr & renaming_inst)
     {
         const auto & dests = renaming_inst->getDestOpInfoListWithRegfile();
+        const Idiom idiom = enable_idiom_elimination_ ? getIdiom_(renaming_inst) : Idiom::NONE;
         for (const auto & dest : dests)
         {
             const auto reg_file = dest.reg_file;
@@ -595,8 +719,6 @@ namespace olympia
                 auto & rcomp = regfile_components_[reg_file];
                 auto & freelist = rcomp.freelist;
 
-                sparta_assert(!freelist.empty(), "Freelist should never be empty");
-
                 uint32_t prf = std::numeric_limits<uint32_t>::max();
                 bool update_scoreboard = true;
 
@@ -633,9 +755,26 @@ namespace olympia
 
                 if (SPARTA_EXPECT_TRUE(false == move_eliminated))
                 {
-                    prf = freelist.front();
+                    prf = freelist.pop();
                     DLOG("popping: " << prf);
-                    freelist.pop();
+                }
+
+                // The value of an idiom is written at rename, its PRF is
+                // ready right away and the instruction skips execution
+                const bool idiom_eliminated = (false == move_eliminated) && (idiom != Idiom::NONE);
+                if (idiom_eliminated)
+                {
+                    renaming_inst->setTargetROB();
+                    ILOG("\tIdiom elim: " << renaming_inst);
+                    update_scoreboard = false;
+                    if (idiom == Idiom::ZERO)
+                    {
+                        ++zero_idiom_eliminations_;
+                    }
+                    else
+                    {
+                        ++constant_eliminations_;
+                    }
                 }
 
                 sparta_assert(
@@ -668,37 +807,40 @@ namespace olympia
                 {
                     renaming_inst->addDestRegister(std::forward<RenameData::Reg>(renamed_dst));
                 }
+
+                if (idiom_eliminated)
+                {
+                    core_types::RegisterBitMask bits;
+                    bits.set(prf);
+                    regfile_components_[reg_file].scoreboard->set(bits);
+                }
             }
         }
     }
 
     void Rename::sanityCheck_()
     {
-        // Check for duplications in the freelist
+        // Duplicates are caught when a PRF is pushed on the freelist, check
+        // that the freelist agrees with the reference counters: a PRF is free
+        // if and only if nothing references it (x0 has no PRF)
         for (auto reg_file = 0; reg_file < core_types::RegFile::N_REGFILES; ++reg_file)
         {
             const auto & rcomp = regfile_components_[reg_file];
-            if (false == rcomp.freelist.empty())
+            const auto & reference_counter = rcomp.reference_counter;
+            const uint32_t first_prf = (reg_file == core_types::RegFile::RF_INTEGER) ? 1 : 0;
+            uint32_t num_free = 0;
+            for (uint32_t prf = first_prf; prf < reference_counter.size(); ++prf)
             {
-                std::vector<uint32_t> sorted_fl;
-                // copy
-                auto flq = rcomp.freelist;
-                while (false == flq.empty())
-                {
-                    sorted_fl.emplace_back(flq.back());
-                    flq.pop();
-                }
-                std::sort(sorted_fl.begin(), sorted_fl.end());
-                uint32_t reg = sorted_fl.front();
-                auto next_reg = sorted_fl.begin();
-                ++next_reg;
-                while (next_reg != sorted_fl.end())
-                {
-                    sparta_assert(reg != *next_reg,
-                                  "Duplicate reg " << reg << " in regfile " << reg_file);
-                    reg = *next_reg;
-                }
+                const bool is_free = rcomp.freelist.isFree(prf);
+                sparta_assert(is_free == (reference_counter[prf].cnt == 0),
+                              "PRF " << prf << " in regfile " << reg_file << " is "
+                                     << (is_free ? "free" : "not free") << " with "
+                                     << reference_counter[prf].cnt << " references");
+                num_free += is_free;
             }
+            sparta_assert(num_free == rcomp.freelist.size(),
+                          "Freelist of regfile " << reg_file << " has " << rcomp.freelist.size()
+                                                 << " entries, " << num_free << " free PRFs");
         }
 
         ev_sanity_check_.schedule(1);
@@ -766,12 +908,10 @@ namespace olympia
         {
             output << "\n\t" << core_types::regfile_names[reg_file] << ":";
             char comma = ' ';
-            auto fln = regfile_components_[reg_file].freelist;
-            while (false == fln.empty())
+            for (const auto prf : regfile_components_[reg_file].freelist)
             {
-                output << comma << fln.front();
+                output << comma << prf;
                 comma = ',';
-                fln.pop();
             }
         }
         output << "\nref cnts:";
@@ -29,6 +29,7 @@
 #include "CoreTypes.hpp"
 #include "FlushManager.hpp"
 #include "InstGroup.hpp"
+#include "RenameFreeList.hpp"
 
 namespace olympia
 {
@@ -59,6 +60,16 @@ namespace olympia
             PARAMETER(bool, partial_rename, true,
                       "Rename all or partial instructions in a received group")
             PARAMETER(bool, move_elimination, false, "Enable move elimination")
+            PARAMETER(bool, idiom_elimination, false,
+                      "Enable idiom elimination: zero idioms (xor/sub rd, rs, rs) and constants "
+                      "(addi/addiw/ori/xori rd, x0, imm, lui, c.li, c.lui) complete at rename")
+            PARAMETER(uint32_t, num_checkpoints, 0,
+                      "Number of rename map checkpoints taken at branches, rename stalls on a "
+                      "branch when they are all in use.  0 disables checkpointing (flushes "
+                      "recover the map by walking the renamed instructions)")
+            PARAMETER(bool, enable_sanity_check, false,
+                      "Check every cycle that the free lists match the reference counters "
+                      "(debug, slow)")
         };
 
         /**
@@ -78,6 +89,9 @@ namespace olympia
         const uint32_t num_to_rename_per_cycle_;
         const bool partial_rename_;
         const bool enable_move_elimination_;
+        const bool enable_idiom_elimination_;
+        const bool enable_sanity_check_;
+        const uint32_t num_checkpoints_;
 
         sparta::DataInPort<InstGroupPtr> in_uop_queue_append_{&unit_port_set_,
                                                               "in_uop_queue_append", 1};
@@ -130,7 +144,7 @@ namespace olympia
             std::vector<Producer> reference_counter;
 
             // list of free PRF that are available to map
-            std::queue<uint32_t> freelist;
+            RenameFreeList freelist;
         };
 
         using RegfileComponentArray = std::vector<RegfileComponents>;
@@ -145,6 +159,29 @@ namespace olympia
         sparta::Counter move_eliminations_{getStatisticSet(), "move_eliminations",
                                            "Number of times Rename eliminated a move instruction",
                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter zero_idiom_eliminations_{
+            getStatisticSet(), "zero_idiom_eliminations",
+            "Number of times Rename eliminated a zero idiom (xor/sub rd, rs, rs)",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter constant_eliminations_{
+            getStatisticSet(), "constant_eliminations",
+            "Number of times Rename eliminated a constant load (li/lui)",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter checkpoints_taken_{getStatisticSet(), "checkpoints_taken",
+                                           "Number of rename map checkpoints taken at branches",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter checkpoint_restores_{
+            getStatisticSet(), "checkpoint_restores",
+            "Number of flushes that restored the rename map from a checkpoint",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter walk_recoveries_{
+            getStatisticSet(), "walk_recoveries",
+            "Number of flushes that restored the rename map by walking the flushed instructions",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter walk_recovery_insts_{
+            getStatisticSet(), "walk_recovery_insts",
+            "Number of flushed instructions walked to restore the rename map",
+            sparta::Counter::COUNT_NORMAL};
 
         ///////////////////////////////////////////////////////////////////////
         // Stall counters
@@ -155,6 +192,7 @@ namespace olympia
             NO_INTEGER_RENAMES,  // Out of integer renames
             NO_FLOAT_RENAMES,    // Out of float renames
             NO_VECTOR_RENAMES,   // Out of vector renames
+            NO_CHECKPOINTS,      // Out of rename map checkpoints
             NOT_STALLED,         // Made forward progress (dipatched
             // all instructions or no
             // instructions)
@@ -176,6 +214,9 @@ namespace olympia
                                   sparta::Counter::COUNT_NORMAL, getClock()),
              sparta::CycleCounter(getStatisticSet(), "stall_no_vector_renames", "No Vector Renames",
                                   sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_no_checkpoints",
+                                  "No Rename Map Checkpoints", sparta::Counter::COUNT_NORMAL,
+                                  getClock()),
              sparta::CycleCounter(getStatisticSet(), "stall_not_stalled",
                                   "Rename not stalled, all instructions renamed",
                                   sparta::Counter::COUNT_NORMAL, getClock())}};
@@ -185,6 +226,7 @@ namespace olympia
         struct RegCountData
         {
             uint32_t cumulative_reg_counts[core_types::RegFile::N_REGFILES] = {0};
+            uint32_t num_branches = 0;
         };
 
         // This is ordered roughly from most-accessed ->
@@ -195,11 +237,26 @@ namespace olympia
         RegCountData uop_queue_regcount_data_;
 
         // map of ARF -> PRF
-        std::array<std::array<uint32_t, NUM_RISCV_REGS_>, core_types::N_REGFILES> map_table_;
+        using MapTable = std::array<std::array<uint32_t, NUM_RISCV_REGS_>, core_types::N_REGFILES>;
+        MapTable map_table_;
 
         // Used to track inflight instructions for the purpose of recovering
         // the rename data structures
         std::deque<InstPtr> inst_queue_;
+
+        // Number of instructions ever pushed on inst_queue_, locates a
+        // checkpointed branch in inst_queue_
+        uint64_t num_insts_renamed_ = 0;
+
+        // Rename map after renaming a branch, oldest first
+        struct Checkpoint
+        {
+            InstPtr branch;
+            uint64_t branch_rename_idx = 0;
+            MapTable map_table;
+        };
+
+        std::deque<Checkpoint> checkpoints_;
         StallReason current_stall_ = StallReason::NO_DECODE_INSTS;
 
         void setStall_(const StallReason reason)
@@ -235,6 +292,17 @@ namespace olympia
         //! Rename the dests
         void renameDests_(const InstPtr &);
 
+        // Idioms whose result is known at rename
+        enum class Idiom
+        {
+            NONE,
+            ZERO,    // xor/sub rd, rs, rs
+            CONSTANT // addi rd, x0, imm, lui, ...
+        };
+
+        //! Which idiom, if any, is the instruction?
+        Idiom getIdiom_(const InstPtr &) const;
+
         //! Flush instructions.
         void handleFlush_(const FlushManager::FlushingCriteria & criteria);
 
@@ -272,6 +340,9 @@ namespace olympia
         case Rename::StallReason::NO_VECTOR_RENAMES:
             os << "NO_VECTOR_RENAMES";
             break;
+        case Rename::StallReason::NO_CHECKPOINTS:
+            os << "NO_CHECKPOINTS";
+            break;
         case Rename::StallReason::NOT_STALLED:
             os << "NOT_STALLED";
             break;
@@ -0,0 +1,71 @@
+// <RenameFreeList.hpp> -*- C++ -*-
+
+#pragma once
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include <cinttypes>
+#include <deque>
+#include <vector>
+
+namespace olympia
+{
+    /**
+     * @brief Free list of the PRFs of a register file
+     *
+     * PRFs are allocated in FIFO order.  A bitmap of the free PRFs
+     * mirrors the FIFO so a PRF freed twice is caught when it is
+     * pushed, and membership is a single lookup.
+     */
+    class RenameFreeList
+    {
+      public:
+        //! Grow the free list to track PRFs [0, num_regs)
+        void resize(const uint32_t num_regs) { free_bits_.resize(num_regs, false); }
+
+        //! Free a PRF
+        void push(const uint32_t prf)
+        {
+            sparta_assert(prf < free_bits_.size(), "PRF " << prf << " is out of the free list");
+            sparta_assert(free_bits_[prf] == false, "Duplicate reg " << prf << " in the free list");
+            free_bits_[prf] = true;
+            fifo_.emplace_back(prf);
+        }
+
+        //! Allocate the oldest free PRF
+        uint32_t pop()
+        {
+            sparta_assert(false == fifo_.empty(), "Freelist should never be empty");
+            const uint32_t prf = fifo_.front();
+            fifo_.pop_front();
+            free_bits_[prf] = false;
+            return prf;
+        }
+
+        //! Is the PRF free?
+        bool isFree(const uint32_t prf) const { return free_bits_[prf]; }
+
+        uint32_t front() const { return fifo_.front(); }
+
+        uint32_t back() const { return fifo_.back(); }
+
+        size_t size() const { return fifo_.size(); }
+
+        bool empty() const { return fifo_.empty(); }
+
+        //! Number of PRFs tracked by the bitmap
+        size_t capacity() const { return free_bits_.size(); }
+
+        //! Free PRFs, in allocation order
+        std::deque<uint32_t>::const_iterator begin() const { return fifo_.begin(); }
+
+        std::deque<uint32_t>::const_iterator end() const { return fifo_.end(); }
+
+      private:
+        // Free PRFs in allocation order
+        std::deque<uint32_t> fifo_;
+
+        // Bit per PRF, set when it is in the FIFO
+        std::vector<bool> free_bits_;
+    };
+} // namespace olympia
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 namespace olympia
 {
     /*!
@@ -11,15 +13,17 @@ namespace olympia
     class VectorConfig
     {
       public:
-        // Vector register length in bits
+        // Default vector register length in bits
         static const uint32_t VLEN = 1024;
 
         using PtrType = sparta::SpartaSharedPointer<VectorConfig>;
 
-        VectorConfig(uint32_t vl, uint32_t sew, uint32_t lmul, uint32_t vta) :
+        VectorConfig(uint32_t vl, uint32_t sew, uint32_t lmul, uint32_t vta,
+                     uint32_t vlen = VLEN) :
             sew_(sew),
             lmul_(lmul),
             vl_(vl),
+            vlen_(vlen),
             vlmax_(vlmax_formula_()),
             vta_(vta)
         {
@@ -53,6 +57,17 @@ namespace olympia
 
         uint32_t getVLMAX() const { return vlmax_; }
 
+        uint32_t getVLEN() const { return vlen_; }
+
+        // Move the configuration to an implementation with another VLEN,
+        // VL is capped by the new VLMAX (as a vset would on that implementation)
+        void setVLEN(uint32_t vlen)
+        {
+            vlen_ = vlen;
+            vlmax_ = vlmax_formula_();
+            vl_ = std::min(vl_, vlmax_);
+        }
+
         uint32_t getVTA() const { return vta_; }
 
         void setVTA(uint32_t vta) { vta_ = vta; }
@@ -61,10 +76,11 @@ namespace olympia
         uint32_t sew_ = 8;  // set element width
         uint32_t lmul_ = 1; // effective length
         uint32_t vl_ = 16;  // vector length
+        uint32_t vlen_ = VLEN; // vector register length in bits
         uint32_t vlmax_ = vlmax_formula_();
         bool vta_ = false; // vector tail agnostic, false = undisturbed, true = agnostic
 
-        uint32_t vlmax_formula_() { return (VLEN / sew_) * lmul_; }
+        uint32_t vlmax_formula_() { return (vlen_ / sew_) * lmul_; }
     };
 
     using VectorConfigPtr = VectorConfig::PtrType;
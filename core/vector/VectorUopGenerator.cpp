@@ -1,5 +1,6 @@
 #include "vector/VectorUopGenerator.hpp"
 #include "InstArchInfo.hpp"
+#include "OlympiaAllocators.hpp"
 #include "mavis/Mavis.h"
 #include "mavis/InstMetaData.h"
 #include "sparta/utils/LogUtils.hpp"
@@ -11,170 +12,253 @@ namespace olympia
     VectorUopGenerator::VectorUopGenerator(sparta::TreeNode* node,
                                            const VectorUopGeneratorParameterSet* p) :
         sparta::Unit(node),
+        inst_allocator_(
+            sparta::notNull(OlympiaAllocators::getOlympiaAllocators(node))->inst_allocator),
+        num_uops_per_cycle_(p->num_uops_per_cycle),
+        num_insts_per_cycle_(p->num_insts_per_cycle),
         vuops_generated_(&unit_stat_set_, "vector_uops_generated",
-                         "Number of vector uops generated", sparta::Counter::COUNT_NORMAL)
+                         "Number of vector uops generated", sparta::Counter::COUNT_NORMAL),
+        vuops_from_prototype_(&unit_stat_set_, "vector_uops_from_prototype",
+                              "Number of vector uops copied from a prototype uop",
+                              sparta::Counter::COUNT_NORMAL),
+        vuop_crack_cycles_(&unit_stat_set_, "vector_crack_cycles",
+                           "Number of cycles vector uops were generated",
+                           sparta::Counter::COUNT_NORMAL),
+        vuops_per_crack_cycle_(&unit_stat_set_, "vector_uops_per_crack_cycle",
+                               "Average vector uops generated per cracking cycle",
+                               &unit_stat_set_, "vector_uops_generated/vector_crack_cycles")
     {
-        // Vector elementwise uop generator, increment all src and dest register numbers
-        // For a "vadd.vv v12, v4,v8" with an LMUL of 4:
-        //    Uop 1: vadd.vv v12, v4, v8
-        //    Uop 2: vadd.vv v13, v5, v9
-        //    Uop 3: vadd.vv v14, v6, v10
-        //    Uop 4: vadd.vv v15, v7, v11
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::ELEMENTWISE,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::ELEMENTWISE>);
-
-        // Vector single dest uop generator, only increment all src register numbers
-        // For a "vmseq.vv v12, v4, v8" with an LMUL of 4:
-        //    Uop 1: vmseq.vv v12, v4, v8
-        //    Uop 2: vmseq.vv v12, v5, v9
-        //    Uop 3: vmseq.vv v12, v6, v10
-        //    Uop 4: vmseq.vv v12, v7, v11
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::SINGLE_DEST,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::SINGLE_DEST>);
-
-        // Vector single src uop generator, only increment dst register numbers
-        // For a "viota.m v0, v8" with an LMUL of 4:
-        //    Uop 1: viota.m v0, v8
-        //    Uop 2: viota.m v0, v9
-        //    Uop 3: viota.m v0, v10
-        //    Uop 4: viota.m v0, v11
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::SINGLE_SRC,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::SINGLE_SRC>);
-
-        // Vector wide uop generator, only increment src register numbers for even
-        // uops
-        // For a "vwmul.vv v12, v4, v8" with an LMUL of 4:
-        //    Uop 1: vwmul.vv v12, v4, v8
-        //    Uop 2: vwmul.vv v13, v4, v8
-        //    Uop 3: vwmul.vv v14, v6, v10
-        //    Uop 4: vwmul.vv v15, v6, v10
-        //    Uop 5: vwmul.vv v16, v8, v12
-        //    Uop 6: vwmul.vv v17, v8, v12
-        //    Uop 7: vwmul.vv v18, v10, v14
-        //    Uop 8: vwmul.vv v19, v10, v14
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::WIDENING,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::WIDENING>);
-
-        // Vector wide mixed uop generator
-        // For a "vwaddu.wv v12, v4, v8" with an LMUL of 4:
-        //    Uop 1: vwaddu.wv v12, v4, v8
-        //    Uop 2: vwaddu.wv v13, v5, v8
-        //    Uop 3: vwaddu.wv v14, v6, v10
-        //    Uop 4: vwaddu.wv v15, v7, v10
-        //    Uop 5: vwaddu.wv v16, v8, v12
-        //    Uop 6: vwaddu.wv v17, v9, v12
-        //    Uop 7: vwaddu.wv v18, v10, v14
-        //    Uop 8: vwaddu.wv v19, v11, v14
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::WIDENING_MIXED,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::WIDENING_MIXED>);
-
-        // Vector arithmetic multiply-add uop generator, add dest as source
-        // For a "vmacc.vv v12, v4, v8" with an LMUL of 4:
-        //    Uop 1: vmacc.vv v12, v4, v8, v12
-        //    Uop 2: vmacc.vv v13, v5, v9, v13
-        //    Uop 3: vmacc.vv v14, v6, v10, v14
-        //    Uop 4: vmacc.vv v15, v7, v11, v15
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::MAC,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::MAC>);
-
-        // Vector multiply-add wide dest uop generator
-        // For a "vwmacc.vv v12, v4, v8" with an LMUL of 4:
-        //    Uop 1: vwmacc.vv v12, v4, v8, v12
-        //    Uop 2: vwmacc.vv v13, v4, v8, v13
-        //    Uop 3: vwmacc.vv v14, v5, v9, v14
-        //    Uop 4: vwmacc.vv v15, v5, v9, v15
-        //    Uop 5: vwmacc.vv v16, v6, v10, v16
-        //    Uop 6: vwmacc.vv v17, v6, v10, v17
-        //    Uop 7: vwmacc.vv v18, v7, v11, v18
-        //    Uop 8: vwmacc.vv v19, v7, v11, v19
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::MAC_WIDE,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::MAC_WIDE>);
-
-        // Vector fixed point clip narrow uop generator
-        // For a "vnclipu.wv v0, v4, v8" with an LMUL of 4:
-        //    Uop 1: vnclipu.wv v0, v4, v5, v12
-        //    Uop 2: vnclipu.wv v1, v6, v7, v13
-        //    Uop 3: vnclipu.wv v2, v8, v9, v14
-        //    Uop 4: vnclipu.wv v3, v10, v11, v15
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::NARROWING,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::NARROWING>);
-
-        // Vector reduction uop generator
-        // For a "vredsum.vs v12, v8, v4" with an LMUL of 4:
-        //    Uop 1: vredsum.vs v12, v8, v4
-        //    Uop 2: vredsum.vs v13, v9, v5, v12
-        //    Uop 3: vredsum.vs v14, v10, v6, v13
-        //    Uop 4: vredsum.vs v15, v11, v7, v14
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::REDUCTION,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::REDUCTION>);
-
-        // Vector wide reduction uop generator
-        // For a "vwredsum.vs v20, v12, v4" with an LMUL of 4:
-        //    Uop 1: vredsum.vs v20, v12, v4
-        //    Uop 2: vredsum.vs v21, v12, v5, v20
-        //    Uop 3: vredsum.vs v22, v13, v6, v21
-        //    Uop 4: vredsum.vs v23, v13, v7, v22
-        //    Uop 5: vredsum.vs v24, v14, v8, v23
-        //    Uop 6: vredsum.vs v25, v14, v9, v24
-        //    Uop 7: vredsum.vs v26, v15, v10, v25
-        //    Uop 8: vredsum.vs v27, v15, v11, v26
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::REDUCTION_WIDE,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::REDUCTION_WIDE>);
-
-        // Vector fixed point clip narrow uop generator
-        // For a "vzext.vf4 v0, v4" with an LMUL of 4:
-        //    Uop 1: vzext.vf4 v0, v4
-        //    Uop 2: vzext.vf4 v1, v4
-        //    Uop 3: vzext.vf4 v2, v4
-        //    Uop 4: vzext.vf4 v3, v4
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::INT_EXT,
-            &VectorUopGenerator::generateUops_<InstArchInfo::UopGenType::INT_EXT>);
-
-        // Vector slide 1 up uop generator
-        // For a "vslide1up.vx v4, v8, x1" with an LMUL of 4:
-        //    Uop 1: vslide1up.vx v4, v8, x1
-        //    Uop 2: vslide1up.vx v4, v9, v8
-        //    Uop 3: vslide1up.vx v4, v10, v9
-        //    Uop 4: vslide1up.vx v4, v11, v10
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::SLIDE1UP,
-            &VectorUopGenerator::generateSlideUops_<InstArchInfo::UopGenType::SLIDE1UP>);
-
-        // Vector slide 1 down uop generator
-        // For a "vslide1ddown.vx v4, v8, x1" with an LMUL of 4:
-        //    Uop 1: vslide1down.vx v4, v8, v9
-        //    Uop 2: vslide1down.vx v4, v9, v10
-        //    Uop 3: vslide1down.vx v4, v10, v11
-        //    Uop 4: vslide1down.vx v4, v11, x1
-        uop_gen_function_map_.emplace(
-            InstArchInfo::UopGenType::SLIDE1DOWN,
-            &VectorUopGenerator::generateSlideUops_<InstArchInfo::UopGenType::SLIDE1DOWN>);
-
-        // Vector permute uop generator
-        // For a "vrgather.vv v20, v8, v4" with an LMUL of 4:
-        //    Load Uop 1: vrgather.vv v4, v5
-        //    Load Uop 1: vrgather.vv v6, v7
-        //     Exe Uop 1: vrgather.vv v20, v8
-        //     Exe Uop 2: vrgather.vv v21, v9
-        //     Exe Uop 3: vrgather.vv v22, v10
-        //     Exe Uop 4: vrgather.vv v23, v11
-        uop_gen_function_map_.emplace(InstArchInfo::UopGenType::PERMUTE,
-                                      &VectorUopGenerator::generatePermuteUops_);
+        sparta_assert(num_uops_per_cycle_ > 0,
+                      "vec_uop_gen num_uops_per_cycle must be greater than 0");
+        sparta_assert(num_insts_per_cycle_ > 0,
+                      "vec_uop_gen num_insts_per_cycle must be greater than 0");
+
+        // Precompute the uop templates of every uop gen type
+        uop_templates_.resize(getTemplateIndex_(InstArchInfo::UopGenType::NONE, 0, 0));
+        for (uint32_t type_idx = 0; type_idx < InstArchInfo::N_UOP_GEN_TYPES; ++type_idx)
+        {
+            const auto type = static_cast<InstArchInfo::UopGenType>(type_idx);
+            if (type == InstArchInfo::UopGenType::PERMUTE)
+            {
+                continue;
+            }
+            for (uint32_t num_uops = 1; num_uops <= InstArchInfo::N_VECTOR_UOPS; ++num_uops)
+            {
+                for (uint32_t ext_shift = 0; ext_shift < N_EXT_SHIFTS; ++ext_shift)
+                {
+                    if ((ext_shift != 0) && (type != InstArchInfo::UopGenType::INT_EXT))
+                    {
+                        continue;
+                    }
+                    auto & uop_template =
+                        uop_templates_[getTemplateIndex_(type, num_uops, ext_shift)];
+                    for (uint32_t uop_idx = 0; uop_idx < num_uops; ++uop_idx)
+                    {
+                        uop_template.emplace_back(
+                            buildUopTemplate_(type, uop_idx, num_uops, ext_shift));
+                    }
+                }
+            }
+        }
+    }
+
+    VectorUopGenerator::UopTemplate
+    VectorUopGenerator::buildUopTemplate_(InstArchInfo::UopGenType type, uint32_t uop_idx,
+                                          uint32_t num_uops, uint32_t ext_shift)
+    {
+        const uint32_t rs1 = static_cast<uint32_t>(OperandFieldID::RS1);
+        const uint32_t rs2 = static_cast<uint32_t>(OperandFieldID::RS2);
+
+        UopTemplate uop;
+        switch (type)
+        {
+            // Vector elementwise uop generator, increment all src and dest register numbers
+            // For a "vadd.vv v12, v4,v8" with an LMUL of 4:
+            //    Uop 1: vadd.vv v12, v4, v8
+            //    Uop 2: vadd.vv v13, v5, v9
+            //    Uop 3: vadd.vv v14, v6, v10
+            //    Uop 4: vadd.vv v15, v7, v11
+            case InstArchInfo::UopGenType::ELEMENTWISE:
+                uop.src_offsets.fill(uop_idx);
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector single dest uop generator, the uops keep the register
+            // numbers of the instruction
+            // For a "vmseq.vv v12, v4, v8" with an LMUL of 4:
+            //    Uop 1: vmseq.vv v12, v4, v8
+            //    Uop 2: vmseq.vv v12, v4, v8
+            //    Uop 3: vmseq.vv v12, v4, v8
+            //    Uop 4: vmseq.vv v12, v4, v8
+            case InstArchInfo::UopGenType::SINGLE_DEST:
+                break;
+
+            // Vector single src uop generator, only increment dst register numbers
+            // For a "viota.m v0, v8" with an LMUL of 4:
+            //    Uop 1: viota.m v0, v8
+            //    Uop 2: viota.m v0, v9
+            //    Uop 3: viota.m v0, v10
+            //    Uop 4: viota.m v0, v11
+            case InstArchInfo::UopGenType::SINGLE_SRC:
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector wide uop generator, only increment src register numbers for even
+            // uops
+            // For a "vwmul.vv v12, v4, v8" with an LMUL of 4:
+            //    Uop 1: vwmul.vv v12, v4, v8
+            //    Uop 2: vwmul.vv v13, v4, v8
+            //    Uop 3: vwmul.vv v14, v6, v10
+            //    Uop 4: vwmul.vv v15, v6, v10
+            //    Uop 5: vwmul.vv v16, v8, v12
+            //    Uop 6: vwmul.vv v17, v8, v12
+            //    Uop 7: vwmul.vv v18, v10, v14
+            //    Uop 8: vwmul.vv v19, v10, v14
+            case InstArchInfo::UopGenType::WIDENING:
+                uop.src_offsets.fill(uop_idx / 2);
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector wide mixed uop generator
+            // For a "vwaddu.wv v12, v4, v8" with an LMUL of 4:
+            //    Uop 1: vwaddu.wv v12, v4, v8
+            //    Uop 2: vwaddu.wv v13, v5, v8
+            //    Uop 3: vwaddu.wv v14, v6, v10
+            //    Uop 4: vwaddu.wv v15, v7, v10
+            //    Uop 5: vwaddu.wv v16, v8, v12
+            //    Uop 6: vwaddu.wv v17, v9, v12
+            //    Uop 7: vwaddu.wv v18, v10, v14
+            //    Uop 8: vwaddu.wv v19, v11, v14
+            case InstArchInfo::UopGenType::WIDENING_MIXED:
+                uop.src_offsets[rs2] = uop_idx;
+                uop.src_offsets[rs1] = uop_idx / 2;
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector fixed point clip narrow uop generator
+            // For a "vnclipu.wv v0, v4, v8" with an LMUL of 4:
+            //    Uop 1: vnclipu.wv v0, v4, v5, v12
+            //    Uop 2: vnclipu.wv v1, v6, v7, v13
+            //    Uop 3: vnclipu.wv v2, v8, v9, v14
+            //    Uop 4: vnclipu.wv v3, v10, v11, v15
+            case InstArchInfo::UopGenType::NARROWING:
+                uop.src_offsets[rs2] = uop_idx * 2;
+                uop.extra_src_offsets[rs2] = uop_idx * 2 + 1;
+                uop.src_offsets[rs1] = uop_idx;
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector arithmetic multiply-add uop generator, add dest as source
+            // For a "vmacc.vv v12, v4, v8" with an LMUL of 4:
+            //    Uop 1: vmacc.vv v12, v4, v8, v12
+            //    Uop 2: vmacc.vv v13, v5, v9, v13
+            //    Uop 3: vmacc.vv v14, v6, v10, v14
+            //    Uop 4: vmacc.vv v15, v7, v11, v15
+            case InstArchInfo::UopGenType::MAC:
+                uop.src_offsets.fill(uop_idx);
+                uop.dest_offset = uop_idx;
+                uop.dest_as_src = true;
+                break;
+
+            // Vector multiply-add wide dest uop generator
+            // For a "vwmacc.vv v12, v4, v8" with an LMUL of 4:
+            //    Uop 1: vwmacc.vv v12, v4, v8, v12
+            //    Uop 2: vwmacc.vv v13, v4, v8, v13
+            //    Uop 3: vwmacc.vv v14, v5, v9, v14
+            //    Uop 4: vwmacc.vv v15, v5, v9, v15
+            //    Uop 5: vwmacc.vv v16, v6, v10, v16
+            //    Uop 6: vwmacc.vv v17, v6, v10, v17
+            //    Uop 7: vwmacc.vv v18, v7, v11, v18
+            //    Uop 8: vwmacc.vv v19, v7, v11, v19
+            case InstArchInfo::UopGenType::MAC_WIDE:
+                uop.src_offsets.fill(uop_idx / 2);
+                uop.dest_offset = uop_idx;
+                uop.dest_as_src = true;
+                break;
+
+            // Vector reduction uop generator
+            // For a "vredsum.vs v12, v8, v4" with an LMUL of 4:
+            //    Uop 1: vredsum.vs v12, v8, v4
+            //    Uop 2: vredsum.vs v13, v9, v5, v12
+            //    Uop 3: vredsum.vs v14, v10, v6, v13
+            //    Uop 4: vredsum.vs v15, v11, v7, v14
+            case InstArchInfo::UopGenType::REDUCTION:
+                uop.src_offsets.fill(uop_idx);
+                uop.dest_offset = uop_idx;
+                uop.prev_dest_as_src = (uop_idx != 0);
+                break;
+
+            // Vector wide reduction uop generator
+            // For a "vwredsum.vs v20, v12, v4" with an LMUL of 4:
+            //    Uop 1: vredsum.vs v20, v12, v4
+            //    Uop 2: vredsum.vs v21, v12, v5, v20
+            //    Uop 3: vredsum.vs v22, v13, v6, v21
+            //    Uop 4: vredsum.vs v23, v13, v7, v22
+            //    Uop 5: vredsum.vs v24, v14, v8, v23
+            //    Uop 6: vredsum.vs v25, v14, v9, v24
+            //    Uop 7: vredsum.vs v26, v15, v10, v25
+            //    Uop 8: vredsum.vs v27, v15, v11, v26
+            case InstArchInfo::UopGenType::REDUCTION_WIDE:
+                uop.src_offsets[rs2] = uop_idx;
+                uop.src_offsets[rs1] = uop_idx / 2;
+                uop.dest_offset = uop_idx;
+                uop.prev_dest_as_src = (uop_idx != 0);
+                break;
+
+            // Vector integer extension uop generator
+            // For a "vzext.vf4 v0, v4" with an LMUL of 4:
+            //    Uop 1: vzext.vf4 v0, v4
+            //    Uop 2: vzext.vf4 v1, v4
+            //    Uop 3: vzext.vf4 v2, v4
+            //    Uop 4: vzext.vf4 v3, v4
+            case InstArchInfo::UopGenType::INT_EXT:
+                uop.src_offsets.fill(uop_idx >> ext_shift);
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector slide 1 up uop generator
+            // For a "vslide1up.vx v4, v8, x1" with an LMUL of 4:
+            //    Uop 1: vslide1up.vx v4, v8, x1
+            //    Uop 2: vslide1up.vx v4, v9, v8
+            //    Uop 3: vslide1up.vx v4, v10, v9
+            //    Uop 4: vslide1up.vx v4, v11, v10
+            case InstArchInfo::UopGenType::SLIDE1UP:
+                uop.src_offsets.fill(uop_idx);
+                if (uop_idx != 0)
+                {
+                    uop.extra_src_offsets.fill(static_cast<int32_t>(uop_idx) - 1);
+                }
+                uop.scalar_srcs = (uop_idx == 0);
+                uop.dest_offset = uop_idx;
+                break;
+
+            // Vector slide 1 down uop generator
+            // For a "vslide1ddown.vx v4, v8, x1" with an LMUL of 4:
+            //    Uop 1: vslide1down.vx v4, v8, v9
+            //    Uop 2: vslide1down.vx v4, v9, v10
+            //    Uop 3: vslide1down.vx v4, v10, v11
+            //    Uop 4: vslide1down.vx v4, v11, x1
+            case InstArchInfo::UopGenType::SLIDE1DOWN:
+                uop.src_offsets.fill(uop_idx);
+                if ((uop_idx + 1) != num_uops)
+                {
+                    uop.extra_src_offsets.fill(static_cast<int32_t>(uop_idx) + 1);
+                }
+                uop.scalar_srcs = ((uop_idx + 1) == num_uops);
+                uop.dest_offset = uop_idx;
+                break;
+
+            default:
+                sparta_assert(false, "No uop template for uop gen type "
+                                         << static_cast<uint32_t>(type));
+        }
+        return uop;
     }
 
     void VectorUopGenerator::onBindTreeLate_() { mavis_facade_ = getMavis(getContainer()); }
 
+    void VectorUopGenerator::onStartingTeardown_() { uop_prototypes_.clear(); }
+
     void VectorUopGenerator::setInst(const InstPtr & inst)
     {
         sparta_assert(current_inst_.isValid() == false,
@@ -189,25 +273,31 @@ namespace olympia
                       "Inst: " << inst << " uop gen type is none");
 
         const auto mavis_uid = inst->getMavisUid();
+        uint32_t ext_shift = 0;
         if (uop_gen_type == InstArchInfo::UopGenType::INT_EXT)
         {
             if ((mavis_uid == MAVIS_UID_VZEXTVF2) || (mavis_uid == MAVIS_UID_VSEXTVF2))
             {
-                addModifier("viext", 2);
+                ext_shift = 1;
             }
             else if ((mavis_uid == MAVIS_UID_VZEXTVF4) || (mavis_uid == MAVIS_UID_VSEXTVF4))
             {
-                addModifier("viext", 4);
+                ext_shift = 2;
             }
             else if ((mavis_uid == MAVIS_UID_VZEXTVF8) || (mavis_uid == MAVIS_UID_VSEXTVF8))
             {
-                addModifier("viext", 8);
+                ext_shift = 3;
+            }
+            else
+            {
+                throw sparta::SpartaException("Unknown extension factor for ")
+                    << inst->getMnemonic();
             }
         }
 
         // Number of vector elements processed by each uop
         const VectorConfigPtr & vector_config = inst->getVectorConfig();
-        const uint64_t num_elems_per_uop = VectorConfig::VLEN / vector_config->getSEW();
+        const uint64_t num_elems_per_uop = vector_config->getVLEN() / vector_config->getSEW();
         // FIXME: In some scenarios, we may need to generate uops that contain all tail elements,
         // for now let's optimize by generating uops based on the VL
         num_uops_to_generate_ = std::ceil((float)vector_config->getVL() / num_elems_per_uop);
@@ -250,7 +340,25 @@ namespace olympia
         sparta_assert(num_uops_to_generate_ <= InstArchInfo::N_VECTOR_UOPS,
                       "Cannot generate more than " << std::dec << InstArchInfo::N_VECTOR_UOPS
                                                    << " vector uops: " << inst);
+        sparta_assert(canAcceptInst(),
+                      "No uop expansion bandwidth left this cycle for " << inst);
         current_inst_ = inst;
+        ++insts_this_cycle_;
+
+        // Vector permute instructions have no uop template, they fail when
+        // generating their first uop
+        const uint32_t template_idx =
+            getTemplateIndex_(uop_gen_type, num_uops_to_generate_, ext_shift);
+        current_template_ = &uop_templates_[template_idx];
+
+        // The operands of an encoded instruction only depend on its opcode, its
+        // uops can be copied from the ones made for a previous instance
+        if (inst->getOpCode() != 0)
+        {
+            const uint64_t key = (static_cast<uint64_t>(inst->getOpCode()) << 32) | template_idx;
+            current_prototypes_ = &uop_prototypes_[key];
+        }
+
         ILOG(current_inst_ << " (" << vector_config << ") is being split into "
                            << num_uops_to_generate_ << " UOPs");
     }
@@ -262,10 +370,42 @@ namespace olympia
         const auto uop_gen_type = current_inst_.getValue()->getUopGenType();
         sparta_assert(uop_gen_type <= InstArchInfo::UopGenType::NONE,
                       "Inst: " << current_inst_ << " uop gen type is unknown");
+        sparta_assert(uop_gen_type != InstArchInfo::UopGenType::PERMUTE,
+                      "Vector permute uop generation is currently not supported!");
+        sparta_assert(canGenerateUop(), "No uop expansion bandwidth left this cycle for "
+                                            << current_inst_);
+
+        // An instruction cracked over several cycles uses instruction
+        // bandwidth in each of them
+        if (uops_this_cycle_ == 0)
+        {
+            ++vuop_crack_cycles_;
+            if (num_uops_generated_ != 0)
+            {
+                ++insts_this_cycle_;
+            }
+        }
+        ++uops_this_cycle_;
 
         // Generate uop
-        auto uop_gen_func = uop_gen_function_map_.at(uop_gen_type);
-        const InstPtr uop = uop_gen_func(this);
+        InstPtr uop;
+        if ((current_prototypes_ != nullptr)
+            && ((*current_prototypes_)[num_uops_generated_] != nullptr))
+        {
+            uop = sparta::allocate_sparta_shared_pointer<Inst>(
+                inst_allocator_, *(*current_prototypes_)[num_uops_generated_]);
+            ++vuops_from_prototype_;
+        }
+        else
+        {
+            uop = makeUop_((*current_template_)[num_uops_generated_]);
+            if (current_prototypes_ != nullptr)
+            {
+                // Keep a pristine copy, the uop itself goes down the pipe
+                (*current_prototypes_)[num_uops_generated_] =
+                    sparta::allocate_sparta_shared_pointer<Inst>(inst_allocator_, *uop);
+            }
+        }
 
         // setting UOp instructions to have the same UID and PID as parent instruction
         uop->setUniqueID(current_inst_.getValue()->getUniqueID());
@@ -275,6 +415,13 @@ namespace olympia
         uop->setVectorConfig(vector_config);
         uop->setUOpID(num_uops_generated_);
 
+        // Memory uops compute their element addresses from the parent's
+        if (current_inst_.getValue()->isLoadInst() || current_inst_.getValue()->isStoreInst())
+        {
+            uop->setTargetVAddr(current_inst_.getValue()->getTargetVAddr());
+            uop->setVAddrVector(current_inst_.getValue()->getVAddrVector());
+        }
+
         // Set weak pointer to parent vector instruction
         sparta::SpartaWeakPointer<olympia::Inst> parent_weak_ptr = current_inst_.getValue();
         uop->setUOpParent(parent_weak_ptr);
@@ -297,191 +444,72 @@ namespace olympia
         return uop;
     }
 
-    template <InstArchInfo::UopGenType Type> InstPtr VectorUopGenerator::generateUops_()
+    // Apply a uop template to the operands of the current instruction
+    InstPtr VectorUopGenerator::makeUop_(const UopTemplate & uop_template)
     {
-        sparta_assert(current_inst_.isValid(),
-                      "Cannot generate uops, current instruction is not set");
-        auto srcs = current_inst_.getValue()->getSourceOpInfoList();
+        uop_srcs_.clear();
+        uop_extra_srcs_.clear();
+        uop_dests_.clear();
 
-        mavis::OperandInfo::Element src_rs3;
-        for (auto & src : srcs)
+        // The extra sources go after all of the sources of the parent
+        for (const auto & src : current_inst_.getValue()->getSourceOpInfoList())
         {
-            if (src.operand_type != mavis::InstMetaData::OperandTypes::VECTOR
-                || Type == InstArchInfo::UopGenType::SINGLE_SRC)
+            if (src.operand_type != mavis::InstMetaData::OperandTypes::VECTOR)
             {
-                continue;
-            }
-
-            if constexpr (Type == InstArchInfo::UopGenType::ELEMENTWISE
-                          || Type == InstArchInfo::UopGenType::MAC
-                          || Type == InstArchInfo::UopGenType::REDUCTION)
-            {
-                src.field_value += num_uops_generated_;
-            }
-            else if constexpr (Type == InstArchInfo::UopGenType::WIDENING
-                               || Type == InstArchInfo::UopGenType::MAC_WIDE)
-            {
-                src.field_value += num_uops_generated_ / 2;
-            }
-            else if constexpr ((Type == InstArchInfo::UopGenType::WIDENING_MIXED)
-                               || (Type == InstArchInfo::UopGenType::REDUCTION_WIDE))
-            {
-                if (src.field_id == mavis::InstMetaData::OperandFieldID::RS2)
-                {
-                    src.field_value += num_uops_generated_;
-                }
-                else if (src.field_id == mavis::InstMetaData::OperandFieldID::RS1)
-                {
-                    src.field_value += num_uops_generated_ / 2;
-                }
-            }
-            else if constexpr (Type == InstArchInfo::UopGenType::NARROWING)
-            {
-                if (src.field_id == mavis::InstMetaData::OperandFieldID::RS2)
-                {
-                    src_rs3 = src;
-                    src.field_value += num_uops_generated_ * 2;
-                    src_rs3.field_value = src.field_value + 1;
-                }
-                else if (src.field_id == mavis::InstMetaData::OperandFieldID::RS1)
+                if (uop_template.scalar_srcs)
                 {
-                    src.field_value += num_uops_generated_;
+                    uop_srcs_.emplace_back(src);
                 }
+                continue;
             }
-            else if constexpr (Type == InstArchInfo::UopGenType::INT_EXT)
+
+            const uint32_t field = static_cast<uint32_t>(src.field_id);
+            sparta_assert(field < N_SRC_FIELDS, "Unexpected vector source field: " << field);
+            uop_srcs_.emplace_back(src.field_id, src.operand_type,
+                                   src.field_value + uop_template.src_offsets[field]);
+            if (uop_template.extra_src_offsets[field] != NO_EXTRA_SRC)
             {
-                auto ext = getModifier("viext");
-                if (!ext)
-                {
-                    throw sparta::SpartaException("Modifier at current instruction doesnt exist.");
-                }
-                src.field_value += num_uops_generated_ / *ext;
+                uop_extra_srcs_.emplace_back(OperandFieldID::RS3, src.operand_type,
+                                        src.field_value + uop_template.extra_src_offsets[field]);
             }
         }
+        uop_srcs_.insert(uop_srcs_.end(), uop_extra_srcs_.begin(), uop_extra_srcs_.end());
 
-        // For narrowing insturction,
-        if constexpr (Type == InstArchInfo::UopGenType::NARROWING)
+        if (current_inst_.getValue()->getUopGenType() == InstArchInfo::UopGenType::NARROWING)
         {
-            sparta_assert(src_rs3.field_id != mavis::InstMetaData::OperandFieldID::NONE,
+            sparta_assert(!uop_extra_srcs_.empty(),
                           "Vector narrowing instructions need to include an RS3 operand!");
-            srcs.emplace_back(mavis::InstMetaData::OperandFieldID::RS3, src_rs3.operand_type,
-                              src_rs3.field_value);
         }
 
         // Add a destination to the list of sources
-        auto add_dest_as_src = [](auto & srcs, auto & dest)
+        auto add_dest_as_src = [this](const mavis::OperandInfo::Element & dest, uint64_t value)
         {
             // OperandFieldID is an enum with RS1 = 0, RS2 = 1, etc. with a max RS of RS4
-            using OperandFieldID = mavis::InstMetaData::OperandFieldID;
-            const OperandFieldID field_id = static_cast<OperandFieldID>(srcs.size());
+            const OperandFieldID field_id = static_cast<OperandFieldID>(uop_srcs_.size());
             sparta_assert(
                 field_id <= OperandFieldID::RS_MAX,
                 "Mavis does not support instructions with more than "
                     << std::dec
                     << static_cast<std::underlying_type_t<OperandFieldID>>(OperandFieldID::RS_MAX)
                     << " sources");
-            srcs.emplace_back(field_id, dest.operand_type, dest.field_value);
+            uop_srcs_.emplace_back(field_id, dest.operand_type, value);
         };
 
-        auto dests = current_inst_.getValue()->getDestOpInfoList();
-        if constexpr (Type != InstArchInfo::UopGenType::SINGLE_DEST)
+        for (const auto & dest : current_inst_.getValue()->getDestOpInfoList())
         {
-            for (auto & dest : dests)
+            const uint64_t dest_value = dest.field_value + uop_template.dest_offset;
+            uop_dests_.emplace_back(dest.field_id, dest.operand_type, dest_value);
+            if (uop_template.dest_as_src)
             {
-                dest.field_value += num_uops_generated_;
-
-                if constexpr (Type == InstArchInfo::UopGenType::MAC
-                              || Type == InstArchInfo::UopGenType::MAC_WIDE)
-                {
-                    add_dest_as_src(srcs, dest);
-                }
-                if constexpr ((Type == InstArchInfo::UopGenType::REDUCTION)
-                              || (Type == InstArchInfo::UopGenType::REDUCTION_WIDE))
-                {
-                    if (num_uops_generated_ != 0)
-                    {
-                        auto prev_dest = dest;
-                        prev_dest.field_value -= 1;
-                        add_dest_as_src(srcs, prev_dest);
-                    }
-                }
+                add_dest_as_src(dest, dest_value);
             }
-        }
-
-        return makeInst_(srcs, dests);
-    }
-
-    template <InstArchInfo::UopGenType Type> InstPtr VectorUopGenerator::generateSlideUops_()
-    {
-        static_assert((Type == InstArchInfo::UopGenType::SLIDE1UP)
-                      || (Type == InstArchInfo::UopGenType::SLIDE1DOWN));
-        sparta_assert(current_inst_.isValid(),
-                      "Cannot generate uops, current instruction is not set");
-        auto orig_srcs = current_inst_.getValue()->getSourceOpInfoList();
-
-        mavis::OperandInfo::ElementList srcs;
-        for (auto & src : orig_srcs)
-        {
-            if constexpr (Type == InstArchInfo::UopGenType::SLIDE1UP)
+            if (uop_template.prev_dest_as_src)
             {
-                // For vslide1up, first uop sources the scalar register
-                if (src.operand_type != mavis::InstMetaData::OperandTypes::VECTOR)
-                {
-                    if (num_uops_generated_ == 0)
-                    {
-                        srcs.emplace_back(src);
-                    }
-                }
-                else
-                {
-                    srcs.emplace_back(src.field_id, src.operand_type,
-                                      src.field_value + num_uops_generated_);
-                    if (num_uops_generated_ != 0)
-                    {
-                        using OperandFieldID = mavis::InstMetaData::OperandFieldID;
-                        const OperandFieldID field_id = OperandFieldID::RS3;
-                        srcs.emplace_back(field_id, src.operand_type,
-                                          src.field_value + num_uops_generated_ - 1);
-                    }
-                }
-            }
-            else if constexpr (Type == InstArchInfo::UopGenType::SLIDE1DOWN)
-            {
-                // For vslide1down, last uop sources the scalar register
-                if (src.operand_type != mavis::InstMetaData::OperandTypes::VECTOR)
-                {
-                    if ((num_uops_generated_ + 1) == num_uops_to_generate_)
-                    {
-                        srcs.emplace_back(src);
-                    }
-                }
-                else
-                {
-                    srcs.emplace_back(src.field_id, src.operand_type,
-                                      src.field_value + num_uops_generated_);
-                    if ((num_uops_generated_ + 1) != num_uops_to_generate_)
-                    {
-                        using OperandFieldID = mavis::InstMetaData::OperandFieldID;
-                        const OperandFieldID field_id = OperandFieldID::RS3;
-                        srcs.emplace_back(field_id, src.operand_type,
-                                          src.field_value + num_uops_generated_ + 1);
-                    }
-                }
+                add_dest_as_src(dest, dest_value - 1);
             }
         }
 
-        auto dests = current_inst_.getValue()->getDestOpInfoList();
-        for (auto & dest : dests)
-        {
-            dest.field_value += num_uops_generated_;
-        }
-
-        return makeInst_(srcs, dests);
-    }
-
-    InstPtr VectorUopGenerator::generatePermuteUops_()
-    {
-        sparta_assert(false, "Vector permute uop generation is currently not supported!");
+        return makeInst_(uop_srcs_, uop_dests_);
     }
 
     InstPtr VectorUopGenerator::makeInst_(const mavis::OperandInfo::ElementList & srcs,
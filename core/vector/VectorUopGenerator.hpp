@@ -5,39 +5,39 @@
 #include "sparta/simulation/Unit.hpp"
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
+#include "sparta/statistics/StatisticDef.hpp"
 
 #include "Inst.hpp"
 #include "FlushManager.hpp"
 #include "decode/MavisUnit.hpp"
+#include "mavis/InstMetaData.h"
 
-#include <optional>
+#include <array>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 namespace olympia
 {
 
     /**
      * @file VectorUopGenerator.hpp
-     * @brief TODO
+     * @brief Splits vector instructions into uops
+     *
+     * The operands of each uop are described by a precomputed template,
+     * per uop generation type, number of uops and extension factor: the
+     * offsets added to the operands of the parent instruction.  Uops of
+     * instructions with a real encoding are created once, from the
+     * template, then copied from a prototype.
+     *
+     * The generator is the uop expansion stage of Decode, with its own
+     * bandwidth: up to num_uops_per_cycle uops from up to
+     * num_insts_per_cycle vector instructions each cycle.
      */
     class VectorUopGenerator : public sparta::Unit
     {
       public:
-        class Modifier
-        {
-          public:
-            Modifier(std::string name, uint32_t value) : name_{name}, data_{value} {}
-
-            std::string getName() const { return name_; }
-
-            uint32_t getValue() const { return data_; }
-
-            void setValue(uint32_t newValue) { data_ = newValue; }
-
-          private:
-            std::string name_;
-            uint32_t data_;
-        };
-
         //! \brief Parameters for VectorUopGenerator model
         class VectorUopGeneratorParameterSet : public sparta::ParameterSet
         {
@@ -47,6 +47,11 @@ namespace olympia
             //! \brief Generate uops for widening vector instructions with two dests
             // PARAMETER(bool, widening_dual_dest, false,
             //     "Generate uops for widening vector instructions with two dests")
+
+            //! \brief Uop expansion bandwidth
+            PARAMETER(uint32_t, num_uops_per_cycle, 8, "Vector uops generated per cycle")
+            PARAMETER(uint32_t, num_insts_per_cycle, 2,
+                      "Vector instructions cracked (generating uops) per cycle")
         };
 
         /**
@@ -60,6 +65,21 @@ namespace olympia
         //! \brief Name of this resource. Required by sparta::UnitFactory
         static constexpr char name[] = "vec_uop_gen";
 
+        //! \brief Can a new vector instruction start cracking this cycle?
+        bool canAcceptInst()
+        {
+            startCycle_();
+            return (insts_this_cycle_ < num_insts_per_cycle_)
+                   && (uops_this_cycle_ < num_uops_per_cycle_);
+        }
+
+        //! \brief Is there uop expansion bandwidth left this cycle?
+        bool canGenerateUop()
+        {
+            startCycle_();
+            return uops_this_cycle_ < num_uops_per_cycle_;
+        }
+
         void setInst(const InstPtr & inst);
 
         InstPtr generateUop();
@@ -71,25 +91,94 @@ namespace olympia
       private:
         void onBindTreeLate_() override;
 
-        MavisType* mavis_facade_;
+        void onStartingTeardown_() override;
+
+        using OperandFieldID = mavis::InstMetaData::OperandFieldID;
+        static constexpr uint32_t N_SRC_FIELDS = static_cast<uint32_t>(OperandFieldID::RS_MAX) + 1;
+        static constexpr int32_t NO_EXTRA_SRC = std::numeric_limits<int32_t>::min();
+
+        // Operands of a uop, as offsets from the operands of the parent
+        struct UopTemplate
+        {
+            // Added to the vector sources, by source field
+            std::array<uint32_t, N_SRC_FIELDS> src_offsets{};
+            // Each vector source with an extra source offset adds an RS3
+            // source: the parent source plus the offset
+            std::array<int32_t, N_SRC_FIELDS> extra_src_offsets;
+            // Added to the destinations
+            uint32_t dest_offset = 0;
+            // Source the scalar operands of the parent
+            bool scalar_srcs = true;
+            // The destination is also a source (multiply-add)
+            bool dest_as_src = false;
+            // The destination of the previous uop is also a source (reductions)
+            bool prev_dest_as_src = false;
+
+            UopTemplate() { extra_src_offsets.fill(NO_EXTRA_SRC); }
+        };
+
+        using UopSequenceTemplate = std::vector<UopTemplate>;
+
+        // Uop templates by uop gen type, number of uops and extension
+        // factor (log2) of the integer extension instructions
+        static constexpr uint32_t N_EXT_SHIFTS = 4;
+        std::vector<UopSequenceTemplate> uop_templates_;
+
+        static uint32_t getTemplateIndex_(InstArchInfo::UopGenType type, uint64_t num_uops,
+                                          uint32_t ext_shift)
+        {
+            return (static_cast<uint32_t>(type) * (InstArchInfo::N_VECTOR_UOPS + 1) + num_uops)
+                       * N_EXT_SHIFTS
+                   + ext_shift;
+        }
+
+        static UopTemplate buildUopTemplate_(InstArchInfo::UopGenType type, uint32_t uop_idx,
+                                             uint32_t num_uops, uint32_t ext_shift);
 
-        typedef std::function<const InstPtr(VectorUopGenerator*)> UopGenFunctionType;
-        typedef std::map<InstArchInfo::UopGenType, UopGenFunctionType> UopGenFunctionMapType;
-        UopGenFunctionMapType uop_gen_function_map_;
+        // Prototypes of the uops of an encoding, by opcode and template index
+        using UopPrototypes = std::array<InstPtr, InstArchInfo::N_VECTOR_UOPS>;
+        std::unordered_map<uint64_t, UopPrototypes> uop_prototypes_;
+
+        MavisType* mavis_facade_;
+        InstAllocator & inst_allocator_;
 
         sparta::utils::ValidValue<InstPtr> current_inst_;
-        std::vector<Modifier> current_inst_modifiers_;
+        const UopSequenceTemplate* current_template_ = nullptr;
+        UopPrototypes* current_prototypes_ = nullptr;
+
+        // Operand lists of the uop being made, reused across uops
+        mavis::OperandInfo::ElementList uop_srcs_;
+        mavis::OperandInfo::ElementList uop_extra_srcs_;
+        mavis::OperandInfo::ElementList uop_dests_;
+
+        const uint32_t num_uops_per_cycle_;
+        const uint32_t num_insts_per_cycle_;
+
+        // Uop expansion work done in the current cycle
+        uint64_t crack_cycle_ = std::numeric_limits<uint64_t>::max();
+        uint32_t uops_this_cycle_ = 0;
+        uint32_t insts_this_cycle_ = 0;
+
+        void startCycle_()
+        {
+            const uint64_t cycle = getClock()->currentCycle();
+            if (cycle != crack_cycle_)
+            {
+                crack_cycle_ = cycle;
+                uops_this_cycle_ = 0;
+                insts_this_cycle_ = 0;
+            }
+        }
 
         sparta::Counter vuops_generated_;
+        sparta::Counter vuops_from_prototype_;
+        sparta::Counter vuop_crack_cycles_;
+        sparta::StatisticDef vuops_per_crack_cycle_;
 
         uint64_t num_uops_to_generate_ = 0;
         uint64_t num_uops_generated_ = 0;
 
-        template <InstArchInfo::UopGenType Type> InstPtr generateUops_();
-
-        template <InstArchInfo::UopGenType Type> InstPtr generateSlideUops_();
-
-        InstPtr generatePermuteUops_();
+        InstPtr makeUop_(const UopTemplate & uop_template);
 
         InstPtr makeInst_(const mavis::OperandInfo::ElementList & srcs,
                           const mavis::OperandInfo::ElementList & dests);
@@ -97,28 +186,12 @@ namespace olympia
         void reset_()
         {
             current_inst_.clearValid();
-            current_inst_modifiers_.clear();
+            current_template_ = nullptr;
+            current_prototypes_ = nullptr;
             num_uops_to_generate_ = 0;
             num_uops_generated_ = 0;
         }
 
-        void addModifier(const std::string & name, uint32_t value)
-        {
-            current_inst_modifiers_.emplace_back(name, value);
-        }
-
-        std::optional<uint32_t> getModifier(const std::string & name)
-        {
-            for (auto & m : current_inst_modifiers_)
-            {
-                if (m.getName() == name)
-                {
-                    return m.getValue();
-                }
-            }
-            return {};
-        }
-
         // Dump debug content on failure
         void dumpDebugContent_(std::ostream & output) const override final;
 
@@ -0,0 +1,213 @@
+// <BranchPredEvalMain.cpp> -*- C++ -*-
+
+//!
+//! \file BranchPredEvalMain.cpp
+//! \brief Standalone branch predictor evaluation over STF traces
+//!
+//! Streams the branch records of an STF trace through one or more
+//! branch predictor configurations (the same classes used by the timing
+//! model), without the pipeline model, and reports MPKI by branch class
+//! and per PC.  The trace is decoded once; the predictors are evaluated
+//! in parallel, each on its own thread.
+//!
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/program_options.hpp>
+
+#include "fetch/BranchPredEval.hpp"
+#include "fetch/GShareBranchPred.hpp"
+#include "fetch/SimpleBranchPred.hpp"
+
+namespace po = boost::program_options;
+using namespace olympia::BranchPredictor;
+
+const char USAGE[] =
+    "Usage:\n"
+    "    [-p PREDICTOR[:param=value,...]]... [-i insts] [--max-fetch-insts N]\n"
+    "    [--top-pcs N] [--skip-nonuser-mode] [-h,--help] <stf trace>\n"
+    "\n"
+    "Predictors:\n"
+    "    simple\n"
+    "    gshare:pht_entries=4096,history_bits=12,btb_entries=1024\n"
+    "\n";
+
+namespace
+{
+    using PredictorParams = std::map<std::string, uint32_t>;
+
+    uint32_t getParam(const PredictorParams & params, const std::string & name, uint32_t def)
+    {
+        const auto param = params.find(name);
+        return (param == params.end()) ? def : param->second;
+    }
+
+    // Predictors that can be evaluated, by name
+    using PredictorFactory =
+        std::function<std::unique_ptr<DefaultBranchPredictorIF>(uint32_t, const PredictorParams &)>;
+    const std::map<std::string, PredictorFactory> predictor_factories = {
+        {"simple", [](uint32_t max_fetch_insts, const PredictorParams &) {
+             return std::make_unique<SimpleBranchPredictor>(max_fetch_insts);
+         }},
+        {"gshare", [](uint32_t max_fetch_insts, const PredictorParams & params) {
+             return std::make_unique<GShareBranchPredictor>(
+                 max_fetch_insts, getParam(params, "pht_entries", 4096),
+                 getParam(params, "history_bits", 12), getParam(params, "btb_entries", 1024));
+         }}
+    };
+
+    // Create a predictor from a "name[:param=value,...]" specification
+    std::unique_ptr<DefaultBranchPredictorIF> createPredictor(const std::string & spec,
+                                                              uint32_t max_fetch_insts)
+    {
+        const auto colon = spec.find(':');
+        const std::string name = spec.substr(0, colon);
+        const auto factory = predictor_factories.find(name);
+        if (factory == predictor_factories.end()) {
+            throw std::invalid_argument("Unknown branch predictor: " + name);
+        }
+
+        PredictorParams params;
+        if (colon != std::string::npos) {
+            const std::string param_list = spec.substr(colon + 1);
+            std::vector<std::string> param_strs;
+            boost::split(param_strs, param_list, boost::is_any_of(","));
+            for (const auto & param_str : param_strs) {
+                const auto equal = param_str.find('=');
+                if (equal == std::string::npos) {
+                    throw std::invalid_argument("Malformed predictor parameter: " + param_str);
+                }
+                params[param_str.substr(0, equal)] =
+                    static_cast<uint32_t>(std::stoul(param_str.substr(equal + 1)));
+            }
+        }
+        return factory->second(max_fetch_insts, params);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string workload;
+    std::vector<std::string> predictor_specs;
+    uint64_t ilimit = 0;
+    uint32_t max_fetch_insts = 4;
+    uint32_t top_pcs = 10;
+    bool skip_nonuser_mode = false;
+
+    po::options_description opts("Branch predictor evaluation options");
+    opts.add_options()
+        ("help,h", "produce help message")
+        ("predictor,p", po::value<std::vector<std::string>>(&predictor_specs),
+         "Branch predictor to evaluate, with optional parameters "
+         "(name[:param=value,...]).  Can be repeated to evaluate several "
+         "predictors in one pass.  Default: simple")
+        ("instruction-limit,i", po::value<uint64_t>(&ilimit)->default_value(ilimit),
+         "Stop after this many instructions. 0 (default) means no limit")
+        ("max-fetch-insts", po::value<uint32_t>(&max_fetch_insts)->default_value(max_fetch_insts),
+         "Maximum number of instructions in a fetch packet")
+        ("top-pcs", po::value<uint32_t>(&top_pcs)->default_value(top_pcs),
+         "Number of most mispredicted branch PCs to report")
+        ("skip-nonuser-mode", po::bool_switch(&skip_nonuser_mode),
+         "Skip system instructions if present")
+        ("workload", po::value<std::string>(&workload), "STF trace to evaluate");
+
+    po::positional_options_description pos_opts;
+    pos_opts.add("workload", -1);
+
+    po::variables_map vm;
+    try {
+        po::store(po::command_line_parser(argc, argv).options(opts).positional(pos_opts).run(), vm);
+        po::notify(vm);
+    }
+    catch (const po::error & e) {
+        std::cerr << "ERROR: " << e.what() << std::endl << USAGE << opts;
+        return -1;
+    }
+
+    if (vm.count("help") != 0) {
+        std::cout << USAGE << opts;
+        return 0;
+    }
+
+    if (workload.empty()) {
+        std::cerr << "ERROR: Missing an STF trace to evaluate" << std::endl << USAGE;
+        return -1;
+    }
+
+    if (predictor_specs.empty()) {
+        predictor_specs.emplace_back("simple");
+    }
+
+    std::vector<std::unique_ptr<DefaultBranchPredictorIF>> predictors;
+    std::vector<std::unique_ptr<BranchPredEvaluator>> evaluators;
+    std::vector<BranchPredEvaluator *> evaluator_ptrs;
+    for (const auto & spec : predictor_specs) {
+        try {
+            predictors.emplace_back(createPredictor(spec, max_fetch_insts));
+        }
+        catch (const std::exception & e) {
+            std::cerr << "ERROR: " << e.what() << std::endl << USAGE;
+            return -1;
+        }
+        evaluators.emplace_back(new BranchPredEvaluator(spec, *predictors.back()));
+        evaluator_ptrs.emplace_back(evaluators.back().get());
+    }
+
+    STFBranchStream branch_stream(workload, skip_nonuser_mode, ilimit);
+
+    // Read the branches in chunks, double buffered: the next chunk is
+    // decoded while the predictors work on the current one
+    constexpr size_t CHUNK_SIZE = 1 << 16;
+    BranchRecordList branches[2];
+    branches[0].reserve(CHUNK_SIZE);
+    branches[1].reserve(CHUNK_SIZE);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        ParallelBranchPredEval parallel_eval(evaluator_ptrs);
+        uint32_t cur = 0;
+        bool more = branch_stream.read(branches[cur], CHUNK_SIZE);
+        while (more) {
+            parallel_eval.start(branches[cur]);
+            more = branch_stream.read(branches[cur ^ 1], CHUNK_SIZE);
+            parallel_eval.wait();
+            cur ^= 1;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const uint64_t num_insts = branch_stream.getNumInsts();
+    std::cout << "Trace: " << workload << std::endl;
+    for (const auto & evaluator : evaluators) {
+        std::cout << std::endl;
+        evaluator->report(std::cout, num_insts, top_pcs);
+    }
+
+    if (evaluators.size() > 1) {
+        std::cout << std::endl << "Summary" << std::endl;
+        for (const auto & evaluator : evaluators) {
+            const double mpki = (num_insts == 0)
+                ? 0.0 : (1000.0 * evaluator->getNumMispredicts()) / num_insts;
+            std::cout << "  " << std::left << std::setw(60) << evaluator->getName() << std::right
+                      << " MPKI: " << std::fixed << std::setprecision(3) << mpki
+                      << std::defaultfloat << std::endl;
+        }
+    }
+
+    const uint64_t num_branches = evaluators.front()->getNumBranches();
+    std::cout << std::endl << "Evaluated " << num_branches << " branches on "
+              << evaluators.size() << " predictor(s) in " << elapsed.count() << "s ("
+              << ((elapsed.count() > 0) ? num_branches / elapsed.count() / 1e6 : 0)
+              << "M branches/s)" << std::endl;
+
+    return 0;
+}
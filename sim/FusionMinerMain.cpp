@@ -0,0 +1,183 @@
+// <FusionMinerMain.cpp> -*- C++ -*-
+
+//!
+//! \file FusionMinerMain.cpp
+//! \brief Trace-driven fusion opportunity miner
+//!
+//! Streams a trace (STF or JSON) through Mavis decode, without the
+//! pipeline model, and counts the dependent instruction n-grams.  The
+//! top candidates are written as fusion group definitions that can be
+//! given to Decode's fusion_group_definitions parameter.
+//!
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sparta/app/CommandLineSimulator.hpp"
+#include "sparta/app/Simulation.hpp"
+#include "sparta/kernel/Scheduler.hpp"
+#include "sparta/log/MessageSource.hpp"
+#include "sparta/simulation/ResourceTreeNode.hpp"
+#include "sparta/sparta.hpp"
+
+#include "InstGenerator.hpp"
+#include "OlympiaAllocators.hpp"
+#include "decode/FusionMiner.hpp"
+#include "decode/MavisUnit.hpp"
+
+const char USAGE[] =
+    "Usage:\n"
+    "    [-i insts] [--top-k N] [--max-length N] [--no-dependency]\n"
+    "    [--output-file FILE] [--skip-nonuser-mode] [-p PATTERN VAL]\n"
+    "    [-h,--help] <workload [stf trace or JSON]>\n"
+    "\n";
+
+namespace
+{
+    // Minimal simulation: the allocators and Mavis are all that is needed to
+    // decode a trace
+    class FusionMinerSim : public sparta::app::Simulation
+    {
+      public:
+        explicit FusionMinerSim(sparta::Scheduler & scheduler) :
+            sparta::app::Simulation("FusionMinerSim", &scheduler),
+            info_logger_(getRoot(), "info", "Fusion miner info messages")
+        {
+        }
+
+        ~FusionMinerSim() { getRoot()->enterTeardown(); }
+
+        // Decode the workload and feed the miner
+        void mine(olympia::FusionMiner & miner, const std::string & workload,
+                  bool skip_nonuser_mode, uint64_t ilimit)
+        {
+            auto inst_generator = olympia::InstGenerator::createGenerator(
+                info_logger_, olympia::getMavis(getRoot()), workload, skip_nonuser_mode);
+
+            while ((ilimit == 0) || (miner.getNumInsts() < ilimit))
+            {
+                const auto inst = inst_generator->getNextInst(getRootClock());
+                if (nullptr == inst)
+                {
+                    break;
+                }
+                miner.observe(inst);
+            }
+        }
+
+      private:
+        void buildTree_() override
+        {
+            auto rtn = getRoot();
+
+            // Create the common Allocators
+            allocators_tn_.reset(new olympia::OlympiaAllocators(rtn));
+
+            // Create a Mavis Unit
+            tns_to_delete_.emplace_back(new sparta::ResourceTreeNode(
+                rtn, olympia::MavisUnit::name, sparta::TreeNode::GROUP_NAME_NONE,
+                sparta::TreeNode::GROUP_IDX_NONE, "Mavis Unit", &mavis_fact_));
+        }
+
+        void configureTree_() override {}
+
+        void bindTree_() override {}
+
+        // Allocators.  Last thing to delete
+        std::unique_ptr<olympia::OlympiaAllocators> allocators_tn_;
+
+        olympia::MavisFactory mavis_fact_;
+        std::vector<std::unique_ptr<sparta::TreeNode>> tns_to_delete_;
+
+        sparta::log::MessageSource info_logger_;
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string workload;
+    std::string output_file = "fusion_groups.json";
+    uint64_t ilimit = 0;
+    uint32_t top_k = 64;
+    uint32_t max_length = olympia::FusionMiner::MAX_NGRAM_LENGTH;
+    bool skip_nonuser_mode = false;
+    const char* WORKLOAD = "workload";
+
+    sparta::app::DefaultValues DEFAULTS;
+    DEFAULTS.auto_summary_default = "off";
+
+    sparta::app::CommandLineSimulator cls(USAGE, DEFAULTS);
+    auto & app_opts = cls.getApplicationOptions();
+    app_opts.add_options()
+        ("instruction-limit,i",
+         sparta::app::named_value<uint64_t>("LIMIT", &ilimit)->default_value(ilimit),
+         "Stop after this many instructions. 0 (default) means no limit")
+        ("top-k",
+         sparta::app::named_value<uint32_t>("N", &top_k)->default_value(top_k),
+         "Number of fusion group candidates to write")
+        ("max-length",
+         sparta::app::named_value<uint32_t>("N", &max_length)->default_value(max_length),
+         "Longest fusion group candidate, in instructions (2-4)")
+        ("no-dependency",
+         "Count all adjacent instruction n-grams, not only dependent ones")
+        ("output-file",
+         sparta::app::named_value<std::string>("FILE", &output_file)->default_value(output_file),
+         "Fusion group definition JSON file to write")
+        ("skip-nonuser-mode",
+         "For STF traces, skip system instructions if present")
+        (WORKLOAD,
+         sparta::app::named_value<std::string>(WORKLOAD, &workload),
+         "Specifies the instruction workload (trace, JSON)");
+
+    po::positional_options_description & pos_opts = cls.getPositionalOptions();
+    pos_opts.add(WORKLOAD, -1);
+
+    int err_code = 0;
+    if (!cls.parse(argc, argv, err_code))
+    {
+        return err_code; // Any errors already printed to cerr
+    }
+
+    auto & vm = cls.getVariablesMap();
+    skip_nonuser_mode = (vm.count("skip-nonuser-mode") != 0);
+    const bool require_dependency = (vm.count("no-dependency") == 0);
+
+    if (workload.empty())
+    {
+        std::cerr << "ERROR: Missing a workload to mine.  Can be a trace or JSON file"
+                  << std::endl << USAGE;
+        return -1;
+    }
+
+    if ((max_length < 2) || (max_length > olympia::FusionMiner::MAX_NGRAM_LENGTH))
+    {
+        std::cerr << "ERROR: --max-length must be between 2 and "
+                  << olympia::FusionMiner::MAX_NGRAM_LENGTH << std::endl;
+        return -1;
+    }
+
+    sparta::Scheduler scheduler;
+    FusionMinerSim sim(scheduler);
+    cls.populateSimulation(&sim);
+
+    olympia::FusionMiner miner(max_length, require_dependency);
+    sim.mine(miner, workload, skip_nonuser_mode, ilimit);
+
+    std::ofstream os(output_file);
+    if (!os)
+    {
+        std::cerr << "ERROR: Cannot open " << output_file << std::endl;
+        return -1;
+    }
+    miner.writeFusionGroups(os, top_k);
+
+    std::cout << "Workload: " << workload << std::endl;
+    miner.report(std::cout, top_k);
+    std::cout << std::endl << "Wrote " << std::min<size_t>(top_k, miner.getNumCandidates())
+              << " fusion groups to " << output_file << std::endl;
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "fetch/SimpleBranchPred.hpp"
+#include "fetch/GShareBranchPred.hpp"
 #include "sparta/utils/SpartaTester.hpp"
 
 TEST_INIT
@@ -30,6 +31,42 @@ void runTest(int argc, char **argv)
    EXPECT_EQUAL(prediction.branch_idx, 2);
    EXPECT_EQUAL(prediction.predicted_PC, 0x100);
 
+   // the branch is a compressed (2 byte) branch, now not taken
+   olympia::BranchPredictor::DefaultUpdate nt_update;
+   nt_update.fetch_PC = 0x0;
+   nt_update.branch_idx = 0;
+   nt_update.corrected_PC = 0x2;
+   nt_update.fall_through_PC = 0x2;
+   nt_update.actually_taken = false;
+   predictor.updatePredictor(nt_update);
+
+   prediction = predictor.getPrediction(input);
+
+   EXPECT_EQUAL(prediction.branch_idx, 0);
+   EXPECT_EQUAL(prediction.predicted_PC, 0x2);
+
+   // gshare: 16 entry PHT, 4 bits of history, 4 entry BTB
+   olympia::BranchPredictor::GShareBranchPredictor gshare(4, 16, 4, 4);
+
+   // BTB miss, sequential fetch
+   prediction = gshare.getPrediction(input);
+   EXPECT_EQUAL(prediction.branch_idx, 4);
+   EXPECT_EQUAL(prediction.predicted_PC, 16);
+
+   // train an always taken branch until the history saturates
+   for (uint32_t i = 0; i < 8; ++i) {
+       gshare.updatePredictor(update);
+   }
+   prediction = gshare.getPrediction(input);
+   EXPECT_EQUAL(prediction.branch_idx, 2);
+   EXPECT_EQUAL(prediction.predicted_PC, 0x100);
+
+   // an aliasing fetch PC in the BTB does not hit
+   input.fetch_PC = 0x40;
+   prediction = gshare.getPrediction(input);
+   EXPECT_EQUAL(prediction.branch_idx, 4);
+   EXPECT_EQUAL(prediction.predicted_PC, 0x50);
+
    // TODO: add more tests
 
 }
@@ -9,6 +9,48 @@ const char USAGE[] = "Usage:\n"
 
 sparta::app::DefaultValues DEFAULTS;
 
+class olympia::DispatchTester {
+public:
+  DispatchTester(olympia::Dispatch *dispatch) : dispatch_(dispatch) {}
+
+  void test_iq_insts(const std::vector<uint64_t> &expected_iq_insts) {
+    EXPECT_TRUE(dispatch_->iq_insts_.size() >= expected_iq_insts.size());
+    for (size_t i = 0; i < expected_iq_insts.size(); ++i) {
+      EXPECT_EQUAL(dispatch_->iq_insts_[i]->get(), expected_iq_insts[i]);
+    }
+  }
+
+  bool is_round_robin() const {
+    return dynamic_cast<const olympia::RoundRobinSteering *>(
+               dispatch_->steering_policy_.get()) != nullptr;
+  }
+
+  uint64_t get_iq_insts(const size_t iq) const {
+    return dispatch_->iq_insts_[iq]->get();
+  }
+
+  uint64_t get_steered_to_fuller_iq() const {
+    return dispatch_->steered_to_fuller_iq_.get();
+  }
+
+  // Samples of the iq_credit_imbalance histogram, summed over its buckets
+  uint64_t get_num_credit_imbalance_samples() const {
+    uint64_t num_samples = 0;
+    for (const sparta::TreeNode *child :
+         dispatch_->getStatisticSet()->getChildren()) {
+      const auto *ctr = dynamic_cast<const sparta::CounterBase *>(child);
+      if ((ctr != nullptr) &&
+          (child->getName().find("iq_credit_imbalance") == 0)) {
+        num_samples += ctr->get();
+      }
+    }
+    return num_samples;
+  }
+
+private:
+  olympia::Dispatch *dispatch_;
+};
+
 // The main tester of Dispatch.  The test is encapsulated in the
 // parameter test_type of the Source unit.
 void runTest(int argc, char **argv) {
@@ -52,8 +94,33 @@ void runTest(int argc, char **argv) {
                   input_file, enable_vector);
 
   cls.populateSimulation(&sim);
+
+  auto *my_dispatch =
+      sim.getRoot()->getChild("dispatch")->getResourceAs<olympia::Dispatch *>();
+  olympia::DispatchTester dispatch_tester{my_dispatch};
+
   cls.runSimulator(&sim);
 
+  if (input_file.find("test_steering.json") != std::string::npos) {
+    // mul x3; add x4 <- x3; add x5 <- x4; three independent adds.  The
+    // mul only goes to iq1, the adds to iq0, iq1 or iq2: 5 steering
+    // decisions between 3 issue queues
+    EXPECT_EQUAL(dispatch_tester.get_num_credit_imbalance_samples(), 5);
+    if (dispatch_tester.is_round_robin()) {
+      // The adds go to iq0, iq1, iq2, iq0, iq1 whatever their sources
+      dispatch_tester.test_iq_insts({2, 3, 1});
+    } else {
+      // The two dependent adds follow the mul to iq1, the independent
+      // ones go to the other issue queues, which have more credits
+      EXPECT_EQUAL(dispatch_tester.get_iq_insts(1), 3);
+      EXPECT_EQUAL(dispatch_tester.get_iq_insts(0) +
+                       dispatch_tester.get_iq_insts(2),
+                   3);
+      EXPECT_TRUE(dispatch_tester.get_steered_to_fuller_iq() >= 1);
+    }
+    return;
+  }
+
   EXPECT_FILES_EQUAL(datafiles[0],
                      "expected_output/" + datafiles[0] + ".EXPECTED");
 }
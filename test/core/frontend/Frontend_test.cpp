@@ -0,0 +1,219 @@
+#include "OlympiaSim.hpp"
+#include "decode/Decode.hpp"
+#include "decode/LoopBuffer.hpp"
+#include "decode/UopCache.hpp"
+#include "ROB.hpp"
+
+#include "sparta/app/CommandLineSimulator.hpp"
+#include "sparta/kernel/Scheduler.hpp"
+#include "sparta/utils/SpartaTester.hpp"
+
+TEST_INIT
+
+const char USAGE[] = "Usage:\n"
+                     "\n"
+                     "\n";
+
+sparta::app::DefaultValues DEFAULTS;
+
+class olympia::ROBTester
+{
+  public:
+    ROBTester(olympia::ROB* rob) : rob_(rob) {}
+
+    void test_num_insts_retired(const uint64_t expected_num_insts_retired)
+    {
+        EXPECT_EQUAL(rob_->num_retired_, expected_num_insts_retired);
+    }
+
+    void test_num_uops_retired(const uint64_t expected_num_uops_retired)
+    {
+        EXPECT_EQUAL(rob_->num_uops_retired_, expected_num_uops_retired);
+    }
+
+    void test_num_flushes(const uint64_t expected_num_flushes)
+    {
+        EXPECT_EQUAL(rob_->num_flushes_, expected_num_flushes);
+    }
+
+  private:
+    olympia::ROB* rob_;
+};
+
+class olympia::DecodeTester
+{
+  public:
+    DecodeTester(olympia::Decode* decode) : decode_(decode) {}
+
+    void test_fusion(const uint64_t expected_fused, const uint64_t expected_ghosts)
+    {
+        EXPECT_EQUAL(decode_->fusion_num_fuse_instructions_, expected_fused);
+        EXPECT_EQUAL(decode_->fusion_num_ghost_instructions_, expected_ghosts);
+    }
+
+    // Instructions taken from the fetch queue vs. uops sent to Rename
+    void test_decode_width(const uint64_t expected_insts_in, const uint64_t expected_uops_out)
+    {
+        EXPECT_EQUAL(decode_->decode_insts_in_, expected_insts_in);
+        EXPECT_EQUAL(decode_->decode_uops_out_, expected_uops_out);
+    }
+
+  private:
+    olympia::Decode* decode_;
+};
+
+class olympia::UopCacheTester
+{
+  public:
+    UopCacheTester(olympia::UopCache* uop_cache) : uop_cache_(uop_cache) {}
+
+    void test_lookups(const uint64_t expected_lookups)
+    {
+        const uint64_t hits = uop_cache_->uop_cache_hits_.get();
+        const uint64_t misses = uop_cache_->uop_cache_misses_.get();
+        EXPECT_EQUAL(hits + misses, expected_lookups);
+        // Only the first fetches of the loop, before its fill, miss
+        EXPECT_TRUE(hits > misses);
+        EXPECT_TRUE(uop_cache_->uop_cache_fills_.get() > 0);
+    }
+
+    void test_delivery(const uint64_t expected_uops)
+    {
+        const uint64_t uops_delivered = uop_cache_->uop_cache_uops_delivered_.get();
+        EXPECT_EQUAL(uops_delivered + uop_cache_->legacy_uops_delivered_.get(), expected_uops);
+        EXPECT_TRUE(uops_delivered > 0);
+
+        // Never more than delivery_width uops per cycle
+        const uint64_t delivery_cycles = uop_cache_->uop_cache_delivery_cycles_.get();
+        EXPECT_TRUE(uops_delivered <= (delivery_cycles * uop_cache_->delivery_width_));
+
+        // Legacy decode to uop cache, and back for the loop exit
+        EXPECT_TRUE(uop_cache_->uop_cache_switches_.get() >= 2);
+    }
+
+  private:
+    olympia::UopCache* uop_cache_;
+};
+
+class olympia::LoopBufferTester
+{
+  public:
+    LoopBufferTester(olympia::LoopBuffer* loop_buffer) : loop_buffer_(loop_buffer) {}
+
+    void test_replay(const bool expected_locked)
+    {
+        EXPECT_EQUAL(loop_buffer_->isLocked(), expected_locked);
+        EXPECT_EQUAL(loop_buffer_->lsd_loops_detected_, 1);
+        EXPECT_EQUAL(loop_buffer_->lsd_flushes_, 0);
+
+        // The gated cycles of a loop still locked are counted too
+        const uint64_t gated_cycles = loop_buffer_->lsd_gated_cycles_.get();
+        const uint64_t insts_replayed = loop_buffer_->lsd_insts_replayed_.get();
+        EXPECT_TRUE(gated_cycles > 0);
+        EXPECT_TRUE(insts_replayed > 0);
+
+        // Fetch replays at most delivery_width instructions per cycle, from
+        // the locking cycle to the unlocking one
+        EXPECT_TRUE(insts_replayed <= ((gated_cycles + 1) * loop_buffer_->delivery_width_));
+    }
+
+  private:
+    olympia::LoopBuffer* loop_buffer_;
+};
+
+void runTests(int argc, char** argv)
+{
+    DEFAULTS.auto_summary_default = "off";
+    std::string input_file;
+    uint64_t expected_num_insts;
+
+    sparta::app::CommandLineSimulator cls(USAGE, DEFAULTS);
+    auto & app_opts = cls.getApplicationOptions();
+    app_opts.add_options()
+        ("input-file",
+         sparta::app::named_value<std::string>("INPUT_FILE", &input_file)->default_value(""),
+         "Provide a JSON instruction stream",
+         "Provide a JSON file with instructions to run through the frontend")
+        ("expected-num-insts",
+         sparta::app::named_value<uint64_t>("EXPECTED_NUM_INSTS", &expected_num_insts)
+             ->default_value(0),
+         "Number of instructions retired");
+
+    int err_code = 0;
+    if (!cls.parse(argc, argv, err_code))
+    {
+        sparta_assert(false, "Command line parsing failed");
+    }
+
+    sparta::Scheduler scheduler;
+    uint32_t num_cores = 1;
+    uint64_t ilimit = 0;
+    bool show_factories = false;
+    OlympiaSim sim(scheduler, num_cores, input_file, ilimit, show_factories);
+    sparta::RootTreeNode* root_node = sim.getRoot();
+    cls.populateSimulation(&sim);
+
+    auto* my_rob = root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB*>();
+    olympia::ROBTester rob_tester{my_rob};
+
+    auto* my_uop_cache =
+        root_node->getChild("cpu.core0.decode.uop_cache")->getResourceAs<olympia::UopCache*>();
+    olympia::UopCacheTester uop_cache_tester{my_uop_cache};
+
+    auto* my_loop_buffer =
+        root_node->getChild("cpu.core0.decode.loop_buffer")->getResourceAs<olympia::LoopBuffer*>();
+    olympia::LoopBufferTester loop_buffer_tester{my_loop_buffer};
+
+    auto* my_decode = root_node->getChild("cpu.core0.decode")->getResourceAs<olympia::Decode*>();
+    olympia::DecodeTester decode_tester{my_decode};
+
+    cls.runSimulator(&sim);
+
+    if (input_file.find("fusion_branch.json") != std::string::npos)
+    {
+        // addi a5,a5,-1 + bne a5,x0 match addi_bne, but the bne must
+        // resolve on the BR pipe: nothing is fused and its misprediction
+        // flushes the two younger addis, which are fetched again
+        decode_tester.test_fusion(0, 0);
+        rob_tester.test_num_flushes(1);
+        rob_tester.test_num_insts_retired(4);
+        rob_tester.test_num_uops_retired(4);
+        return;
+    }
+
+    if (input_file.find("fusion.json") != std::string::npos)
+    {
+        // Of the 4 lui/addi pairs, only the 2 whose addi writes and reads
+        // the lui destination are fused: the others would lose the addi
+        // destination or source
+        decode_tester.test_fusion(2, 2);
+        decode_tester.test_decode_width(8, 6);
+        rob_tester.test_num_insts_retired(8);
+        rob_tester.test_num_uops_retired(6);
+        return;
+    }
+
+    // 100 iterations of a 4 instruction loop and the exit block, unless
+    // the retire limit stops the run in the loop
+    rob_tester.test_num_insts_retired(expected_num_insts);
+    const bool loop_exited = (expected_num_insts == 401);
+
+    if (my_uop_cache->isEnabled())
+    {
+        uop_cache_tester.test_lookups(101);
+        uop_cache_tester.test_delivery(401);
+    }
+
+    if (my_loop_buffer->isEnabled())
+    {
+        loop_buffer_tester.test_replay(!loop_exited);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    runTests(argc, argv);
+
+    REPORT_ERROR;
+    return (int)ERROR_CODE;
+}
@@ -5,7 +5,9 @@
 #include "decode/MavisUnit.hpp"
 #include "OlympiaAllocators.hpp"
 #include "OlympiaSim.hpp"
+#include "execute/ExecutePipe.hpp"
 #include "execute/IssueQueue.hpp"
+#include "ROB.hpp"
 #include "test/core/dispatch/Dispatch_test.hpp"
 
 #include "sparta/app/CommandLineSimulator.hpp"
@@ -22,8 +24,10 @@
 
 #include <cinttypes>
 #include <initializer_list>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <vector>
 TEST_INIT
 
@@ -47,8 +51,123 @@ public:
     // so alu0's total_insts_issued should be 1
     EXPECT_TRUE(issuequeue.total_insts_issued_ == 0);
   }
+  bool is_in_order_issue(olympia::IssueQueue &issuequeue) {
+    return issuequeue.in_order_issue_;
+  }
+  uint64_t get_source_wakeups(olympia::IssueQueue &issuequeue) {
+    return issuequeue.source_wakeups_;
+  }
+  uint64_t get_load_spec_wakeups(olympia::IssueQueue &issuequeue) {
+    return issuequeue.load_spec_wakeups_;
+  }
+  uint64_t get_replayed_insts(olympia::IssueQueue &issuequeue) {
+    return issuequeue.replayed_insts_;
+  }
+  void test_read_ports(olympia::IssueQueue &issuequeue,
+                       const uint64_t expected_prf_reads,
+                       const uint64_t expected_bypassed_srcs,
+                       const uint64_t expected_conflicts) {
+    EXPECT_EQUAL(issuequeue.prf_reads_, expected_prf_reads);
+    EXPECT_EQUAL(issuequeue.bypassed_srcs_, expected_bypassed_srcs);
+    EXPECT_EQUAL(issuequeue.int_read_port_conflicts_, expected_conflicts);
+  }
+  void test_wakeup_lists_empty(olympia::IssueQueue &issuequeue) {
+    // Every consumer was woken up and every PRF callback fired
+    for (uint32_t rf = 0; rf < olympia::core_types::N_REGFILES; ++rf) {
+      for (const auto &wakeup_list : issuequeue.wakeup_lists_[rf]) {
+        EXPECT_TRUE(wakeup_list.empty());
+      }
+      EXPECT_TRUE(issuequeue.wakeup_registered_[rf].none());
+    }
+    EXPECT_TRUE(issuequeue.occupied_slots_.none());
+    EXPECT_TRUE(issuequeue.aged_slots_.none());
+    EXPECT_TRUE(issuequeue.spec_issued_slots_.none());
+    EXPECT_TRUE(issuequeue.replay_hold_slots_.none());
+  }
+};
+
+class olympia::ExecutePipeTester {
+public:
+  bool is_pipelined(olympia::ExecutePipe &exe_pipe) {
+    return exe_pipe.pipelined_;
+  }
+  uint64_t get_writeback_stall_cycles(olympia::ExecutePipe &exe_pipe) {
+    return exe_pipe.writeback_stall_cycles_;
+  }
+  // No instruction is left waiting for its load producers
+  void test_no_held_insts(olympia::ExecutePipe &exe_pipe) {
+    EXPECT_TRUE(exe_pipe.spec_executed_insts_.empty());
+    EXPECT_TRUE(exe_pipe.spec_chained_insts_.empty());
+    EXPECT_TRUE(exe_pipe.completion_queue_.empty());
+  }
+};
+
+class olympia::ROBTester {
+public:
+  ROBTester(olympia::ROB *rob) : rob_(rob) {}
+  // Record the cycle the instructions in the ROB are seen issued and
+  // completed, called every cycle
+  void record_cycles() {
+    const uint64_t cycle = rob_->getClock()->currentCycle();
+    for (const auto &inst : rob_->reorder_buffer_) {
+      const auto status = inst->getStatus();
+      if (((status == olympia::Inst::Status::SCHEDULED) ||
+           (status == olympia::Inst::Status::COMPLETED)) &&
+          (issue_cycles_.count(inst->getUniqueID()) == 0)) {
+        issue_cycles_[inst->getUniqueID()] = cycle;
+      }
+      if ((status == olympia::Inst::Status::COMPLETED) &&
+          (complete_cycles_.count(inst->getUniqueID()) == 0)) {
+        complete_cycles_[inst->getUniqueID()] = cycle;
+      }
+    }
+  }
+  uint64_t num_issued() const { return issue_cycles_.size(); }
+  uint64_t num_completed() const { return complete_cycles_.size(); }
+  // Issue cycle of the instruction, in trace order from 1
+  uint64_t issue_cycle(const uint64_t uid) const {
+    const auto it = issue_cycles_.find(uid);
+    EXPECT_TRUE(it != issue_cycles_.end());
+    return (it != issue_cycles_.end()) ? it->second : 0;
+  }
+  // Completion cycle of the instruction, in trace order from 1
+  uint64_t complete_cycle(const uint64_t uid) const {
+    const auto it = complete_cycles_.find(uid);
+    EXPECT_TRUE(it != complete_cycles_.end());
+    return (it != complete_cycles_.end()) ? it->second : 0;
+  }
+  // Cycles from issue to completion: the execution latency, plus the write
+  // back cycle
+  uint64_t issue_to_complete(const uint64_t uid) const {
+    const auto it = complete_cycles_.find(uid);
+    EXPECT_TRUE(it != complete_cycles_.end());
+    return (it != complete_cycles_.end()) ? (it->second - issue_cycle(uid)) : 0;
+  }
+
+private:
+  olympia::ROB *rob_;
+  std::map<uint64_t, uint64_t> issue_cycles_;
+  std::map<uint64_t, uint64_t> complete_cycles_;
 };
 
+// Step the simulation a cycle at a time until num_insts instructions issued,
+// or completed
+void runUntil(sparta::app::CommandLineSimulator &cls,
+              sparta::app::Simulation &sim, olympia::ROBTester &rob_tester,
+              const uint64_t num_insts, const bool until_completed = false) {
+  const uint64_t max_cycles = 1000;
+  auto num_done = [&rob_tester, until_completed]() {
+    return until_completed ? rob_tester.num_completed()
+                           : rob_tester.num_issued();
+  };
+  for (uint64_t cycle = 0; (num_done() < num_insts) && (cycle < max_cycles);
+       ++cycle) {
+    cls.runSimulator(&sim, 1);
+    rob_tester.record_cycles();
+  }
+  EXPECT_EQUAL(num_done(), num_insts);
+}
+
 void runIQTest(int argc, char **argv) {
   DEFAULTS.auto_summary_default = "off";
   std::vector<std::string> datafiles;
@@ -148,6 +267,233 @@ void runIQTest(int argc, char **argv) {
     issuequeue_tester.test_occupied(*my_issuequeue1);
     issuequeue_tester.test_occupied(*my_issuequeue);
     issuequeue_tester.test_empty(*my_issuequeue2);
+  } else if (input_file.find("test_wakeup.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    runUntil(cls, full_sim, rob_tester, 4);
+    cls.runSimulator(&full_sim);
+
+    // 1: mul x3 2: add x4 <- x3 3: add x5 <- x4, x3 4: add x6, independent
+    // The consumers issue once their producer's result is written, the
+    // independent add does not wait behind them
+    EXPECT_TRUE(rob_tester.issue_cycle(2) >= rob_tester.issue_cycle(1) + 3);
+    EXPECT_TRUE(rob_tester.issue_cycle(3) > rob_tester.issue_cycle(2));
+    EXPECT_TRUE(rob_tester.issue_cycle(4) < rob_tester.issue_cycle(2));
+
+    // The adds were dispatched before the mul completed: one source of the
+    // first add and both sources of the second one were woken up
+    olympia::IssueQueueTester issuequeue_tester;
+    uint64_t source_wakeups = 0;
+    for (const auto iq : {"iq0", "iq1", "iq2"}) {
+      auto *my_issuequeue =
+          root_node->getChild(std::string("cpu.core0.execute.") + iq)
+              ->getResourceAs<olympia::IssueQueue *>();
+      source_wakeups += issuequeue_tester.get_source_wakeups(*my_issuequeue);
+      issuequeue_tester.test_wakeup_lists_empty(*my_issuequeue);
+    }
+    EXPECT_EQUAL(source_wakeups, 3);
+  } else if (input_file.find("test_age_order.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    runUntil(cls, full_sim, rob_tester, 4);
+    cls.runSimulator(&full_sim);
+
+    // 1: mul x3 2: div x4 <- x3 3: div x5 4: div x6, the divides share
+    // alu1.  The ready divide 3 issues first and holds the divider, the
+    // mul result wakes up divide 2 meanwhile
+    olympia::IssueQueue *my_issuequeue =
+        root_node->getChild("cpu.core0.execute.iq0")
+            ->getResourceAs<olympia::IssueQueue *>();
+    olympia::IssueQueueTester issuequeue_tester;
+    EXPECT_TRUE(rob_tester.issue_cycle(3) < rob_tester.issue_cycle(2));
+    EXPECT_TRUE(rob_tester.issue_cycle(3) < rob_tester.issue_cycle(4));
+    if (issuequeue_tester.is_in_order_issue(*my_issuequeue)) {
+      // First ready, first issued: divide 4 was ready before divide 2
+      EXPECT_TRUE(rob_tester.issue_cycle(4) < rob_tester.issue_cycle(2));
+    } else {
+      // The oldest ready divide goes first
+      EXPECT_TRUE(rob_tester.issue_cycle(2) < rob_tester.issue_cycle(4));
+    }
+    issuequeue_tester.test_wakeup_lists_empty(*my_issuequeue);
+  } else if (input_file.find("test_load_spec.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    cls.runSimulator(&full_sim);
+
+    // 1: lw x3 2: add x4 <- x3 3: add x5 <- x4 4: lw x6 <- x5 5: add x7 <- x6
+    // The consumers of both loads would be woken up when a hit returns the
+    // data.  The first load misses before that: its wakeup is cancelled and
+    // nothing is replayed.  The second load goes after the first one filled
+    // the line and hits, its consumer is woken up with the data
+    olympia::IssueQueueTester issuequeue_tester;
+    uint64_t load_spec_wakeups = 0;
+    uint64_t replayed_insts = 0;
+    for (const auto iq : {"iq0", "iq1", "iq2"}) {
+      auto *my_issuequeue =
+          root_node->getChild(std::string("cpu.core0.execute.") + iq)
+              ->getResourceAs<olympia::IssueQueue *>();
+      load_spec_wakeups += issuequeue_tester.get_load_spec_wakeups(*my_issuequeue);
+      replayed_insts += issuequeue_tester.get_replayed_insts(*my_issuequeue);
+      issuequeue_tester.test_wakeup_lists_empty(*my_issuequeue);
+    }
+    EXPECT_TRUE(load_spec_wakeups >= 2);
+    EXPECT_EQUAL(replayed_insts, 0);
+
+    olympia::ExecutePipeTester exe_pipe_tester;
+    for (uint32_t i = 0; i < 6; ++i) {
+      auto *my_exe_pipe =
+          root_node->getChild("cpu.core0.execute.exe" + std::to_string(i))
+              ->getResourceAs<olympia::ExecutePipe *>();
+      exe_pipe_tester.test_no_held_insts(*my_exe_pipe);
+    }
+  } else if (input_file.find("test_load_to_use.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    runUntil(cls, full_sim, rob_tester, 4, true);
+    cls.runSimulator(&full_sim);
+
+    // 1: lw x3 2: add x5 <- x3 3: lw x6 <- x5, hits the line filled by the
+    // first load 4: mul x7 <- x6.  The mul is woken up by the hit and issues
+    // in the cycle the load returns its data, then runs its whole latency
+    const uint64_t mul_latency = 3;
+    const uint64_t writeback = 1;
+    EXPECT_EQUAL(rob_tester.issue_cycle(4), rob_tester.complete_cycle(3));
+    EXPECT_EQUAL(rob_tester.issue_to_complete(4), mul_latency + writeback);
+
+    olympia::IssueQueueTester issuequeue_tester;
+    uint64_t load_spec_wakeups = 0;
+    uint64_t replayed_insts = 0;
+    for (const auto iq : {"iq0", "iq1", "iq2"}) {
+      auto *my_issuequeue =
+          root_node->getChild(std::string("cpu.core0.execute.") + iq)
+              ->getResourceAs<olympia::IssueQueue *>();
+      load_spec_wakeups += issuequeue_tester.get_load_spec_wakeups(*my_issuequeue);
+      replayed_insts += issuequeue_tester.get_replayed_insts(*my_issuequeue);
+      issuequeue_tester.test_wakeup_lists_empty(*my_issuequeue);
+    }
+    EXPECT_TRUE(load_spec_wakeups >= 1);
+    EXPECT_EQUAL(replayed_insts, 0);
+
+    olympia::ExecutePipeTester exe_pipe_tester;
+    for (uint32_t i = 0; i < 6; ++i) {
+      auto *my_exe_pipe =
+          root_node->getChild("cpu.core0.execute.exe" + std::to_string(i))
+              ->getResourceAs<olympia::ExecutePipe *>();
+      exe_pipe_tester.test_no_held_insts(*my_exe_pipe);
+    }
+  } else if (input_file.find("many_muls.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    const uint64_t num_muls = 100;
+    runUntil(cls, full_sim, rob_tester, num_muls);
+    cls.runSimulator(&full_sim);
+
+    // 100 independent muls (latency 3) on the two mul pipes of iq1, exe2
+    // and exe3
+    const uint64_t issue_cycles =
+        rob_tester.issue_cycle(num_muls) - rob_tester.issue_cycle(1);
+    olympia::ExecutePipeTester exe_pipe_tester;
+    auto *my_exe_pipe2 = root_node->getChild("cpu.core0.execute.exe2")
+                             ->getResourceAs<olympia::ExecutePipe *>();
+    auto *my_exe_pipe3 = root_node->getChild("cpu.core0.execute.exe3")
+                             ->getResourceAs<olympia::ExecutePipe *>();
+    if (exe_pipe_tester.is_pipelined(*my_exe_pipe2)) {
+      // A mul per cycle and per pipe, at least as fast as the frontend
+      // delivers one per cycle.  Each pipe writes back what it accepts
+      // every cycle, no result waits for the write port
+      EXPECT_TRUE(issue_cycles < num_muls);
+      EXPECT_EQUAL(exe_pipe_tester.get_writeback_stall_cycles(*my_exe_pipe2), 0);
+      EXPECT_EQUAL(exe_pipe_tester.get_writeback_stall_cycles(*my_exe_pipe3), 0);
+    } else {
+      // Each pipe is busy until its mul completes: 2 muls every 3 cycles
+      EXPECT_TRUE(issue_cycles >= 3 * (num_muls / 2 - 1));
+    }
+  } else if (input_file.find("test_early_out_div.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    runUntil(cls, full_sim, rob_tester, 8, true);
+    cls.runSimulator(&full_sim);
+
+    // 3 setup cycles, then 2 quotient bits per cycle.  The divider is busy
+    // until each divide completes, the results never wait for the write
+    // back port
+    const uint64_t setup = 3;
+    const uint64_t writeback = 1;
+    // 7 / 3: 2 quotient bits
+    EXPECT_EQUAL(rob_tester.issue_to_complete(1), setup + 1 + writeback);
+    // -8 / 2 signed: 3 quotient bits
+    EXPECT_EQUAL(rob_tester.issue_to_complete(2), setup + 2 + writeback);
+    // 0xfffffffffffffff8 / 2 unsigned: 64 quotient bits, the worst case
+    EXPECT_EQUAL(rob_tester.issue_to_complete(3), 23 + writeback);
+    // 32 bit -16 % 3: 4 quotient bits
+    EXPECT_EQUAL(rob_tester.issue_to_complete(4), setup + 2 + writeback);
+    // Divide by zero
+    EXPECT_EQUAL(rob_tester.issue_to_complete(5), setup + writeback);
+    // No operand values in the trace: the worst case
+    EXPECT_EQUAL(rob_tester.issue_to_complete(6), 23 + writeback);
+    // Double divide by zero
+    EXPECT_EQUAL(rob_tester.issue_to_complete(7), setup + writeback);
+    // Single square root of a normal value: the worst case
+    EXPECT_EQUAL(rob_tester.issue_to_complete(8), 24 + writeback);
+  } else if (input_file.find("test_read_ports.json") != std::string::npos) {
+    uint64_t ilimit = 0;
+    uint32_t num_cores = 1;
+    bool show_factories = false;
+    OlympiaSim full_sim(sched, num_cores, input_file, ilimit, show_factories);
+    cls.populateSimulation(&full_sim);
+    sparta::RootTreeNode *root_node = full_sim.getRoot();
+    olympia::ROBTester rob_tester(
+        root_node->getChild("cpu.core0.rob")->getResourceAs<olympia::ROB *>());
+    runUntil(cls, full_sim, rob_tester, 5);
+    cls.runSimulator(&full_sim);
+
+    // 1: mul x3 2-5: add <- x3, x1.  Adds 2 and 5 are in iq0: x3 comes
+    // from the bypass network, x1 from the PRF.  Add 5 does not get the
+    // read port in the cycle add 2 issues, it's counted once and issues
+    // in the next cycle, x3 is still on the bypass network
+    olympia::IssueQueue *my_issuequeue =
+        root_node->getChild("cpu.core0.execute.iq0")
+            ->getResourceAs<olympia::IssueQueue *>();
+    olympia::IssueQueueTester issuequeue_tester;
+    issuequeue_tester.test_read_ports(*my_issuequeue, 2, 2, 1);
+    EXPECT_EQUAL(rob_tester.issue_cycle(5), rob_tester.issue_cycle(2) + 1);
+    // The other issue queues have unlimited read ports
+    EXPECT_TRUE(rob_tester.issue_cycle(3) <= rob_tester.issue_cycle(2));
+    EXPECT_TRUE(rob_tester.issue_cycle(4) <= rob_tester.issue_cycle(2));
   }
 }
 
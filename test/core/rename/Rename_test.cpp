@@ -31,6 +31,7 @@
 #include <cinttypes>
 #include <initializer_list>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <vector>
 
@@ -151,6 +152,52 @@ public:
         EXPECT_EQUAL(rf_components_1.freelist.size(), 94);
         EXPECT_EQUAL(rf_components_0.freelist.size(), 96);
     }
+
+    void test_checkpoint_recovery(const olympia::Rename & rename)
+    {
+        // The mispredicted beq flush starts right after the beq, the map is
+        // restored from its checkpoint.  The csrrs flush starts after the
+        // checkpointed branches retired, the map is restored by walking the
+        // flushed instructions
+        EXPECT_EQUAL(rename.checkpoint_restores_, 1);
+        EXPECT_EQUAL(rename.walk_recoveries_, 1);
+        EXPECT_TRUE(rename.walk_recovery_insts_ > 0);
+
+        // 4 branches in flight with 2 checkpoints
+        EXPECT_TRUE(rename.checkpoints_taken_ >= 4);
+        EXPECT_TRUE(rename.stall_counters_[olympia::Rename::NO_CHECKPOINTS].get() > 0);
+
+        // Every checkpoint is released, including the one of the retired
+        // mispredicted branch
+        EXPECT_TRUE(rename.checkpoints_.empty());
+        EXPECT_TRUE(rename.inst_queue_.empty());
+
+        // Every architectural register maps to its own PRF, referenced once
+        // and not free, all the other PRFs but the unused PRF 0 (x0) are
+        // back on the free list
+        const auto & rf_components = rename.regfile_components_[olympia::core_types::RF_INTEGER];
+        std::set<uint32_t> mapped_prfs;
+        for (uint32_t arf = 1; arf < 32; ++arf)
+        {
+            const uint32_t prf = rename.map_table_[olympia::core_types::RF_INTEGER][arf];
+            EXPECT_TRUE(mapped_prfs.insert(prf).second);
+            EXPECT_EQUAL(rf_components.reference_counter[prf].cnt, 1);
+            EXPECT_FALSE(rf_components.freelist.isFree(prf));
+        }
+        EXPECT_EQUAL(rf_components.freelist.size(),
+                     rf_components.reference_counter.size() - mapped_prfs.size() - 1);
+    }
+
+    void test_idiom_elimination(const olympia::Rename & rename)
+    {
+        // xor x3, x4, x4 is a zero idiom, addi x5, x0, 7 and lui x6 are
+        // constants.  sub x8, x7, x6 has different sources
+        EXPECT_EQUAL(rename.zero_idiom_eliminations_, 1);
+        EXPECT_EQUAL(rename.constant_eliminations_, 2);
+
+        // Every PRF is reclaimed once the instructions retired
+        EXPECT_EQUAL(rename.regfile_components_[0].freelist.size(), 96);
+    }
 };
 
 class olympia::IssueQueueTester
@@ -519,6 +566,28 @@ void runTest(int argc, char** argv)
         cls.runSimulator(&sim);
         rename_tester.test_clearing_rename_structures_amoadd(*my_rename);
     }
+    else if (input_file.find("idioms.json") != std::string::npos)
+    {
+        cls.populateSimulation(&sim);
+        cls.runSimulator(&sim);
+
+        sparta::RootTreeNode* root_node = sim.getRoot();
+        olympia::Rename* my_rename =
+            root_node->getChild("cpu.core0.rename")->getResourceAs<olympia::Rename*>();
+        olympia::RenameTester rename_tester;
+        rename_tester.test_idiom_elimination(*my_rename);
+    }
+    else if (input_file.find("rename_checkpoints.json") != std::string::npos)
+    {
+        cls.populateSimulation(&sim);
+        cls.runSimulator(&sim);
+
+        sparta::RootTreeNode* root_node = sim.getRoot();
+        olympia::Rename* my_rename =
+            root_node->getChild("cpu.core0.rename")->getResourceAs<olympia::Rename*>();
+        olympia::RenameTester rename_tester;
+        rename_tester.test_checkpoint_recovery(*my_rename);
+    }
     else if (input_file.find("rename_multiple_instructions_full.json") != std::string::npos)
     {
         sparta::RootTreeNode* root_node = sim.getRoot();
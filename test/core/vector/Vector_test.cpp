@@ -1,14 +1,21 @@
 #include "OlympiaSim.hpp"
 #include "decode/Decode.hpp"
+#include "decode/VsetPredictor.hpp"
+#include "execute/ExecutePipe.hpp"
+#include "lsu/VLSU.hpp"
 #include "ROB.hpp"
 #include "vector/VectorUopGenerator.hpp"
 
 #include "sparta/app/CommandLineSimulator.hpp"
 #include "sparta/kernel/Scheduler.hpp"
 #include "sparta/simulation/ClockManager.hpp"
+#include "sparta/statistics/CounterBase.hpp"
 #include "sparta/utils/SpartaSharedPointer.hpp"
 #include "sparta/utils/SpartaTester.hpp"
 
+#include <algorithm>
+#include <limits>
+
 TEST_INIT
 
 const char USAGE[] = "Usage:\n"
@@ -52,6 +59,13 @@ class olympia::DecodeTester
         EXPECT_TRUE(decode_->vector_config_->getVTA() == expected_vta);
     }
 
+    void test_expansion_stall_cycles(const uint64_t min_stall_cycles,
+                                     const uint64_t max_stall_cycles)
+    {
+        EXPECT_TRUE(decode_->vector_expansion_stall_cycles_ >= min_stall_cycles);
+        EXPECT_TRUE(decode_->vector_expansion_stall_cycles_ <= max_stall_cycles);
+    }
+
   private:
     olympia::Decode* decode_;
 };
@@ -85,10 +99,110 @@ class olympia::VectorUopGeneratorTester
         EXPECT_TRUE(vuop_->vuops_generated_ == expected_num_vuops_generated);
     }
 
+    // The uops are generated in at least min_crack_cycles cycles
+    void test_crack_cycles(const uint64_t min_crack_cycles)
+    {
+        EXPECT_TRUE(vuop_->vuop_crack_cycles_ >= min_crack_cycles);
+    }
+
+    uint32_t getNumUopsPerCycle() const { return vuop_->num_uops_per_cycle_; }
+
   private:
     VectorUopGenerator* vuop_;
 };
 
+class olympia::ExecutePipeTester
+{
+  public:
+    ExecutePipeTester(olympia::ExecutePipe* exe_pipe) : exe_pipe_{exe_pipe} {}
+
+    bool isChainingEnabled() const { return exe_pipe_->enable_vector_chaining_; }
+
+    // Chained consumers start before their producer completes, by at most
+    // max_overlap_cycles, none is held back
+    void test_chaining(const uint64_t expected_num_chained_uops,
+                       const uint64_t min_overlap_cycles, const uint64_t max_overlap_cycles)
+    {
+        EXPECT_EQUAL(exe_pipe_->vector_chained_uops_, expected_num_chained_uops);
+        EXPECT_EQUAL(exe_pipe_->vector_chain_holds_, 0);
+        EXPECT_TRUE(exe_pipe_->vector_chain_overlap_cycles_ >= min_overlap_cycles);
+        EXPECT_TRUE(exe_pipe_->vector_chain_overlap_cycles_ <= max_overlap_cycles);
+    }
+
+    // Consumers held in this pipe until their chained producers complete
+    void test_chain_holds(const uint64_t expected_num_chained_uops,
+                          const uint64_t expected_num_holds)
+    {
+        EXPECT_EQUAL(exe_pipe_->vector_chained_uops_, expected_num_chained_uops);
+        EXPECT_EQUAL(exe_pipe_->vector_chain_holds_, expected_num_holds);
+    }
+
+    void test_num_vector_passes(const uint64_t expected_num_vector_passes)
+    {
+        EXPECT_EQUAL(exe_pipe_->vector_passes_, expected_num_vector_passes);
+    }
+
+  private:
+    ExecutePipe* exe_pipe_;
+};
+
+class olympia::VsetPredictorTester
+{
+  public:
+    VsetPredictorTester(olympia::VsetPredictor* vset_pred) : vset_pred_{vset_pred} {}
+
+    void test_predictions(const uint64_t expected_misses, const uint64_t expected_correct,
+                          const uint64_t expected_mispredicts)
+    {
+        EXPECT_EQUAL(vset_pred_->vset_pred_misses_, expected_misses);
+        EXPECT_EQUAL(vset_pred_->vset_pred_correct_, expected_correct);
+        EXPECT_EQUAL(vset_pred_->vset_pred_mispredicts_, expected_mispredicts);
+
+        // Only the correct predictions save decode stall cycles
+        EXPECT_EQUAL(vset_pred_->vset_pred_stall_cycles_saved_.get() > 0, expected_correct > 0);
+    }
+
+  private:
+    VsetPredictor* vset_pred_;
+};
+
+class olympia::VLSUTester
+{
+  public:
+    VLSUTester(olympia::VLSU* vlsu) : vlsu_{vlsu} {}
+
+    void test_num_insts_completed(const uint64_t expected_num_insts)
+    {
+        EXPECT_EQUAL(vlsu_->vlsu_insts_completed_, expected_num_insts);
+    }
+
+    void test_access_types(const uint64_t expected_unit_stride, const uint64_t expected_strided,
+                           const uint64_t expected_indexed)
+    {
+        EXPECT_EQUAL(vlsu_->vlsu_unit_stride_insts_, expected_unit_stride);
+        EXPECT_EQUAL(vlsu_->vlsu_strided_insts_, expected_strided);
+        EXPECT_EQUAL(vlsu_->vlsu_indexed_insts_, expected_indexed);
+        EXPECT_EQUAL(vlsu_->vlsu_no_element_addrs_, 0);
+    }
+
+    void test_coalescing(const uint64_t expected_elements, const uint64_t expected_lines)
+    {
+        EXPECT_EQUAL(vlsu_->vlsu_elements_, expected_elements);
+        EXPECT_EQUAL(vlsu_->vlsu_line_accesses_, expected_lines);
+    }
+
+    void test_line_requests(const uint64_t expected_reqs, const uint64_t expected_misses,
+                            const uint64_t expected_retries)
+    {
+        EXPECT_EQUAL(vlsu_->vlsu_cache_reqs_, expected_reqs);
+        EXPECT_EQUAL(vlsu_->vlsu_line_misses_, expected_misses);
+        EXPECT_EQUAL(vlsu_->vlsu_line_retries_, expected_retries);
+    }
+
+  private:
+    VLSU* vlsu_;
+};
+
 void runTests(int argc, char** argv)
 {
     DEFAULTS.auto_summary_default = "off";
@@ -236,6 +350,165 @@ void runTests(int argc, char** argv)
         // vset + 1 vadd.vv + vset + 2 vadd.vv + vset + 4 vadd.vv uop + vset + 8 vadd.vv
         rob_tester.test_num_uops_retired(19);
     }
+    else if (input_file.find("vset_predict.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // The first vsetvl blocks decode and trains the predictor, the
+        // second is correctly predicted, the third (new VL) is mispredicted
+        // and flushes the instructions after it
+        auto* my_vset_pred = root_node->getChild("cpu.core0.decode.vset_predictor")
+                                 ->getResourceAs<olympia::VsetPredictor*>();
+        olympia::VsetPredictorTester vset_pred_tester{my_vset_pred};
+        vset_pred_tester.test_predictions(1, 1, 1);
+
+        // Test Decode, restarted with the configuration of the last vsetvl
+        decode_tester.test_waiting_on_vset(false);
+        decode_tester.test_vl(8);
+        decode_tester.test_sew(64);
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(6);
+        // 3 vsetvl + 3 vadd.vv uops
+        rob_tester.test_num_uops_retired(6);
+    }
+    else if (input_file.find("vector_chaining.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // Test Vector Uop Generation
+        vuop_tester.test_num_vuops_generated(expected_num_uops);
+
+        // Each uop takes 8 passes (128 e8 elements on a 128 bit DLEN).  The
+        // single vector pipe is busy until the last pass of the vaadd.vv
+        // (latency 6), its first element group is written long before, so
+        // the dependent vadd.vv enters the pipe as soon as it is free, up to
+        // latency - 1 = 5 cycles before the vaadd.vv completes, and completes
+        // as much earlier.  The second vadd.vv enters once the first one
+        // completes (latency 1).  Without chaining, no consumer overlaps.
+        auto* my_exe_pipe = root_node->getChild("cpu.core0.execute.exe10")
+                                ->getResourceAs<olympia::ExecutePipe*>();
+        olympia::ExecutePipeTester exe_pipe_tester{my_exe_pipe};
+        exe_pipe_tester.test_num_vector_passes(24);
+        if (exe_pipe_tester.isChainingEnabled())
+        {
+            exe_pipe_tester.test_chaining(3, 1, 5);
+        }
+        else
+        {
+            exe_pipe_tester.test_chaining(0, 0, 0);
+        }
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(4);
+    }
+    else if (input_file.find("vector_chaining_cross_pipe.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        vuop_tester.test_num_vuops_generated(expected_num_uops);
+
+        // The vdiv.vv (8 passes of 23 cycles) is chained by exe10 after its
+        // first element group.  The dependent vadd.vv issues to exe11, which
+        // does not chain, and takes a cycle per element group: it would
+        // outrun the vdiv.vv, exe11 holds it until the vdiv.vv completes
+        auto* my_div_pipe = root_node->getChild("cpu.core0.execute.exe10")
+                                ->getResourceAs<olympia::ExecutePipe*>();
+        auto* my_add_pipe = root_node->getChild("cpu.core0.execute.exe11")
+                                ->getResourceAs<olympia::ExecutePipe*>();
+        olympia::ExecutePipeTester div_pipe_tester{my_div_pipe};
+        olympia::ExecutePipeTester add_pipe_tester{my_add_pipe};
+        div_pipe_tester.test_chain_holds(1, 0);
+        add_pipe_tester.test_chain_holds(0, 1);
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(3);
+    }
+    else if (input_file.find("vlen_dlen.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // Test Decode, VLMAX of e32 m2 with a 256 bit VLEN
+        decode_tester.test_vlmax(16);
+        decode_tester.test_vl(16);
+
+        // Test Vector Uop Generation
+        vuop_tester.test_num_vuops_generated(expected_num_uops);
+
+        // Each uop holds 8 e32 elements, 2 passes on a 128 bit DLEN
+        auto* my_exe_pipe = root_node->getChild("cpu.core0.execute.exe10")
+                                ->getResourceAs<olympia::ExecutePipe*>();
+        olympia::ExecutePipeTester exe_pipe_tester{my_exe_pipe};
+        exe_pipe_tester.test_num_vector_passes(8);
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(3);
+    }
+    else if (input_file.find("vlsu_miss.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // Both lines of the vle8.v miss: one line request, one MSHR and
+        // one L2 request each, the lines complete on the refill
+        auto* my_vlsu = root_node->getChild("cpu.core0.vlsu")->getResourceAs<olympia::VLSU*>();
+        olympia::VLSUTester vlsu_tester{my_vlsu};
+        vlsu_tester.test_num_insts_completed(1);
+        vlsu_tester.test_coalescing(16, 2);
+        vlsu_tester.test_line_requests(2, 2, 0);
+
+        auto* dcache_stats = root_node->getChild("cpu.core0.dcache.stats");
+        EXPECT_EQUAL(dcache_stats->getChildAs<sparta::CounterBase>("dl1_cache_misses")->get(),
+                     2);
+        EXPECT_EQUAL(
+            dcache_stats->getChildAs<sparta::CounterBase>("dl1_mshr_allocations")->get(), 2);
+        EXPECT_EQUAL(dcache_stats->getChildAs<sparta::CounterBase>("dl1_l2cache_reqs")->get(),
+                     2);
+
+        rob_tester.test_num_insts_retired(2);
+    }
+    else if (input_file.find("vlsu.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // Test Vector Uop Generation
+        vuop_tester.test_num_vuops_generated(expected_num_uops);
+
+        // vle8.v crosses a line, vse8.v fits in one, the 16 elements of
+        // vluxei8.v hit 8 lines and the vlse8.v stride is 4 bytes (1 line)
+        auto* my_vlsu = root_node->getChild("cpu.core0.vlsu")->getResourceAs<olympia::VLSU*>();
+        olympia::VLSUTester vlsu_tester{my_vlsu};
+        vlsu_tester.test_num_insts_completed(4);
+        vlsu_tester.test_access_types(2, 1, 1);
+        vlsu_tester.test_coalescing(64, 12);
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(5);
+        // vsetivli + 4 load/store uops
+        rob_tester.test_num_uops_retired(5);
+    }
+    else if (input_file.find("int_ext.json") != std::string::npos)
+    {
+        cls.runSimulator(&sim);
+
+        // Test Vector Uop Generation
+        vuop_tester.test_num_vuops_generated(expected_num_uops);
+
+        // At most num_to_decode (3) uops are decoded per cycle.  With a
+        // smaller expansion bandwidth, decode stops short of its width
+        const uint32_t uops_per_cycle = std::min(vuop_tester.getNumUopsPerCycle(), 3u);
+        vuop_tester.test_crack_cycles(expected_num_uops / uops_per_cycle);
+        if (uops_per_cycle < 3)
+        {
+            decode_tester.test_expansion_stall_cycles(1, std::numeric_limits<uint64_t>::max());
+        }
+        else
+        {
+            decode_tester.test_expansion_stall_cycles(0, 0);
+        }
+
+        // Test Retire
+        rob_tester.test_num_insts_retired(4);
+    }
     else if (input_file.find("vrgather.json") != std::string::npos)
     {
         // Unsupported vector instructions are expected to make the simulator to throw
@@ -0,0 +1,94 @@
+#include "decode/FusionMatcher.hpp"
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <map>
+#include <string>
+
+TEST_INIT
+
+namespace
+{
+    // Stand in for the fusion groups of Fusion::getFusionGroupContainer
+    struct TestFusionGroup
+    {
+        std::string group_name;
+        olympia::FusionMatcher::InstUidListType group_uids;
+
+        const std::string & name() const { return group_name; }
+
+        const olympia::FusionMatcher::InstUidListType & uids() const { return group_uids; }
+    };
+
+    void expectMatch(const fusion::FusionGroupMatchInfo & match, const std::string & name,
+                     const size_t start_idx)
+    {
+        EXPECT_EQUAL(match.name, name);
+        EXPECT_EQUAL(match.startIdx, start_idx);
+    }
+} // namespace
+
+void runTest()
+{
+    const std::map<std::string, TestFusionGroup> groups{
+        {"ab", {"ab", {1, 2}}},
+        {"abc", {"abc", {1, 2, 3}}},
+        {"bcde", {"bcde", {2, 3, 4, 5}}},
+        {"cd", {"cd", {3, 4}}},
+        {"single", {"single", {7}}}};
+
+    olympia::FusionMatcher matcher;
+    matcher.build(groups);
+
+    // Single UID groups do not fuse anything
+    EXPECT_EQUAL(matcher.getNumGroups(), 4);
+
+    olympia::FusionMatcher::MatchInfoListType matches;
+
+    // Longest match at a position: abc over ab
+    matcher.match({1, 2, 3, 9}, matches);
+    EXPECT_EQUAL(matches.size(), 1);
+    expectMatch(matches[0], "abc", 0);
+
+    // Leftmost wins over a longer overlapping match starting later:
+    // abc at 0, not bcde at 1.  The walk resumes after abc, cd does not
+    // overlap it
+    matcher.match({1, 2, 3, 4, 5}, matches);
+    EXPECT_EQUAL(matches.size(), 1);
+    expectMatch(matches[0], "abc", 0);
+
+    matcher.match({1, 2, 3, 3, 4}, matches);
+    EXPECT_EQUAL(matches.size(), 2);
+    expectMatch(matches[0], "abc", 0);
+    expectMatch(matches[1], "cd", 3);
+
+    // Without an earlier match, the longer group is found
+    matcher.match({9, 2, 3, 4, 5}, matches);
+    EXPECT_EQUAL(matches.size(), 1);
+    expectMatch(matches[0], "bcde", 1);
+
+    // A group longer than the rest of the input falls back to a shorter one
+    matcher.match({9, 1, 2}, matches);
+    EXPECT_EQUAL(matches.size(), 1);
+    expectMatch(matches[0], "ab", 1);
+
+    // Non-overlapping repeats, in program order
+    matcher.match({3, 4, 3, 4, 1, 2}, matches);
+    EXPECT_EQUAL(matches.size(), 3);
+    expectMatch(matches[0], "cd", 0);
+    expectMatch(matches[1], "cd", 2);
+    expectMatch(matches[2], "ab", 4);
+
+    // No match, previous matches are cleared
+    matcher.match({7, 7}, matches);
+    EXPECT_TRUE(matches.empty());
+    matcher.match({}, matches);
+    EXPECT_TRUE(matches.empty());
+}
+
+int main()
+{
+    runTest();
+
+    REPORT_ERROR;
+    return (int)ERROR_CODE;
+}